@@ -35,11 +35,14 @@
 #include "jep_platform.h"
 #include "jep_util.h"
 #include "jep_exceptions.h"
+#include "jep_metadata.h"
+#include "jep_converters.h"
 #include "jep_numpy.h"
 
 #include "pyembed.h"
 #include "pyjarray.h"
 #include "pyjclass.h"
+#include "pyjclassinfo.h"
 #include "pyjcollection.h"
 #include "pyjfield.h"
 #include "pyjiterable.h"
@@ -75,4 +78,6 @@
 #include "java_access/Number.h"
 #include "java_access/Object.h"
 #include "java_access/String.h"
+#include "java_access/System.h"
 #include "java_access/Throwable.h"
+#include "java_access/Util.h"
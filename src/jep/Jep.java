@@ -26,8 +26,12 @@ package jep;
 
 import java.io.Closeable;
 import java.io.File;
+import java.lang.ref.ReferenceQueue;
+import java.lang.ref.WeakReference;
 import java.util.ArrayList;
+import java.util.IdentityHashMap;
 import java.util.List;
+import java.util.Map;
 import java.util.concurrent.BlockingQueue;
 import java.util.concurrent.SynchronousQueue;
 
@@ -88,6 +92,28 @@ public final class Jep implements Closeable {
      */
     private final List<PyObject> pythonObjects = new ArrayList<>();
 
+    /*
+     * The Python objects of collection views, which are released when the view
+     * is closed or garbage collected instead of living until jep is closed.
+     * Collected views are found in viewQueue by releaseViews().
+     */
+    private final Map<PyObject, ViewReference> views = new IdentityHashMap<>();
+
+    private final ReferenceQueue<Object> viewQueue = new ReferenceQueue<>();
+
+    private boolean releasingViews = false;
+
+    private static final class ViewReference extends WeakReference<Object> {
+
+        private final PyObject pyObject;
+
+        private ViewReference(Object view, PyObject pyObject,
+                ReferenceQueue<Object> queue) {
+            super(view, queue);
+            this.pyObject = pyObject;
+        }
+    }
+
     /**
      * Tracks if this thread has been used for an interpreter before. Using
      * different interpreter instances on the same thread is iffy at best. If
@@ -406,7 +432,14 @@ public final class Jep implements Closeable {
                 && !config.sharedModules.isEmpty();
 
         this.interactive = config.interactive;
-        this.tstate = init(this.classLoader, hasSharedModules);
+        this.tstate = init(this.classLoader, hasSharedModules,
+                config.objectFreeListSize, config.lazyMembers,
+                config.metadataCacheFile, config.identityCache,
+                config.stringInternCacheSize, config.classTypes,
+                config.adaptiveGIL,
+                config.keepGILMethods == null ? null
+                        : config.keepGILMethods.toArray(new String[0]),
+                config.collectionViews);
         threadUsed.set(true);
         this.thread = Thread.currentThread();
 
@@ -449,8 +482,12 @@ public final class Jep implements Closeable {
         }
     }
 
-    private native long init(ClassLoader classloader, boolean hasSharedModules)
-            throws JepException;
+    private native long init(ClassLoader classloader, boolean hasSharedModules,
+            int objectFreeListSize, boolean lazyMembers,
+            String metadataCacheFile, boolean identityCache,
+            int stringInternCacheSize, boolean classTypes,
+            boolean adaptiveGIL, String[] keepGILMethods,
+            boolean collectionViews) throws JepException;
 
     /**
      * Checks if the current thread is valid for the method call. All calls must
@@ -468,6 +505,29 @@ public final class Jep implements Closeable {
             throw new JepException("Jep instance has been closed.");
         if (this.tstate == 0)
             throw new JepException("Initialization failed.");
+        releaseViews();
+    }
+
+    /*
+     * Releases the Python objects of views that were garbage collected. The
+     * objects are released on the thread of this jep without the GIL, so this
+     * is done when that thread uses jep.
+     */
+    private void releaseViews() {
+        if (releasingViews) {
+            return;
+        }
+        releasingViews = true;
+        try {
+            ViewReference ref;
+            while ((ref = (ViewReference) viewQueue.poll()) != null) {
+                if (views.remove(ref.pyObject) != null) {
+                    ref.pyObject.close();
+                }
+            }
+        } finally {
+            releasingViews = false;
+        }
     }
 
     /**
@@ -735,6 +795,41 @@ public final class Jep implements Closeable {
         return obj;
     }
 
+    /**
+     * Track the Python object of a view of a Python collection. Unlike
+     * {@link #trackObject(PyObject, boolean)} the Python object is released
+     * once the view is garbage collected. The reference to the Python object
+     * must already be owned by the PyObject. Called on the thread of this jep.
+     * 
+     * <b>Internal use only.</b>
+     * 
+     * @param view
+     *            the view that uses the Python object
+     * @param obj
+     *            the Python object of the view
+     * @return the same Python object, for inlining stuff
+     */
+    public PyObject trackView(Object view, PyObject obj) {
+        views.put(obj, new ViewReference(view, obj, viewQueue));
+        return obj;
+    }
+
+    /**
+     * Stop tracking the Python object of a view that is closed. Called on the
+     * thread of this jep.
+     * 
+     * <b>Internal use only.</b>
+     * 
+     * @param obj
+     *            the Python object of the view
+     */
+    public void untrackView(PyObject obj) {
+        ViewReference ref = views.remove(obj);
+        if (ref != null) {
+            ref.clear();
+        }
+    }
+
     /**
      * Create a Python module on the interpreter. If the given name is valid,
      * imported module, this method will return that module.
@@ -1203,6 +1298,12 @@ public final class Jep implements Closeable {
         for (int i = 0; i < this.pythonObjects.size(); i++) {
             pythonObjects.get(i).close();
         }
+        releasingViews = true;
+        for (ViewReference ref : views.values()) {
+            ref.clear();
+            ref.pyObject.close();
+        }
+        views.clear();
 
         // don't attempt close twice if something goes wrong
         this.closed = true;
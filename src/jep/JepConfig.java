@@ -54,6 +54,24 @@ public class JepConfig {
 
     protected Set<String> sharedModules = null;
 
+    protected int objectFreeListSize = 256;
+
+    protected boolean lazyMembers = false;
+
+    protected String metadataCacheFile = null;
+
+    protected boolean identityCache = false;
+
+    protected int stringInternCacheSize = 0;
+
+    protected boolean classTypes = false;
+
+    protected boolean adaptiveGIL = false;
+
+    protected Set<String> keepGILMethods = null;
+
+    protected boolean collectionViews = false;
+
     /**
      * Sets whether <code>Jep.eval(String)</code> should support the slower
      * behavior of potentially waiting for multiple statements
@@ -181,4 +199,207 @@ public class JepConfig {
         }
         return this;
     }
+
+    /**
+     * Sets the maximum number of freed Python wrappers of Java objects that
+     * the sub-interpreter keeps for reuse. Code that wraps many short lived
+     * Java objects, such as iterating over a large Java collection, can then
+     * reuse the memory of previous wrappers instead of allocating new ones.
+     * The default is 256, 0 disables reuse.
+     * 
+     * @param objectFreeListSize
+     *            the maximum number of wrappers to keep for reuse
+     * @return a reference to this JepConfig
+     * 
+     * @since 3.8
+     */
+    public JepConfig setObjectFreeListSize(int objectFreeListSize) {
+        this.objectFreeListSize = objectFreeListSize;
+        return this;
+    }
+
+    /**
+     * Sets whether the methods and fields of Java classes are resolved one
+     * name at a time when they are first accessed from Python. By default
+     * all the public members of a class are found through reflection the
+     * first time an object of the class is used, which can be slow for
+     * classes with hundreds of methods when only a few of them are used.
+     * With lazy members dir() and __dict__ still show every member, the full
+     * reflection is done when they are first requested.
+     * 
+     * @param lazyMembers
+     *            true to resolve members on first access
+     * @return a reference to this JepConfig
+     * 
+     * @since 3.8
+     */
+    public JepConfig setLazyMembers(boolean lazyMembers) {
+        this.lazyMembers = lazyMembers;
+        return this;
+    }
+
+    /**
+     * Sets a file for caching the methods and fields of Java classes between
+     * runs of the JVM. The file is read by the first Jep that is configured
+     * with a cache file and is rewritten with every class used so far when
+     * the Jep is closed. Classes in the file are resolved directly from their
+     * recorded signatures instead of through reflection, as long as they are
+     * loaded from the same jar or directory as when the file was written.
+     * 
+     * @param metadataCacheFile
+     *            the path of the cache file, it is created if it does not
+     *            exist
+     * @return a reference to this JepConfig
+     * 
+     * @since 3.8
+     */
+    public JepConfig setMetadataCacheFile(String metadataCacheFile) {
+        this.metadataCacheFile = metadataCacheFile;
+        return this;
+    }
+
+    /**
+     * Sets whether a Java object that is passed to Python while it already
+     * has a live Python wrapper reuses that wrapper. By default every time a
+     * Java object crosses into Python a new wrapper and JNI global reference
+     * are created, so passing the same object repeatedly, for example to a
+     * callback, is slower and the wrappers are not identical with
+     * <code>is</code>. The wrappers are not kept alive by the cache, once
+     * Python no longer references a wrapper the next crossing creates a new
+     * one. The statistics of the cache are available from Python with
+     * <code>jep.identityCacheStats()</code>.
+     * 
+     * @param identityCache
+     *            true to reuse the live wrappers of Java objects
+     * @return a reference to this JepConfig
+     * 
+     * @since 3.8
+     */
+    public JepConfig setIdentityCache(boolean identityCache) {
+        this.identityCache = identityCache;
+        return this;
+    }
+
+    /**
+     * Sets the number of short Java strings that are remembered as interned
+     * Python strings. Strings such as map keys, enum names or column names
+     * are often converted to Python many times, with the cache each
+     * conversion after the first reuses the same interned Python string
+     * instead of allocating a new one, and dict lookups with it compare by
+     * pointer. Only strings of at most 32 characters are cached and the size
+     * is rounded up to a power of two. The default is 0, which disables the
+     * cache. The statistics of the cache are available from Python with
+     * <code>jep.internCacheStats()</code>. The cache is only used with
+     * Python 3.
+     * 
+     * @param stringInternCacheSize
+     *            the number of strings to remember
+     * @return a reference to this JepConfig
+     * 
+     * @since 3.8
+     */
+    public JepConfig setStringInternCacheSize(int stringInternCacheSize) {
+        this.stringInternCacheSize = stringInternCacheSize;
+        return this;
+    }
+
+    /**
+     * Sets whether each Java class gets its own Python type. By default every
+     * Java object is a <code>PyJObject</code> or one of a few subtypes and its
+     * members are found in a dict that is shared by the objects of the same
+     * class. With class types enabled the objects of a class are instances of
+     * a Python type with the simple name of the class, whose dict holds the
+     * methods and fields of the class, and whose bases follow the Java
+     * superclass chain. Attribute lookups then use the attribute cache of
+     * Python types and <code>isinstance()</code> works with the types of Java
+     * objects. Class types always hold every member of their class, so
+     * members are not resolved lazily for the classes of Java objects. The
+     * default is false.
+     * 
+     * @param classTypes
+     *            true to make a Python type for each Java class
+     * @return a reference to this JepConfig
+     * 
+     * @since 3.8
+     */
+    public JepConfig setClassTypes(boolean classTypes) {
+        this.classTypes = classTypes;
+        return this;
+    }
+
+    /**
+     * Sets whether calls from Python to Java methods decide for themselves
+     * whether to release the GIL. By default the GIL is released for every
+     * call so other Python threads can run while Java works, which costs
+     * much more than the call itself for trivial methods like getters. With
+     * the adaptive policy the first calls of each method are timed and a
+     * method that is always very fast keeps the GIL, but is still timed every
+     * so often and releases the GIL again once a call is slow. Only instance
+     * methods of final classes that take no objects or arrays other than
+     * strings are timed, since proxies, callbacks and overriding methods could
+     * call back into Python. Static methods always release the GIL unless
+     * they are added with {@link #addKeepGILMethods(String...)}. A method that
+     * keeps the GIL must not call back into Python or wait for another thread
+     * that uses Python some other way, so only enable this when the Java
+     * methods used from Python do not do that. The default is false.
+     * 
+     * @param adaptiveGIL
+     *            true to let fast methods keep the GIL
+     * @return a reference to this JepConfig
+     * 
+     * @since 3.8
+     */
+    public JepConfig setAdaptiveGIL(boolean adaptiveGIL) {
+        this.adaptiveGIL = adaptiveGIL;
+        return this;
+    }
+
+    /**
+     * Adds Java methods that keep the GIL when they are called from Python,
+     * regardless of the adaptive policy. Methods are named by the fully
+     * qualified name of the class that declares them and the method name, for
+     * example <code>java.util.ArrayList.size</code>, and the name applies to
+     * every overload. The methods must not call back into Python or wait for
+     * another thread that uses Python, see
+     * {@link #setAdaptiveGIL(boolean)}.
+     * 
+     * @param methods
+     *            the names of the methods that keep the GIL
+     * @return a reference to this JepConfig
+     * 
+     * @since 3.8
+     */
+    public JepConfig addKeepGILMethods(String... methods) {
+        if (keepGILMethods == null) {
+            keepGILMethods = new HashSet<>();
+        }
+        for (String method : methods) {
+            keepGILMethods.add(method);
+        }
+        return this;
+    }
+
+    /**
+     * Sets whether Python lists, tuples and dicts are given to Java as views
+     * instead of copies. Normally a container is converted to an ArrayList or
+     * HashMap, which converts every item even if Java only reads a few of
+     * them. With views enabled, a container that is converted for
+     * <code>getValue(String)</code> or for a parameter of a type such as
+     * <code>java.util.List</code>, <code>java.util.Map</code> or
+     * <code>Object</code> becomes a {@link jep.python.PyListView} or
+     * {@link jep.python.PyMapView} that reads the live Python object when it
+     * is accessed. Parameters declared as one of the view classes always get
+     * a view. Views can only be used on the thread of the Jep instance and
+     * only until it is closed. The default is false.
+     * 
+     * @param collectionViews
+     *            true to convert Python containers to views
+     * @return a reference to this JepConfig
+     * 
+     * @since 3.8
+     */
+    public JepConfig setCollectionViews(boolean collectionViews) {
+        this.collectionViews = collectionViews;
+        return this;
+    }
 }
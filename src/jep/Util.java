@@ -24,6 +24,20 @@
  */
 package jep;
 
+import java.io.File;
+import java.lang.reflect.Field;
+import java.lang.reflect.Method;
+import java.net.URISyntaxException;
+import java.net.URL;
+import java.security.CodeSource;
+import java.util.ArrayList;
+import java.util.Collection;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+
 /**
  * Utility functions
  * 
@@ -202,4 +216,427 @@ public final class Util {
 
         return JOBJECT_ID;
     }
+
+    /**
+     * <pre>
+     * 
+     * <b>Internal use only</b>
+     * 
+     * Finds the public methods of a class with a given name, including the
+     * methods inherited from superclasses and interfaces. This is used to
+     * resolve the methods of a PyJObject one name at a time instead of
+     * reflecting on every method of the class.
+     * 
+     * </pre>
+     * 
+     * @param clazz
+     *            the class to search
+     * @param name
+     *            the name of the methods
+     * @return the matching methods, an empty array if there are none
+     * @since 3.8
+     */
+    public static final Method[] getMethods(Class<?> clazz, String name) {
+        List<Method> result = new ArrayList<>();
+        for (Method method : clazz.getMethods()) {
+            if (method.getName().equals(name)) {
+                result.add(method);
+            }
+        }
+        return result.toArray(new Method[result.size()]);
+    }
+
+    /**
+     * <pre>
+     * 
+     * <b>Internal use only</b>
+     * 
+     * Same as <code>Class.getField(String)</code> but returns null instead of
+     * throwing an exception when there is no public field with the name.
+     * 
+     * </pre>
+     * 
+     * @param clazz
+     *            the class to search
+     * @param name
+     *            the name of the field
+     * @return the field or null
+     * @since 3.8
+     */
+    public static final Field getField(Class<?> clazz, String name) {
+        try {
+            return clazz.getField(name);
+        } catch (NoSuchFieldException e) {
+            return null;
+        }
+    }
+
+    /**
+     * <pre>
+     * 
+     * <b>Internal use only</b>
+     * 
+     * Same as <code>Class.forName(String, boolean, ClassLoader)</code> using
+     * the ClassLoader of another class and without initializing the class.
+     * 
+     * </pre>
+     * 
+     * @param context
+     *            the class whose ClassLoader is used
+     * @param name
+     *            the binary name of the class to find
+     * @return the class
+     * @throws ClassNotFoundException
+     *             if the class cannot be found
+     * @since 3.8
+     */
+    public static final Class<?> forName(Class<?> context, String name)
+            throws ClassNotFoundException {
+        return Class.forName(name, false, context.getClassLoader());
+    }
+
+    /**
+     * <pre>
+     * 
+     * <b>Internal use only</b>
+     * 
+     * Builds a string identifying where a class was loaded from. The
+     * metadata cache file only reuses the members recorded for a class if
+     * the fingerprint has not changed, so it includes the ClassLoader type
+     * and the location, size and modification time of the class's jar or
+     * directory. Classes of the bootstrap ClassLoader are identified by the
+     * version of Java.
+     * 
+     * </pre>
+     * 
+     * @param clazz
+     *            the class
+     * @return the fingerprint of the class
+     * @since 3.8
+     */
+    public static final String getFingerprint(Class<?> clazz) {
+        ClassLoader loader = clazz.getClassLoader();
+        if (loader == null) {
+            return "bootstrap " + System.getProperty("java.vm.name") + " "
+                    + System.getProperty("java.runtime.version");
+        }
+        StringBuilder fingerprint = new StringBuilder(
+                loader.getClass().getName());
+        CodeSource source = clazz.getProtectionDomain().getCodeSource();
+        URL location = source == null ? null : source.getLocation();
+        if (location != null) {
+            fingerprint.append(' ').append(location);
+            if ("file".equals(location.getProtocol())) {
+                try {
+                    File file = new File(location.toURI());
+                    fingerprint.append(' ').append(file.length()).append(' ')
+                            .append(file.lastModified());
+                } catch (URISyntaxException | IllegalArgumentException e) {
+                    /* the location alone will have to do */
+                }
+            }
+        }
+        return fingerprint.toString();
+    }
+
+    /**
+     * <pre>
+     * 
+     * <b>Internal use only</b>
+     * 
+     * Boxes every value of an array into a new ArrayList, used to convert
+     * Python sequences of ints with a single call into Java.
+     * 
+     * </pre>
+     * 
+     * @param values
+     *            the values to box
+     * @return a modifiable list of the boxed values
+     * @since 3.8
+     */
+    public static final List<Object> boxLongs(long[] values) {
+        List<Object> result = new ArrayList<>(values.length);
+        for (long value : values) {
+            result.add(Long.valueOf(value));
+        }
+        return result;
+    }
+
+    /**
+     * <pre>
+     * 
+     * <b>Internal use only</b>
+     * 
+     * Boxes every value of an array into a new ArrayList, used to convert
+     * Python sequences of floats with a single call into Java.
+     * 
+     * </pre>
+     * 
+     * @param values
+     *            the values to box
+     * @return a modifiable list of the boxed values
+     * @since 3.8
+     */
+    public static final List<Object> boxDoubles(double[] values) {
+        List<Object> result = new ArrayList<>(values.length);
+        for (double value : values) {
+            result.add(Double.valueOf(value));
+        }
+        return result;
+    }
+
+    /* The opcodes of buildCollection, these must match convert_p2j.c */
+    private static final byte BULK_NULL = 0;
+
+    private static final byte BULK_TRUE = 1;
+
+    private static final byte BULK_FALSE = 2;
+
+    private static final byte BULK_LONG = 3;
+
+    private static final byte BULK_DOUBLE = 4;
+
+    private static final byte BULK_STRING = 5;
+
+    private static final byte BULK_OBJECT = 6;
+
+    private static final byte BULK_LIST = 7;
+
+    private static final byte BULK_TUPLE = 8;
+
+    private static final byte BULK_DICT = 9;
+
+    /**
+     * <pre>
+     * 
+     * <b>Internal use only</b>
+     * 
+     * Builds the Java collections for a nested Python list, tuple or dict
+     * that was flattened into arrays during a single walk of the Python
+     * objects. Every value is an opcode, a container is followed by its
+     * values and the opcodes consume the other arrays in order. Lists become
+     * an ArrayList, tuples an unmodifiable List and dicts a HashMap.
+     * 
+     * </pre>
+     * 
+     * @param ops
+     *            the opcode of every value
+     * @param ints
+     *            the sizes of containers and the lengths of strings
+     * @param longs
+     *            the values of ints
+     * @param doubles
+     *            the values of floats
+     * @param chars
+     *            the characters of all strings
+     * @param objects
+     *            values that were converted individually
+     * @return the outermost collection
+     * @since 3.8
+     */
+    public static final Object buildCollection(byte[] ops, int[] ints,
+            long[] longs, double[] doubles, char[] chars, Object[] objects) {
+        return new CollectionBuilder(ops, ints, longs, doubles, chars,
+                objects).build();
+    }
+
+    private static final class CollectionBuilder {
+
+        private final byte[] ops;
+
+        private final int[] ints;
+
+        private final long[] longs;
+
+        private final double[] doubles;
+
+        private final char[] chars;
+
+        private final Object[] objects;
+
+        private int op, i, l, d, c, o;
+
+        private CollectionBuilder(byte[] ops, int[] ints, long[] longs,
+                double[] doubles, char[] chars, Object[] objects) {
+            this.ops = ops;
+            this.ints = ints;
+            this.longs = longs;
+            this.doubles = doubles;
+            this.chars = chars;
+            this.objects = objects;
+        }
+
+        private Object build() {
+            switch (ops[op++]) {
+            case BULK_NULL:
+                return null;
+            case BULK_TRUE:
+                return Boolean.TRUE;
+            case BULK_FALSE:
+                return Boolean.FALSE;
+            case BULK_LONG:
+                return Long.valueOf(longs[l++]);
+            case BULK_DOUBLE:
+                return Double.valueOf(doubles[d++]);
+            case BULK_STRING: {
+                int length = ints[i++];
+                String result = new String(chars, c, length);
+                c += length;
+                return result;
+            }
+            case BULK_OBJECT:
+                return objects[o++];
+            case BULK_LIST:
+                return buildList();
+            case BULK_TUPLE:
+                return Collections.unmodifiableList(buildList());
+            case BULK_DICT: {
+                int size = ints[i++];
+                /* Account for default load factor */
+                Map<Object, Object> result = new HashMap<>(
+                        (int) (size / 0.75) + 1);
+                for (int j = 0; j < size; j += 1) {
+                    Object key = build();
+                    result.put(key, build());
+                }
+                return result;
+            }
+            default:
+                throw new IllegalStateException(
+                        "Unknown opcode " + ops[op - 1]);
+            }
+        }
+
+        private List<Object> buildList() {
+            int size = ints[i++];
+            List<Object> result = new ArrayList<>(size);
+            for (int j = 0; j < size; j += 1) {
+                result.add(build());
+            }
+            return result;
+        }
+    }
+
+    /* The kinds used by snapshot, these must match jep_util.c */
+    private static final byte SNAPSHOT_LIST = 0;
+
+    private static final byte SNAPSHOT_SET = 1;
+
+    private static final byte SNAPSHOT_MAP = 2;
+
+    private static final byte SNAPSHOT_NULL = 0;
+
+    private static final byte SNAPSHOT_TRUE = 1;
+
+    private static final byte SNAPSHOT_FALSE = 2;
+
+    private static final byte SNAPSHOT_LONG = 3;
+
+    private static final byte SNAPSHOT_DOUBLE = 4;
+
+    private static final byte SNAPSHOT_OBJECT = 5;
+
+    private static final byte SNAPSHOT_STRING = 6;
+
+    /**
+     * <pre>
+     * 
+     * <b>Internal use only</b>
+     * 
+     * Copies the values of a Collection, or the alternating keys and values
+     * of a Map, into arrays so Python can convert all of them with a few JNI
+     * calls. The first byte of the kinds is whether the container is a Set,
+     * a Map or any other Collection, the rest says for every value whether it
+     * is null, a boolean, a whole number unboxed into the longs, a floating
+     * point number unboxed into the doubles, a String copied into the chars
+     * with its length in the lengths or any other object.
+     * 
+     * </pre>
+     * 
+     * @param container
+     *            a Collection or Map
+     * @return the kinds, longs, doubles, objects, chars and lengths arrays
+     * @since 3.8
+     */
+    public static final Object[] snapshot(Object container) {
+        byte type;
+        Object[] values;
+        if (container instanceof Map) {
+            Map<?, ?> map = (Map<?, ?>) container;
+            List<Object> flat = new ArrayList<>(map.size() * 2);
+            for (Map.Entry<?, ?> entry : map.entrySet()) {
+                flat.add(entry.getKey());
+                flat.add(entry.getValue());
+            }
+            values = flat.toArray();
+            type = SNAPSHOT_MAP;
+        } else {
+            values = ((Collection<?>) container).toArray();
+            type = container instanceof Set ? SNAPSHOT_SET : SNAPSHOT_LIST;
+        }
+
+        byte[] kinds = new byte[values.length + 1];
+        int longCount = 0;
+        int doubleCount = 0;
+        int objectCount = 0;
+        int stringCount = 0;
+        int charCount = 0;
+        kinds[0] = type;
+        for (int i = 0; i < values.length; i += 1) {
+            Object value = values[i];
+            byte kind;
+            if (value == null) {
+                kind = SNAPSHOT_NULL;
+            } else if (value instanceof Boolean) {
+                kind = ((Boolean) value).booleanValue() ? SNAPSHOT_TRUE
+                        : SNAPSHOT_FALSE;
+            } else if (value instanceof Integer || value instanceof Long
+                    || value instanceof Short || value instanceof Byte) {
+                kind = SNAPSHOT_LONG;
+                longCount += 1;
+            } else if (value instanceof Double || value instanceof Float) {
+                kind = SNAPSHOT_DOUBLE;
+                doubleCount += 1;
+            } else if (value instanceof String) {
+                kind = SNAPSHOT_STRING;
+                stringCount += 1;
+                charCount += ((String) value).length();
+            } else {
+                kind = SNAPSHOT_OBJECT;
+                objectCount += 1;
+            }
+            kinds[i + 1] = kind;
+        }
+
+        long[] longs = new long[longCount];
+        double[] doubles = new double[doubleCount];
+        Object[] objects = new Object[objectCount];
+        char[] chars = new char[charCount];
+        int[] lengths = new int[stringCount];
+        longCount = doubleCount = objectCount = stringCount = charCount = 0;
+        for (int i = 0; i < values.length; i += 1) {
+            switch (kinds[i + 1]) {
+            case SNAPSHOT_LONG:
+                longs[longCount++] = ((Number) values[i]).longValue();
+                break;
+            case SNAPSHOT_DOUBLE:
+                doubles[doubleCount++] = ((Number) values[i]).doubleValue();
+                break;
+            case SNAPSHOT_OBJECT:
+                objects[objectCount++] = values[i];
+                break;
+            case SNAPSHOT_STRING: {
+                String value = (String) values[i];
+                int length = value.length();
+                value.getChars(0, length, chars, charCount);
+                lengths[stringCount++] = length;
+                charCount += length;
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        return new Object[] { kinds, longs, doubles, objects, chars, lengths };
+    }
 }
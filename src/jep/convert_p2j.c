@@ -40,9 +40,6 @@
 
 #define JCHAR_MAX   0xFFFF
 
-static jmethodID hashmapIConstructor   = 0;
-static jmethodID arraylistIConstructor = 0;
-
 #if PY_MAJOR_VERSION < 3
     static jmethodID stringDecodingConstructor = NULL;
     static jstring UTF8 = NULL;
@@ -65,6 +62,7 @@ char isFunctionalInterfaceType(JNIEnv *env, jclass type)
         return 0;
     }
     if (!isInterface) {
+        (*env)->PopLocalFrame(env, NULL);
         return 0; // It's not an interface, so it can't be functional
     }
     methods = java_lang_Class_getMethods(env, type);
@@ -122,7 +120,8 @@ static void raiseTypeError(JNIEnv *env, PyObject *pyobject, jclass expectedType)
     if (PyJClass_Check(pyobject)) {
         actTypeName = "java.lang.Class";
     } else if (PyJObject_Check(pyobject)) {
-        actTypeName = PyString_AsString(((PyJObject*) pyobject)->javaClassName);
+        actTypeName = PyString_AsString(((PyJObject*)
+                                          pyobject)->classInfo->javaName);
     } else {
         actTypeName = pyobject->ob_type->tp_name;
     }
@@ -276,6 +275,35 @@ static jstring pyunicode_as_jstring(JNIEnv *env, PyObject *pyunicode)
         Py_UCS2* data = PyUnicode_2BYTE_DATA(pyunicode);
         Py_ssize_t length = PyUnicode_GET_LENGTH(pyunicode);
         return (*env)->NewString(env, (jchar*) data, length);
+    } else if (PyUnicode_KIND((pyunicode)) == PyUnicode_1BYTE_KIND) {
+        Py_UCS1   *data   = PyUnicode_1BYTE_DATA(pyunicode);
+        Py_ssize_t length = PyUnicode_GET_LENGTH(pyunicode);
+        jchar      stack[JEP_STRING_STACK_SIZE];
+        jchar     *chars  = stack;
+        Py_ssize_t i;
+
+        /*
+         * ASCII is valid modified UTF-8 unless it contains a null character,
+         * and the data of a compact string is null terminated.
+         */
+        if (PyUnicode_IS_ASCII(pyunicode) && !memchr(data, 0, length)) {
+            return (*env)->NewStringUTF(env, (const char*) data);
+        }
+        /* Latin-1 only needs to be widened */
+        if (length > JEP_STRING_STACK_SIZE) {
+            chars = pyembed_scratch_alloc(sizeof(jchar) * length);
+            if (!chars) {
+                return NULL;
+            }
+        }
+        for (i = 0; i < length; i++) {
+            chars[i] = data[i];
+        }
+        result = (*env)->NewString(env, chars, (jsize) length);
+        if (chars != stack) {
+            pyembed_scratch_free(chars);
+        }
+        return result;
     }
 #endif
     bytes = PyUnicode_AsUTF16String(pyunicode);
@@ -504,117 +532,689 @@ static jobject pyfloat_as_jobject(JNIEnv *env, PyObject *pyobject,
     return NULL;
 }
 
-/* Convert a list or tuple to an ArrayList */
-static jobject pyfastsequence_as_jobject(JNIEnv *env, PyObject *pyseq,
-        jclass expectedType)
+/*
+ * Convert a list or tuple that only holds ints or only holds floats to an
+ * ArrayList with a single call into java. Returns NULL without an exception if
+ * the sequence holds anything else.
+ */
+static jobject pyfastsequence_as_boxed_list(JNIEnv *env, PyObject *pyseq,
+        Py_ssize_t size)
 {
-    if ((*env)->IsAssignableFrom(env, JLIST_TYPE, expectedType)
-            || (PyList_Check(pyseq)
-                && (*env)->IsAssignableFrom(env, JARRAYLIST_TYPE, expectedType))) {
-        jobject jlist;
-        Py_ssize_t size, i;
+    PyObject    **items  = PySequence_Fast_ITEMS(pyseq);
+    PyTypeObject *type;
+    jobject       result = NULL;
+    Py_ssize_t    i;
 
-        if (!JNI_METHOD(arraylistIConstructor, env, JARRAYLIST_TYPE, "<init>",
-                        "(I)V")) {
-            process_java_exception(env);
+    if (size < 2 || size > JINT_MAX) {
+        return NULL;
+    }
+    type = Py_TYPE(items[0]);
+    if (type != &PyLong_Type && type != &PyFloat_Type) {
+        return NULL;
+    }
+    for (i = 1; i < size; i++) {
+        if (Py_TYPE(items[i]) != type) {
             return NULL;
         }
-        size = PySequence_Fast_GET_SIZE(pyseq);
+    }
 
-        if ((*env)->PushLocalFrame(env, JLOCAL_REFS) != 0) {
-            process_java_exception(env);
+    if (type == &PyLong_Type) {
+        jlong *values = pyembed_scratch_alloc(sizeof(jlong) * size);
+        if (!values) {
+            return NULL;
+        }
+        for (i = 0; i < size; i++) {
+            values[i] = PyObject_As_jlong(items[i]);
+            if (values[i] == -1 && PyErr_Occurred()) {
+                pyembed_scratch_free(values);
+                return NULL;
+            }
+        }
+        result = JBox_Longs(env, values, (jsize) size);
+        pyembed_scratch_free(values);
+    } else {
+        jdouble *values = pyembed_scratch_alloc(sizeof(jdouble) * size);
+        if (!values) {
             return NULL;
         }
+        for (i = 0; i < size; i++) {
+            values[i] = PyFloat_AS_DOUBLE(items[i]);
+        }
+        result = JBox_Doubles(env, values, (jsize) size);
+        pyembed_scratch_free(values);
+    }
+    return result;
+}
 
-        jlist = (*env)->NewObject(env, JARRAYLIST_TYPE, arraylistIConstructor,
-                                  (int) size);
-        if (!jlist) {
-            process_java_exception(env);
-            return (*env)->PopLocalFrame(env, NULL);
+/*
+ * Nested lists, tuples and dicts are converted by staging every container and
+ * leaf in a few growable C buffers during a single walk of the python objects,
+ * then all the java collections are built by one call to
+ * jep.Util.buildCollection(). Each value is an opcode, containers are
+ * followed by their values (keys and values alternate for dicts) and the
+ * opcodes take their data from the other buffers in order. The opcodes must
+ * match the ones in Util.java.
+ */
+#define BULK_NULL   0
+#define BULK_TRUE   1
+#define BULK_FALSE  2
+#define BULK_LONG   3
+#define BULK_DOUBLE 4
+#define BULK_STRING 5  /* length in ints, characters in chars */
+#define BULK_OBJECT 6  /* converted with PyObject_As_jobject() */
+#define BULK_LIST   7  /* size in ints */
+#define BULK_TUPLE  8  /* size in ints */
+#define BULK_DICT   9  /* size in ints */
+
+typedef struct {
+    jbyte      *ops;
+    jint       *ints;
+    jlong      *longs;
+    jdouble    *doubles;
+    jchar      *chars;
+    PyObject  **objects;      /* new references */
+    Py_ssize_t  opCount, opCapacity;
+    Py_ssize_t  intCount, intCapacity;
+    Py_ssize_t  longCount, longCapacity;
+    Py_ssize_t  doubleCount, doubleCapacity;
+    Py_ssize_t  charCount, charCapacity;
+    Py_ssize_t  objectCount, objectCapacity;
+} JepBulkBuffers;
+
+/*
+ * Make room for count more items in a buffer, returns 0 with a python
+ * exception set if it cannot grow.
+ */
+static int bulk_reserve(void **buffer, Py_ssize_t *capacity, Py_ssize_t used,
+                        Py_ssize_t count, size_t itemSize)
+{
+    Py_ssize_t needed = used + count;
+    Py_ssize_t newCapacity;
+    void      *grown;
+
+    if (needed <= *capacity) {
+        return 1;
+    }
+    if (needed > JINT_MAX) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "Collection is too large to convert to java.");
+        return 0;
+    }
+    newCapacity = *capacity ? *capacity : 64;
+    while (newCapacity < needed) {
+        newCapacity *= 2;
+    }
+    if (newCapacity > JINT_MAX) {
+        newCapacity = JINT_MAX;
+    }
+    grown = PyMem_Realloc(*buffer, newCapacity * itemSize);
+    if (!grown) {
+        PyErr_NoMemory();
+        return 0;
+    }
+    *buffer = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+
+#define BULK_PUSH(b, buf, count, capacity, type, value) \
+    (bulk_reserve((void**) &(b)->buf, &(b)->capacity, (b)->count, 1, \
+                  sizeof(type)) ? ((b)->buf[(b)->count++] = (value), 1) : 0)
+
+#define BULK_OP(b, op)     BULK_PUSH(b, ops, opCount, opCapacity, jbyte, op)
+#define BULK_INT(b, value) BULK_PUSH(b, ints, intCount, intCapacity, jint, value)
+
+static void bulk_free(JepBulkBuffers *b)
+{
+    Py_ssize_t i;
+    for (i = 0; i < b->objectCount; i++) {
+        Py_DECREF(b->objects[i]);
+    }
+    PyMem_Free(b->ops);
+    PyMem_Free(b->ints);
+    PyMem_Free(b->longs);
+    PyMem_Free(b->doubles);
+    PyMem_Free(b->chars);
+    PyMem_Free(b->objects);
+}
+
+#if PY_MAJOR_VERSION >= 3
+/*
+ * Append the UTF-16 of a str to the character table. Strings with characters
+ * outside the BMP return 0 without an exception so they are converted like any
+ * other object.
+ */
+static int bulk_stage_string(JepBulkBuffers *b, PyObject *pyunicode)
+{
+    Py_ssize_t length, i;
+    jchar     *dest;
+
+    if (PyUnicode_READY(pyunicode) != 0) {
+        return -1;
+    }
+    if (PyUnicode_KIND(pyunicode) == PyUnicode_4BYTE_KIND) {
+        return 0;
+    }
+    length = PyUnicode_GET_LENGTH(pyunicode);
+    if (!bulk_reserve((void**) &b->chars, &b->charCapacity, b->charCount,
+                      length, sizeof(jchar))
+            || !BULK_OP(b, BULK_STRING) || !BULK_INT(b, (jint) length)) {
+        return -1;
+    }
+    dest = b->chars + b->charCount;
+    if (PyUnicode_KIND(pyunicode) == PyUnicode_2BYTE_KIND) {
+        memcpy(dest, PyUnicode_2BYTE_DATA(pyunicode), length * sizeof(jchar));
+    } else {
+        Py_UCS1 *data = PyUnicode_1BYTE_DATA(pyunicode);
+        for (i = 0; i < length; i++) {
+            dest[i] = data[i];
         }
+    }
+    b->charCount += length;
+    return 1;
+}
+#endif
 
-        for (i = 0; i < size; i++) {
-            jobject value;
-            PyObject *item = PySequence_Fast_GET_ITEM(pyseq, i);
-            value = PyObject_As_jobject(env, item, JOBJECT_TYPE);
-            if (value == NULL && PyErr_Occurred()) {
-                /*
-                 * java exceptions will have been transformed to python
-                 * exceptions by this point
-                 */
-                return (*env)->PopLocalFrame(env, NULL);
+/* Stage one value, returns 0 with a python exception set on failure. */
+static int bulk_stage(JepBulkBuffers *b, PyObject *pyobject)
+{
+    if (pyobject == Py_None) {
+        return BULK_OP(b, BULK_NULL);
+    } else if (PyBool_Check(pyobject)) {
+        return BULK_OP(b, pyobject == Py_True ? BULK_TRUE : BULK_FALSE);
+    } else if (PyLong_Check(pyobject)) {
+        jlong j = PyObject_As_jlong(pyobject);
+        if (j == -1 && PyErr_Occurred()) {
+            return 0;
+        }
+        return BULK_OP(b, BULK_LONG)
+               && BULK_PUSH(b, longs, longCount, longCapacity, jlong, j);
+    } else if (PyFloat_Check(pyobject)) {
+        return BULK_OP(b, BULK_DOUBLE)
+               && BULK_PUSH(b, doubles, doubleCount, doubleCapacity, jdouble,
+                            PyFloat_AS_DOUBLE(pyobject));
+#if PY_MAJOR_VERSION >= 3
+    } else if (PyUnicode_Check(pyobject)) {
+        int staged = bulk_stage_string(b, pyobject);
+        if (staged != 0) {
+            return staged > 0;
+        }
+#endif
+    } else if (PyList_Check(pyobject) || PyTuple_Check(pyobject)) {
+        Py_ssize_t size = PySequence_Fast_GET_SIZE(pyobject);
+        Py_ssize_t i;
+        int        success = 1;
+
+        if (!BULK_OP(b, PyTuple_Check(pyobject) ? BULK_TUPLE : BULK_LIST)
+                || !BULK_INT(b, (jint) size)) {
+            return 0;
+        }
+        if (Py_EnterRecursiveCall(" while converting a python object to java")) {
+            return 0;
+        }
+        for (i = 0; success && i < size; i++) {
+            success = bulk_stage(b, PySequence_Fast_GET_ITEM(pyobject, i));
+        }
+        Py_LeaveRecursiveCall();
+        return success;
+    } else if (PyDict_Check(pyobject)) {
+        Py_ssize_t pos = 0;
+        PyObject  *key, *value;
+        int        success = 1;
+
+        if (!BULK_OP(b, BULK_DICT) || !BULK_INT(b, (jint) PyDict_Size(pyobject))) {
+            return 0;
+        }
+        if (Py_EnterRecursiveCall(" while converting a python object to java")) {
+            return 0;
+        }
+        while (success && PyDict_Next(pyobject, &pos, &key, &value)) {
+            success = bulk_stage(b, key) && bulk_stage(b, value);
+        }
+        Py_LeaveRecursiveCall();
+        return success;
+    }
+
+    if (!BULK_OP(b, BULK_OBJECT)
+            || !BULK_PUSH(b, objects, objectCount, objectCapacity, PyObject*,
+                          pyobject)) {
+        return 0;
+    }
+    Py_INCREF(pyobject);
+    return 1;
+}
+
+/*
+ * Build the java collections from the staged buffers. Returns a local
+ * reference or NULL with a python exception set.
+ */
+static jobject bulk_build(JNIEnv *env, JepBulkBuffers *b)
+{
+    jbyteArray   ops;
+    jintArray    ints    = NULL;
+    jlongArray   longs   = NULL;
+    jdoubleArray doubles = NULL;
+    jcharArray   chars   = NULL;
+    jobjectArray objects = NULL;
+    jobject      result;
+    Py_ssize_t   i;
+
+    if ((*env)->PushLocalFrame(env, JLOCAL_REFS) != 0) {
+        process_java_exception(env);
+        return NULL;
+    }
+
+    ops = (*env)->NewByteArray(env, (jsize) b->opCount);
+    if (!ops) {
+        goto EXIT_ERROR;
+    }
+    (*env)->SetByteArrayRegion(env, ops, 0, (jsize) b->opCount, b->ops);
+    if (b->intCount) {
+        ints = (*env)->NewIntArray(env, (jsize) b->intCount);
+        if (!ints) {
+            goto EXIT_ERROR;
+        }
+        (*env)->SetIntArrayRegion(env, ints, 0, (jsize) b->intCount, b->ints);
+    }
+    if (b->longCount) {
+        longs = (*env)->NewLongArray(env, (jsize) b->longCount);
+        if (!longs) {
+            goto EXIT_ERROR;
+        }
+        (*env)->SetLongArrayRegion(env, longs, 0, (jsize) b->longCount,
+                                   b->longs);
+    }
+    if (b->doubleCount) {
+        doubles = (*env)->NewDoubleArray(env, (jsize) b->doubleCount);
+        if (!doubles) {
+            goto EXIT_ERROR;
+        }
+        (*env)->SetDoubleArrayRegion(env, doubles, 0, (jsize) b->doubleCount,
+                                     b->doubles);
+    }
+    if (b->charCount) {
+        chars = (*env)->NewCharArray(env, (jsize) b->charCount);
+        if (!chars) {
+            goto EXIT_ERROR;
+        }
+        (*env)->SetCharArrayRegion(env, chars, 0, (jsize) b->charCount,
+                                   b->chars);
+    }
+    if (b->objectCount) {
+        objects = (*env)->NewObjectArray(env, (jsize) b->objectCount,
+                                         JOBJECT_TYPE, NULL);
+        if (!objects) {
+            goto EXIT_ERROR;
+        }
+        for (i = 0; i < b->objectCount; i++) {
+            jobject value = PyObject_As_jobject(env, b->objects[i], JOBJECT_TYPE);
+            if (!value && PyErr_Occurred()) {
+                (*env)->PopLocalFrame(env, NULL);
+                return NULL;
             }
-            java_util_List_add(env, jlist, value);
+            (*env)->SetObjectArrayElement(env, objects, (jsize) i, value);
             (*env)->DeleteLocalRef(env, value);
-            if (process_java_exception(env)) {
-                return (*env)->PopLocalFrame(env, NULL);
-            }
         }
+    }
 
-        if (PyTuple_Check(pyseq)) {
-            jlist = java_util_Collections_unmodifiableList(env, jlist);
-            if (process_java_exception(env)) {
-                return (*env)->PopLocalFrame(env, NULL);
+    result = jep_Util_buildCollection(env, ops, ints, longs, doubles, chars,
+                                      objects);
+    if (!result) {
+        goto EXIT_ERROR;
+    }
+    return (*env)->PopLocalFrame(env, result);
+
+EXIT_ERROR:
+    process_java_exception(env);
+    (*env)->PopLocalFrame(env, NULL);
+    return NULL;
+}
+
+/*
+ * Convert a list, tuple or dict and everything nested in it to an ArrayList,
+ * an unmodifiable List or a HashMap.
+ */
+static jobject pycollection_as_jobject(JNIEnv *env, PyObject *pyobject)
+{
+    JepBulkBuffers b;
+    jobject        result = NULL;
+
+    memset(&b, 0, sizeof(b));
+    if (bulk_stage(&b, pyobject)) {
+        result = bulk_build(env, &b);
+    }
+    bulk_free(&b);
+    return result;
+}
+
+/*
+ * Gather the numbers of a list or tuple as doubles, returns 0 with a python
+ * exception set if an item is not a number.
+ */
+static int pyfastsequence_gather_doubles(PyObject **items, Py_ssize_t size,
+        jdouble *values)
+{
+    Py_ssize_t i;
+    for (i = 0; i < size; i++) {
+        if (PyFloat_CheckExact(items[i])) {
+            values[i] = PyFloat_AS_DOUBLE(items[i]);
+        } else {
+            values[i] = PyObject_As_jdouble(items[i]);
+            if (values[i] == -1.0 && PyErr_Occurred()) {
+                return 0;
             }
         }
-        return (*env)->PopLocalFrame(env, jlist);
     }
-    raiseTypeError(env, pyseq, expectedType);
-    return NULL;
+    return 1;
 }
 
-static jobject pydict_as_jobject(JNIEnv *env, PyObject *pydict,
-                                 jclass expectedType)
+/*
+ * Gather the integers of a list or tuple as longs and check that all of them
+ * fit in [min, max]. The range check is a separate loop over the C array that
+ * only compares, so the compiler can vectorize it. Returns 0 with a python
+ * exception set if an item is not an integer or out of range.
+ */
+static int pyfastsequence_gather_longs(PyObject **items, Py_ssize_t size,
+                                       jlong *values, jlong min, jlong max,
+                                       const char *name)
 {
-    if ((*env)->IsAssignableFrom(env, JHASHMAP_TYPE, expectedType)) {
-        jobject jmap;
-        Py_ssize_t size, pos;
-        PyObject *key, *value;
+    jlong      low  = 0;
+    jlong      high = 0;
+    Py_ssize_t i;
 
-        if (!JNI_METHOD(hashmapIConstructor, env, JHASHMAP_TYPE, "<init>", "(I)V")) {
-            process_java_exception(env);
+    for (i = 0; i < size; i++) {
+        if (PyLong_CheckExact(items[i])) {
+            values[i] = PyLong_AsLongLong(items[i]);
+        } else {
+            values[i] = PyObject_As_jlong(items[i]);
+        }
+        if (values[i] == -1 && PyErr_Occurred()) {
+            return 0;
+        }
+    }
+
+    for (i = 0; i < size; i++) {
+        low  = values[i] < low ? values[i] : low;
+        high = values[i] > high ? values[i] : high;
+    }
+    if (low < min || high > max) {
+        jlong outside = low < min ? low : high;
+        PyErr_Format(PyExc_OverflowError, "%lld is outside the valid range "
+                     "of a Java %s.", (PY_LONG_LONG) outside, name);
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Convert a list or tuple of numbers to a double[], float[], long[], int[],
+ * short[] or byte[]. The numbers are gathered into a C array of doubles or
+ * longs, narrowed to the element type by a plain casting loop and copied into
+ * the new java array with a single Set<Type>ArrayRegion. Returns NULL without
+ * an exception if expectedType is not one of those arrays.
+ */
+static jobject pyfastsequence_as_jarray(JNIEnv *env, PyObject *pyseq,
+                                        jclass expectedType)
+{
+    int         typeId = get_numeric_array_jtype(env, expectedType);
+    PyObject  **items  = PySequence_Fast_ITEMS(pyseq);
+    Py_ssize_t  size   = PySequence_Fast_GET_SIZE(pyseq);
+    jsize       len    = (jsize) size;
+    jarray      result = NULL;
+    jdouble    *doubles;
+    jlong      *longs;
+    Py_ssize_t  i;
+
+    if (typeId < 0) {
+        return NULL;
+    }
+    if (size > JINT_MAX) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "Sequence is too large to convert to a java array.");
+        return NULL;
+    }
+
+    if (typeId == JDOUBLE_ID || typeId == JFLOAT_ID) {
+        doubles = pyembed_scratch_alloc(sizeof(jdouble) * (size ? size : 1));
+        if (!doubles) {
+            return NULL;
+        }
+        if (!pyfastsequence_gather_doubles(items, size, doubles)) {
+            pyembed_scratch_free(doubles);
+            return NULL;
+        }
+        if (typeId == JDOUBLE_ID) {
+            result = (*env)->NewDoubleArray(env, len);
+            if (result) {
+                (*env)->SetDoubleArrayRegion(env, result, 0, len, doubles);
+            }
+        } else {
+            jfloat *floats = pyembed_scratch_alloc(sizeof(jfloat) * (size ? size : 1));
+            if (!floats) {
+                pyembed_scratch_free(doubles);
+                return NULL;
+            }
+            for (i = 0; i < size; i++) {
+                floats[i] = (jfloat) doubles[i];
+            }
+            result = (*env)->NewFloatArray(env, len);
+            if (result) {
+                (*env)->SetFloatArrayRegion(env, result, 0, len, floats);
+            }
+            pyembed_scratch_free(floats);
+        }
+        pyembed_scratch_free(doubles);
+    } else {
+        jlong       min  = JLONG_MIN;
+        jlong       max  = JLONG_MAX;
+        const char *name = "long";
+        if (typeId == JINT_ID) {
+            min  = JINT_MIN;
+            max  = JINT_MAX;
+            name = "int";
+        } else if (typeId == JSHORT_ID) {
+            min  = JSHORT_MIN;
+            max  = JSHORT_MAX;
+            name = "short";
+        } else if (typeId == JBYTE_ID) {
+            min  = JBYTE_MIN;
+            max  = JBYTE_MAX;
+            name = "byte";
+        }
+
+        longs = pyembed_scratch_alloc(sizeof(jlong) * (size ? size : 1));
+        if (!longs) {
             return NULL;
         }
+        if (!pyfastsequence_gather_longs(items, size, longs, min, max, name)) {
+            pyembed_scratch_free(longs);
+            return NULL;
+        }
+        switch (typeId) {
+        case JLONG_ID:
+            result = (*env)->NewLongArray(env, len);
+            if (result) {
+                (*env)->SetLongArrayRegion(env, result, 0, len, longs);
+            }
+            break;
+        case JINT_ID: {
+            jint *ints = pyembed_scratch_alloc(sizeof(jint) * (size ? size : 1));
+            if (!ints) {
+                break;
+            }
+            for (i = 0; i < size; i++) {
+                ints[i] = (jint) longs[i];
+            }
+            result = (*env)->NewIntArray(env, len);
+            if (result) {
+                (*env)->SetIntArrayRegion(env, result, 0, len, ints);
+            }
+            pyembed_scratch_free(ints);
+            break;
+        }
+        case JSHORT_ID: {
+            jshort *shorts = pyembed_scratch_alloc(sizeof(jshort) * (size ? size : 1));
+            if (!shorts) {
+                break;
+            }
+            for (i = 0; i < size; i++) {
+                shorts[i] = (jshort) longs[i];
+            }
+            result = (*env)->NewShortArray(env, len);
+            if (result) {
+                (*env)->SetShortArrayRegion(env, result, 0, len, shorts);
+            }
+            pyembed_scratch_free(shorts);
+            break;
+        }
+        case JBYTE_ID: {
+            jbyte *bytes = pyembed_scratch_alloc(sizeof(jbyte) * (size ? size : 1));
+            if (!bytes) {
+                break;
+            }
+            for (i = 0; i < size; i++) {
+                bytes[i] = (jbyte) longs[i];
+            }
+            result = (*env)->NewByteArray(env, len);
+            if (result) {
+                (*env)->SetByteArrayRegion(env, result, 0, len, bytes);
+            }
+            pyembed_scratch_free(bytes);
+            break;
+        }
+        }
+        pyembed_scratch_free(longs);
+    }
+
+    if (!result) {
+        process_java_exception(env);
+    }
+    return result;
+}
+
+static jmethodID listViewConstructor = 0;
+static jmethodID mapViewConstructor  = 0;
 
-        size = PyDict_Size(pydict);
-        /* Account for default load factor */
-        size = (Py_ssize_t) ((size / 0.75) + 1);
+/* Make a view of a list, tuple or dict, see PyObject_As_jview() */
+static jobject pycollection_as_view(JNIEnv *env, PyObject *pyobject)
+{
+    JepThread *jepThread = pyembed_get_jepthread();
+    jclass     viewType;
+    jmethodID  constructor;
+    jobject    view;
+
+    if (!jepThread) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_RuntimeError, "Invalid JepThread pointer.");
+        }
+        return NULL;
+    }
 
-        if ((*env)->PushLocalFrame(env, JLOCAL_REFS) != 0) {
+    if (PyDict_Check(pyobject)) {
+        viewType = JEP_MAPVIEW_TYPE;
+        if (!JNI_METHOD(mapViewConstructor, env, viewType, "<init>",
+                        "(Ljep/Jep;JJ)V")) {
             process_java_exception(env);
             return NULL;
         }
-
-        jmap = (*env)->NewObject(env, JHASHMAP_TYPE, hashmapIConstructor, (jint) size);
-        if (!jmap) {
+        constructor = mapViewConstructor;
+    } else {
+        viewType = JEP_LISTVIEW_TYPE;
+        if (!JNI_METHOD(listViewConstructor, env, viewType, "<init>",
+                        "(Ljep/Jep;JJ)V")) {
             process_java_exception(env);
-            (*env)->PopLocalFrame(env, NULL);
             return NULL;
         }
+        constructor = listViewConstructor;
+    }
 
-        pos = 0;
-        while (PyDict_Next(pydict, &pos, &key, &value)) {
-            jobject jkey, jvalue;
-            jkey = PyObject_As_jobject(env, key, JOBJECT_TYPE);
-            if (jkey == NULL && PyErr_Occurred()) {
-                (*env)->PopLocalFrame(env, NULL);
-                return NULL;
-            }
-            jvalue = PyObject_As_jobject(env, value, JOBJECT_TYPE);
-            if (jvalue == NULL && PyErr_Occurred()) {
-                (*env)->PopLocalFrame(env, NULL);
-                return NULL;
-            }
+    /* released by jep.python.PyObject.close() */
+    Py_INCREF(pyobject);
+    view = (*env)->NewObject(env, viewType, constructor, jepThread->caller,
+                             (jlong) (intptr_t) jepThread,
+                             (jlong) (intptr_t) pyobject);
+    if (!view) {
+        Py_DECREF(pyobject);
+        process_java_exception(env);
+    }
+    return view;
+}
+
+jobject PyObject_As_jview(JNIEnv *env, PyObject *pyobject)
+{
+    if (PyList_Check(pyobject) || PyTuple_Check(pyobject)
+            || PyDict_Check(pyobject)) {
+        return pycollection_as_view(env, pyobject);
+    }
+    return PyObject_As_jobject(env, pyobject, JOBJECT_TYPE);
+}
+
+/*
+ * Whether a container is converted to a view for the expected type. Declaring
+ * a view class as the type always asks for a view, other types that a view
+ * can be assigned to, like List, Map or Object, get one when the JepConfig
+ * enabled collection views.
+ */
+static int pycollection_use_view(JNIEnv *env, jclass viewType,
+                                 jclass expectedType)
+{
+    JepThread *jepThread;
 
-            java_util_Map_put(env, jmap, jkey, jvalue);
-            (*env)->DeleteLocalRef(env, jkey);
-            (*env)->DeleteLocalRef(env, jvalue);
+    if ((*env)->IsSameObject(env, viewType, expectedType)) {
+        return 1;
+    }
+    jepThread = pyembed_find_jepthread();
+    return jepThread && jepThread->collectionViews
+           && (*env)->IsAssignableFrom(env, viewType, expectedType);
+}
+
+/* Convert a list or tuple to an ArrayList or a primitive array */
+static jobject pyfastsequence_as_jobject(JNIEnv *env, PyObject *pyseq,
+        jclass expectedType)
+{
+    if (pycollection_use_view(env, JEP_LISTVIEW_TYPE, expectedType)) {
+        return pycollection_as_view(env, pyseq);
+    } else if ((*env)->IsAssignableFrom(env, JLIST_TYPE, expectedType)
+            || (PyList_Check(pyseq)
+                && (*env)->IsAssignableFrom(env, JARRAYLIST_TYPE, expectedType))) {
+        jobject jlist;
+
+        /* flat lists of numbers are boxed without staging any opcodes */
+        jlist = pyfastsequence_as_boxed_list(env, pyseq,
+                                             PySequence_Fast_GET_SIZE(pyseq));
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+        if (!jlist) {
+            return pycollection_as_jobject(env, pyseq);
+        }
+
+        if (PyTuple_Check(pyseq)) {
+            jobject tuple = java_util_Collections_unmodifiableList(env, jlist);
+            (*env)->DeleteLocalRef(env, jlist);
             if (process_java_exception(env)) {
-                (*env)->PopLocalFrame(env, NULL);
                 return NULL;
             }
+            jlist = tuple;
+        }
+        return jlist;
+    } else {
+        jobject jarray = pyfastsequence_as_jarray(env, pyseq, expectedType);
+        if (jarray || PyErr_Occurred()) {
+            return jarray;
         }
-        return (*env)->PopLocalFrame(env, jmap);
+    }
+    raiseTypeError(env, pyseq, expectedType);
+    return NULL;
+}
+
+static jobject pydict_as_jobject(JNIEnv *env, PyObject *pydict,
+                                 jclass expectedType)
+{
+    if (pycollection_use_view(env, JEP_MAPVIEW_TYPE, expectedType)) {
+        return pycollection_as_view(env, pydict);
+    } else if ((*env)->IsAssignableFrom(env, JHASHMAP_TYPE, expectedType)) {
+        return pycollection_as_jobject(env, pydict);
     }
     raiseTypeError(env, pydict, expectedType);
     return NULL;
@@ -675,6 +1275,8 @@ jobject PyCallable_as_functional_interface(JNIEnv *env, PyObject *callable,
 jobject PyObject_As_jobject(JNIEnv *env, PyObject *pyobject,
                             jclass expectedType)
 {
+    jobject converted;
+
     if (pyobject == Py_None) {
         return NULL;
     } else if (PyJClass_Check(pyobject)) {
@@ -712,12 +1314,24 @@ jobject PyObject_As_jobject(JNIEnv *env, PyObject *pyobject,
         return pyfastsequence_as_jobject(env, pyobject, expectedType);
     } else if (PyDict_Check(pyobject)) {
         return pydict_as_jobject(env, pyobject, expectedType);
+    } else if (JepConverter_ToJava(env, pyobject, expectedType, &converted)) {
+        return converted;
     } else if (PyCallable_Check(pyobject)) {
-        if (isFunctionalInterfaceType(env, expectedType)) {
-            return PyCallable_as_functional_interface(env, pyobject, expectedType);
-        } else if (PyErr_Occurred()) {
+        /* the descriptor remembers if the type is a functional interface */
+        PyJClassInfoObject *info = PyJClassInfo_Get(env, expectedType);
+        if (!info) {
             return NULL;
         }
+        if (info->functional < 0) {
+            char functional = isFunctionalInterfaceType(env, expectedType);
+            if (PyErr_Occurred()) {
+                return NULL;
+            }
+            info->functional = functional;
+        }
+        if (info->functional) {
+            return PyCallable_as_functional_interface(env, pyobject, expectedType);
+        }
 #if JEP_NUMPY_ENABLED
     } else if (npy_array_check(pyobject)) {
         return convert_pyndarray_jobject(env, pyobject, expectedType);
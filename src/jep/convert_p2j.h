@@ -86,6 +86,14 @@ jstring  PyObject_As_jstring(JNIEnv*, PyObject*);
  */
 jobject  PyObject_As_jobject(JNIEnv*, PyObject*, jclass);
 
+/*
+ * Lists and tuples become a jep.python.PyListView and dicts a
+ * jep.python.PyMapView that keep a reference to the python object, anything
+ * else is converted by PyObject_As_jobject. NULL is returned if an error
+ * occurs or for None.
+ */
+jobject  PyObject_As_jview(JNIEnv*, PyObject*);
+
 /*
  * Use PyErr_Occurred() after this to check for errors
  */
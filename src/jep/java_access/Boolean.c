@@ -29,13 +29,12 @@
 
 static jmethodID booleanValue = 0;
 
+/* Boolean is final so this cannot run python code, the GIL is kept. */
 jboolean java_lang_Boolean_booleanValue(JNIEnv* env, jobject this)
 {
     jboolean result = JNI_FALSE;
-    Py_BEGIN_ALLOW_THREADS
     if (JNI_METHOD(booleanValue, env, JBOOL_OBJ_TYPE, "booleanValue", "()Z")) {
         result = (*env)->CallBooleanMethod(env, this, booleanValue);
     }
-    Py_END_ALLOW_THREADS
     return result;
 }
@@ -29,13 +29,12 @@
 
 static jmethodID charValue = 0;
 
+/* Character is final and charValue() is trivial, the GIL is kept. */
 jchar java_lang_Character_charValue(JNIEnv* env, jobject this)
 {
     jchar result = 0;
-    Py_BEGIN_ALLOW_THREADS
     if (JNI_METHOD(charValue, env, JCHAR_OBJ_TYPE, "charValue", "()C")) {
         result = (*env)->CallCharMethod(env, this, charValue);
     }
-    Py_END_ALLOW_THREADS
     return result;
 }
@@ -38,16 +38,20 @@ static jmethodID getSimpleName      = 0;
 static jmethodID isArray            = 0;
 static jmethodID newInstance        = 0;
 static jmethodID isInterface        = 0;
+static jmethodID isEnum             = 0;
 
+/*
+ * getComponentType(), getModifiers(), getName(), isArray(), isInterface() and
+ * isEnum() of the final Class cannot run python code or load classes, so they
+ * keep the GIL instead of paying to release and reacquire it.
+ */
 jclass java_lang_Class_getComponentType(JNIEnv* env, jclass this)
 {
     jclass result = NULL;
-    Py_BEGIN_ALLOW_THREADS
     if (JNI_METHOD(getComponentType, env, JCLASS_TYPE, "getComponentType",
                    "()Ljava/lang/Class;")) {
         result = (jclass) (*env)->CallObjectMethod(env, this, getComponentType);
     }
-    Py_END_ALLOW_THREADS
     return result;
 }
 
@@ -102,22 +106,18 @@ jobjectArray java_lang_Class_getMethods(JNIEnv* env, jclass this)
 jint java_lang_Class_getModifiers(JNIEnv* env, jclass this)
 {
     jint result = 0;
-    Py_BEGIN_ALLOW_THREADS
     if (JNI_METHOD(getModifiers, env, JCLASS_TYPE, "getModifiers", "()I")) {
         result = (*env)->CallIntMethod(env, this, getModifiers);
     }
-    Py_END_ALLOW_THREADS
     return result;
 }
 
 jstring java_lang_Class_getName(JNIEnv* env, jclass this)
 {
     jstring result = NULL;
-    Py_BEGIN_ALLOW_THREADS
     if (JNI_METHOD(getName, env, JCLASS_TYPE, "getName", "()Ljava/lang/String;")) {
         result = (jstring) (*env)->CallObjectMethod(env, this, getName);
     }
-    Py_END_ALLOW_THREADS
     return result;
 }
 
@@ -136,11 +136,9 @@ jstring java_lang_Class_getSimpleName(JNIEnv* env, jclass this)
 jboolean java_lang_Class_isArray(JNIEnv* env, jclass this)
 {
     jboolean result = JNI_FALSE;
-    Py_BEGIN_ALLOW_THREADS
     if (JNI_METHOD(isArray, env, JCLASS_TYPE, "isArray", "()Z")) {
         result = (*env)->CallBooleanMethod(env, this, isArray);
     }
-    Py_END_ALLOW_THREADS
     return result;
 }
 
@@ -159,10 +157,17 @@ jobject java_lang_Class_newInstance(JNIEnv* env, jclass this)
 jboolean java_lang_Class_isInterface(JNIEnv* env, jclass this)
 {
     jboolean result = JNI_FALSE;
-    Py_BEGIN_ALLOW_THREADS
     if (JNI_METHOD(isInterface, env, JCLASS_TYPE, "isInterface", "()Z")) {
         result = (*env)->CallBooleanMethod(env, this, isInterface);
     }
-    Py_END_ALLOW_THREADS
+    return result;
+}
+
+jboolean java_lang_Class_isEnum(JNIEnv* env, jclass this)
+{
+    jboolean result = JNI_FALSE;
+    if (JNI_METHOD(isEnum, env, JCLASS_TYPE, "isEnum", "()Z")) {
+        result = (*env)->CallBooleanMethod(env, this, isEnum);
+    }
     return result;
 }
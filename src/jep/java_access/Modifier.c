@@ -30,6 +30,7 @@
 static jmethodID isPublic   = 0;
 static jmethodID isStatic   = 0;
 static jmethodID isAbstract = 0;
+static jmethodID isFinal    = 0;
 
 jboolean java_lang_reflect_Modifier_isPublic(JNIEnv* env, jint mod)
 {
@@ -63,3 +64,14 @@ jboolean java_lang_reflect_Modifier_isAbstract(JNIEnv* env, jint mod)
     }
     return result;
 }
+
+jboolean java_lang_reflect_Modifier_isFinal(JNIEnv* env, jint mod)
+{
+    jboolean result = JNI_FALSE;
+    if (isFinal
+            || (isFinal = (*env)->GetStaticMethodID(env, JMODIFIER_TYPE, "isFinal",
+                          "(I)Z"))) {
+        result = (*env)->CallStaticBooleanMethod(env, JMODIFIER_TYPE, isFinal, mod);
+    }
+    return result;
+}
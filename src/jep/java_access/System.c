@@ -0,0 +1,42 @@
+/*
+   jep - Java Embedded Python
+
+   Copyright (c) 2017 JEP AUTHORS.
+
+   This file is licensed under the the zlib/libpng License.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+   must not claim that you wrote the original software. If you use
+   this software in a product, an acknowledgment in the product
+   documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+   must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+#include "Jep.h"
+
+static jmethodID identityHashCode = 0;
+
+jint java_lang_System_identityHashCode(JNIEnv* env, jobject obj)
+{
+    jint result = 0;
+    if (identityHashCode
+            || (identityHashCode = (*env)->GetStaticMethodID(env, JSYSTEM_TYPE,
+                                   "identityHashCode", "(Ljava/lang/Object;)I"))) {
+        result = (*env)->CallStaticIntMethod(env, JSYSTEM_TYPE, identityHashCode,
+                                             obj);
+    }
+    return result;
+}
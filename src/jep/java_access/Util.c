@@ -0,0 +1,157 @@
+/*
+   jep - Java Embedded Python
+
+   Copyright (c) 2017 JEP AUTHORS.
+
+   This file is licensed under the the zlib/libpng License.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+   must not claim that you wrote the original software. If you use
+   this software in a product, an acknowledgment in the product
+   documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+   must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+#include "Jep.h"
+
+static jmethodID getMethods      = 0;
+static jmethodID getField        = 0;
+static jmethodID forName         = 0;
+static jmethodID getFingerprint  = 0;
+static jmethodID boxLongs        = 0;
+static jmethodID boxDoubles      = 0;
+static jmethodID buildCollection = 0;
+static jmethodID snapshot        = 0;
+
+jobjectArray jep_Util_getMethods(JNIEnv* env, jclass clazz, jstring name)
+{
+    jobjectArray result = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    if (getMethods
+            || (getMethods = (*env)->GetStaticMethodID(env, JEP_UTIL_TYPE,
+                             "getMethods",
+                             "(Ljava/lang/Class;Ljava/lang/String;)[Ljava/lang/reflect/Method;"))) {
+        result = (jobjectArray) (*env)->CallStaticObjectMethod(env, JEP_UTIL_TYPE,
+                 getMethods, clazz, name);
+    }
+    Py_END_ALLOW_THREADS
+    return result;
+}
+
+jobject jep_Util_getField(JNIEnv* env, jclass clazz, jstring name)
+{
+    jobject result = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    if (getField
+            || (getField = (*env)->GetStaticMethodID(env, JEP_UTIL_TYPE,
+                           "getField",
+                           "(Ljava/lang/Class;Ljava/lang/String;)Ljava/lang/reflect/Field;"))) {
+        result = (*env)->CallStaticObjectMethod(env, JEP_UTIL_TYPE, getField,
+                                                clazz, name);
+    }
+    Py_END_ALLOW_THREADS
+    return result;
+}
+
+jclass jep_Util_forName(JNIEnv* env, jclass context, jstring name)
+{
+    jclass result = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    if (forName
+            || (forName = (*env)->GetStaticMethodID(env, JEP_UTIL_TYPE,
+                          "forName",
+                          "(Ljava/lang/Class;Ljava/lang/String;)Ljava/lang/Class;"))) {
+        result = (jclass) (*env)->CallStaticObjectMethod(env, JEP_UTIL_TYPE,
+                 forName, context, name);
+    }
+    Py_END_ALLOW_THREADS
+    return result;
+}
+
+jstring jep_Util_getFingerprint(JNIEnv* env, jclass clazz)
+{
+    jstring result = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    if (getFingerprint
+            || (getFingerprint = (*env)->GetStaticMethodID(env, JEP_UTIL_TYPE,
+                                 "getFingerprint",
+                                 "(Ljava/lang/Class;)Ljava/lang/String;"))) {
+        result = (jstring) (*env)->CallStaticObjectMethod(env, JEP_UTIL_TYPE,
+                 getFingerprint, clazz);
+    }
+    Py_END_ALLOW_THREADS
+    return result;
+}
+
+jobject jep_Util_boxLongs(JNIEnv* env, jlongArray values)
+{
+    jobject result = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    if (boxLongs
+            || (boxLongs = (*env)->GetStaticMethodID(env, JEP_UTIL_TYPE,
+                           "boxLongs", "([J)Ljava/util/List;"))) {
+        result = (*env)->CallStaticObjectMethod(env, JEP_UTIL_TYPE, boxLongs,
+                                                values);
+    }
+    Py_END_ALLOW_THREADS
+    return result;
+}
+
+jobject jep_Util_boxDoubles(JNIEnv* env, jdoubleArray values)
+{
+    jobject result = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    if (boxDoubles
+            || (boxDoubles = (*env)->GetStaticMethodID(env, JEP_UTIL_TYPE,
+                             "boxDoubles", "([D)Ljava/util/List;"))) {
+        result = (*env)->CallStaticObjectMethod(env, JEP_UTIL_TYPE, boxDoubles,
+                                                values);
+    }
+    Py_END_ALLOW_THREADS
+    return result;
+}
+
+jobject jep_Util_buildCollection(JNIEnv* env, jbyteArray ops, jintArray ints,
+                                 jlongArray longs, jdoubleArray doubles,
+                                 jcharArray chars, jobjectArray objects)
+{
+    jobject result = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    if (buildCollection
+            || (buildCollection = (*env)->GetStaticMethodID(env, JEP_UTIL_TYPE,
+                                  "buildCollection",
+                                  "([B[I[J[D[C[Ljava/lang/Object;)Ljava/lang/Object;"))) {
+        result = (*env)->CallStaticObjectMethod(env, JEP_UTIL_TYPE,
+                                                buildCollection, ops, ints,
+                                                longs, doubles, chars, objects);
+    }
+    Py_END_ALLOW_THREADS
+    return result;
+}
+
+jobjectArray jep_Util_snapshot(JNIEnv* env, jobject container)
+{
+    jobjectArray result = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    if (snapshot
+            || (snapshot = (*env)->GetStaticMethodID(env, JEP_UTIL_TYPE,
+                           "snapshot", "(Ljava/lang/Object;)[Ljava/lang/Object;"))) {
+        result = (jobjectArray) (*env)->CallStaticObjectMethod(env,
+                 JEP_UTIL_TYPE, snapshot, container);
+    }
+    Py_END_ALLOW_THREADS
+    return result;
+}
@@ -27,8 +27,6 @@
 
 #include "Jep.h"
 
-static jmethodID booleanConstructor = 0;
-static jmethodID byteConstructor    = 0;
 static jmethodID shortConstructor   = 0;
 static jmethodID intConstructor     = 0;
 static jmethodID longConstructor    = 0;
@@ -36,26 +34,84 @@ static jmethodID floatConstructor   = 0;
 static jmethodID doubleConstructor  = 0;
 static jmethodID charConstructor    = 0;
 
-jobject JBox_Boolean(JNIEnv* env, jboolean z)
+static jmethodID booleanValueOf = 0;
+static jmethodID byteValueOf    = 0;
+static jmethodID shortValueOf   = 0;
+static jmethodID intValueOf     = 0;
+static jmethodID longValueOf    = 0;
+static jmethodID charValueOf    = 0;
+
+/*
+ * Boxed objects for the values that java itself caches in valueOf(), so
+ * boxing them only needs a new local reference instead of a call into java.
+ * Each global ref is created from valueOf() the first time the value is
+ * boxed. All interpreters share the cache, which is safe because boxing is
+ * always done while holding the GIL.
+ */
+#define JBOX_CACHE_LOW  -128
+#define JBOX_CACHE_HIGH 127
+#define JBOX_CACHE_SIZE (JBOX_CACHE_HIGH - JBOX_CACHE_LOW + 1)
+
+static jobject booleanCache[2];
+static jobject byteCache[JBOX_CACHE_SIZE];
+static jobject shortCache[JBOX_CACHE_SIZE];
+static jobject intCache[JBOX_CACHE_SIZE];
+static jobject longCache[JBOX_CACHE_SIZE];
+static jobject charCache[JBOX_CACHE_HIGH + 1];
+
+/*
+ * Get a new local reference to a cached boxed value, creating the cache entry
+ * with the valueOf() method of the boxed class the first time.
+ */
+static jobject jbox_cached(JNIEnv *env, jobject *entry, jclass clazz,
+                           jmethodID *valueOf, const char *sig, jvalue value)
 {
-    if (!JNI_METHOD(booleanConstructor, env, JBOOL_OBJ_TYPE, "<init>", "(Z)V")) {
-        process_java_exception(env);
+    jobject boxed;
+
+    if (*entry) {
+        return (*env)->NewLocalRef(env, *entry);
+    }
+    if (!*valueOf) {
+        *valueOf = (*env)->GetStaticMethodID(env, clazz, "valueOf", sig);
+        if (!*valueOf) {
+            process_java_exception(env);
+            return NULL;
+        }
+    }
+    boxed = (*env)->CallStaticObjectMethodA(env, clazz, *valueOf, &value);
+    if (process_java_exception(env) || !boxed) {
         return NULL;
     }
-    return (*env)->NewObject(env, JBOOL_OBJ_TYPE, booleanConstructor, z);
+    *entry = (*env)->NewGlobalRef(env, boxed);
+    return boxed;
+}
+
+jobject JBox_Boolean(JNIEnv* env, jboolean z)
+{
+    jvalue value;
+    value.z = z ? JNI_TRUE : JNI_FALSE;
+    return jbox_cached(env, &booleanCache[value.z], JBOOL_OBJ_TYPE,
+                       &booleanValueOf, "(Z)Ljava/lang/Boolean;", value);
 }
 
 jobject JBox_Byte(JNIEnv* env, jbyte b)
 {
-    if (!JNI_METHOD(byteConstructor, env, JBYTE_OBJ_TYPE, "<init>", "(B)V")) {
-        process_java_exception(env);
-        return NULL;
-    }
-    return (*env)->NewObject(env, JBYTE_OBJ_TYPE, byteConstructor, b);
+    jvalue value;
+    /* every byte is in the cache */
+    value.b = b;
+    return jbox_cached(env, &byteCache[b - JBOX_CACHE_LOW], JBYTE_OBJ_TYPE,
+                       &byteValueOf, "(B)Ljava/lang/Byte;", value);
 }
 
 jobject JBox_Short(JNIEnv* env, jshort s)
 {
+    if (s >= JBOX_CACHE_LOW && s <= JBOX_CACHE_HIGH) {
+        jvalue value;
+        value.s = s;
+        return jbox_cached(env, &shortCache[s - JBOX_CACHE_LOW],
+                           JSHORT_OBJ_TYPE, &shortValueOf,
+                           "(S)Ljava/lang/Short;", value);
+    }
     if (!JNI_METHOD(shortConstructor, env, JSHORT_OBJ_TYPE, "<init>", "(S)V")) {
         process_java_exception(env);
         return NULL;
@@ -65,6 +121,12 @@ jobject JBox_Short(JNIEnv* env, jshort s)
 
 jobject JBox_Int(JNIEnv* env, jint i)
 {
+    if (i >= JBOX_CACHE_LOW && i <= JBOX_CACHE_HIGH) {
+        jvalue value;
+        value.i = i;
+        return jbox_cached(env, &intCache[i - JBOX_CACHE_LOW], JINT_OBJ_TYPE,
+                           &intValueOf, "(I)Ljava/lang/Integer;", value);
+    }
     if (!JNI_METHOD(intConstructor, env, JINT_OBJ_TYPE, "<init>", "(I)V")) {
         process_java_exception(env);
         return NULL;
@@ -74,6 +136,12 @@ jobject JBox_Int(JNIEnv* env, jint i)
 
 jobject JBox_Long(JNIEnv* env, jlong j)
 {
+    if (j >= JBOX_CACHE_LOW && j <= JBOX_CACHE_HIGH) {
+        jvalue value;
+        value.j = j;
+        return jbox_cached(env, &longCache[j - JBOX_CACHE_LOW], JLONG_OBJ_TYPE,
+                           &longValueOf, "(J)Ljava/lang/Long;", value);
+    }
     if (!JNI_METHOD(longConstructor, env, JLONG_OBJ_TYPE, "<init>", "(J)V")) {
         process_java_exception(env);
         return NULL;
@@ -101,6 +169,12 @@ jobject JBox_Double(JNIEnv* env, jdouble d)
 
 jobject JBox_Char(JNIEnv* env, jchar c)
 {
+    if (c <= JBOX_CACHE_HIGH) {
+        jvalue value;
+        value.c = c;
+        return jbox_cached(env, &charCache[c], JCHAR_OBJ_TYPE, &charValueOf,
+                           "(C)Ljava/lang/Character;", value);
+    }
     if (!JNI_METHOD(charConstructor, env, JCHAR_OBJ_TYPE, "<init>", "(C)V")) {
         process_java_exception(env);
         return NULL;
@@ -108,3 +182,57 @@ jobject JBox_Char(JNIEnv* env, jchar c)
     return (*env)->NewObject(env, JCHAR_OBJ_TYPE, charConstructor, c);
 }
 
+jobject JBox_Longs(JNIEnv* env, const jlong *values, jsize len)
+{
+    jobject    result;
+    jlongArray array = (*env)->NewLongArray(env, len);
+    if (!array) {
+        process_java_exception(env);
+        return NULL;
+    }
+    (*env)->SetLongArrayRegion(env, array, 0, len, values);
+    result = jep_Util_boxLongs(env, array);
+    (*env)->DeleteLocalRef(env, array);
+    if (process_java_exception(env)) {
+        return NULL;
+    }
+    return result;
+}
+
+jobject JBox_Doubles(JNIEnv* env, const jdouble *values, jsize len)
+{
+    jobject      result;
+    jdoubleArray array = (*env)->NewDoubleArray(env, len);
+    if (!array) {
+        process_java_exception(env);
+        return NULL;
+    }
+    (*env)->SetDoubleArrayRegion(env, array, 0, len, values);
+    result = jep_Util_boxDoubles(env, array);
+    (*env)->DeleteLocalRef(env, array);
+    if (process_java_exception(env)) {
+        return NULL;
+    }
+    return result;
+}
+
+static void jbox_clear(JNIEnv *env, jobject *cache, int size)
+{
+    int i;
+    for (i = 0; i < size; i++) {
+        if (cache[i]) {
+            (*env)->DeleteGlobalRef(env, cache[i]);
+            cache[i] = NULL;
+        }
+    }
+}
+
+void JBox_ClearCache(JNIEnv* env)
+{
+    jbox_clear(env, booleanCache, 2);
+    jbox_clear(env, byteCache, JBOX_CACHE_SIZE);
+    jbox_clear(env, shortCache, JBOX_CACHE_SIZE);
+    jbox_clear(env, intCache, JBOX_CACHE_SIZE);
+    jbox_clear(env, longCache, JBOX_CACHE_SIZE);
+    jbox_clear(env, charCache, JBOX_CACHE_HIGH + 1);
+}
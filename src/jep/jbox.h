@@ -43,4 +43,14 @@ jobject JBox_Float(JNIEnv*, jfloat);
 jobject JBox_Double(JNIEnv*, jdouble);
 jobject JBox_Char(JNIEnv*, jchar);
 
+/*
+ * Box every value of a C array with a single call into java. Returns a new
+ * java.util.ArrayList of the boxed values or NULL with a python exception set.
+ */
+jobject JBox_Longs(JNIEnv*, const jlong*, jsize);
+jobject JBox_Doubles(JNIEnv*, const jdouble*, jsize);
+
+/* Delete the cached boxed values, called when jep is unloaded. */
+void JBox_ClearCache(JNIEnv*);
+
 #endif // ifndef _Included_jbox
@@ -36,6 +36,10 @@ BOOL APIENTRY DllMain(HANDLE hModule,
                       DWORD  ul_reason_for_call,
                       LPVOID lpReserved)
 {
+    // windows has no thread local destructors, see pyembed_get_env()
+    if (ul_reason_for_call == DLL_THREAD_DETACH) {
+        pyembed_detach_thread();
+    }
     return TRUE;
 }
 #endif
@@ -47,6 +51,7 @@ BOOL APIENTRY DllMain(HANDLE hModule,
 JNIEXPORT jint JNICALL
 JNI_OnLoad(JavaVM *vm, void *reserved)
 {
+    pyembed_set_jvm(vm);
     return JNI_VERSION_1_2;
 }
 
@@ -103,12 +108,19 @@ JNIEXPORT void JNICALL Java_jep_Jep_sharedImport
 /*
  * Class:     jep_Jep
  * Method:    init
- * Signature: (Ljava/lang/ClassLoader;Z)I
+ * Signature: (Ljava/lang/ClassLoader;ZIZLjava/lang/String;ZIZZ[Ljava/lang/String;Z)J
  */
 JNIEXPORT jlong JNICALL Java_jep_Jep_init
-(JNIEnv *env, jobject obj, jobject cl, jboolean hasSharedModules)
+(JNIEnv *env, jobject obj, jobject cl, jboolean hasSharedModules,
+ jint objectFreeListSize, jboolean lazyMembers, jstring metadataCacheFile,
+ jboolean identityCache, jint internCacheSize, jboolean classTypes,
+ jboolean adaptiveGIL, jobjectArray keepGILMethods, jboolean collectionViews)
 {
-    return pyembed_thread_init(env, cl, obj, hasSharedModules);
+    return pyembed_thread_init(env, cl, obj, hasSharedModules,
+                               objectFreeListSize, lazyMembers,
+                               metadataCacheFile, identityCache,
+                               internCacheSize, classTypes, adaptiveGIL,
+                               keepGILMethods, collectionViews);
 }
 
 
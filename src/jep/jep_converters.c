@@ -0,0 +1,650 @@
+/*
+   jep - Java Embedded Python
+
+   Copyright (c) 2017 JEP_AUTHORS.
+
+   This file is licensed under the the zlib/libpng License.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+   must not claim that you wrote the original software. If you use
+   this software in a product, an acknowledgment in the product
+   documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+   must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+
+#include "Jep.h"
+
+/*
+ * The classes that the converters need are found the first time they are
+ * needed instead of with the frequent classes because they are not in every
+ * JVM, java.util.function only exists since java 8 and java.sql is not in
+ * every java runtime.
+ */
+static jclass    functionType     = NULL;
+static jmethodID functionApply    = 0;
+static jmethodID bigDecimalInit   = 0;
+static jmethodID timestampValueOf = 0;
+
+
+static JepConverterRegistry* get_registry(void)
+{
+    JepThread *jepThread = pyembed_find_interpreter_jepthread();
+    return jepThread ? &jepThread->converters : NULL;
+}
+
+/* Returns 1 if the object is a PyJObject of a java.util.function.Function */
+static int is_java_function(JNIEnv *env, PyObject *obj)
+{
+    if (!PyJObject_Check(obj) || PyJClass_Check(obj)) {
+        return 0;
+    }
+    if (!functionType) {
+        jclass clazz = (*env)->FindClass(env, "java/util/function/Function");
+        if (!clazz) {
+            (*env)->ExceptionClear(env);
+            return 0;
+        }
+        functionApply = (*env)->GetMethodID(env, clazz, "apply",
+                                            "(Ljava/lang/Object;)Ljava/lang/Object;");
+        if (!functionApply) {
+            (*env)->ExceptionClear(env);
+            (*env)->DeleteLocalRef(env, clazz);
+            return 0;
+        }
+        functionType = (*env)->NewGlobalRef(env, clazz);
+        (*env)->DeleteLocalRef(env, clazz);
+    }
+    return (*env)->IsInstanceOf(env, ((PyJObject*) obj)->object, functionType);
+}
+
+static jobject apply_java_function(JNIEnv *env, PyObject *function,
+                                   jobject arg)
+{
+    jobject result;
+    Py_BEGIN_ALLOW_THREADS
+    result = (*env)->CallObjectMethod(env, ((PyJObject*) function)->object,
+                                      functionApply, arg);
+    Py_END_ALLOW_THREADS
+    if (process_java_exception(env)) {
+        return NULL;
+    }
+    return result;
+}
+
+
+/*
+ * The built in converters go through the string forms of the values, which
+ * the python and java classes both parse in native code.
+ */
+static jobject decimal_to_bigdecimal(JNIEnv *env, PyObject *obj, jclass clazz)
+{
+    PyObject *str;
+    jstring   jstr;
+    jobject   result = NULL;
+
+    if (!bigDecimalInit) {
+        bigDecimalInit = (*env)->GetMethodID(env, clazz, "<init>",
+                                             "(Ljava/lang/String;)V");
+        if (process_java_exception(env) || !bigDecimalInit) {
+            return NULL;
+        }
+    }
+    str = PyObject_Str(obj);
+    if (!str) {
+        return NULL;
+    }
+    jstr = PyObject_As_jstring(env, str);
+    Py_DECREF(str);
+    if (!jstr) {
+        return NULL;
+    }
+    result = (*env)->NewObject(env, clazz, bigDecimalInit, jstr);
+    (*env)->DeleteLocalRef(env, jstr);
+    if (process_java_exception(env)) {
+        return NULL;
+    }
+    return result;
+}
+
+static PyObject* bigdecimal_to_decimal(JNIEnv *env, PyTypeObject *pyType,
+                                       jobject val)
+{
+    PyObject *result;
+    PyObject *str = jobject_topystring(env, val);
+    if (!str) {
+        return NULL;
+    }
+    result = PyObject_CallFunctionObjArgs((PyObject*) pyType, str, NULL);
+    Py_DECREF(str);
+    return result;
+}
+
+/*
+ * The string form of a naive datetime is the format of Timestamp.valueOf(),
+ * a timezone cannot be represented by a Timestamp.
+ */
+static jobject datetime_to_timestamp(JNIEnv *env, PyObject *obj,
+                                     jclass clazz)
+{
+    PyObject *tzinfo;
+    PyObject *str;
+    jstring   jstr;
+    jobject   result;
+
+    tzinfo = PyObject_GetAttrString(obj, "tzinfo");
+    if (!tzinfo) {
+        return NULL;
+    }
+    Py_DECREF(tzinfo);
+    if (tzinfo != Py_None) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Cannot convert a datetime with a timezone to a Timestamp");
+        return NULL;
+    }
+    if (!timestampValueOf) {
+        timestampValueOf = (*env)->GetStaticMethodID(env, clazz, "valueOf",
+                           "(Ljava/lang/String;)Ljava/sql/Timestamp;");
+        if (process_java_exception(env) || !timestampValueOf) {
+            return NULL;
+        }
+    }
+    str = PyObject_Str(obj);
+    if (!str) {
+        return NULL;
+    }
+    jstr = PyObject_As_jstring(env, str);
+    Py_DECREF(str);
+    if (!jstr) {
+        return NULL;
+    }
+    result = (*env)->CallStaticObjectMethod(env, clazz, timestampValueOf, jstr);
+    (*env)->DeleteLocalRef(env, jstr);
+    if (process_java_exception(env)) {
+        return NULL;
+    }
+    return result;
+}
+
+/*
+ * Timestamp.toString() is yyyy-mm-dd hh:mm:ss.fffffffff with the trailing
+ * zeros of the nanoseconds removed, python only keeps microseconds.
+ */
+static PyObject* timestamp_to_datetime(JNIEnv *env, PyTypeObject *pyType,
+                                       jobject val)
+{
+    jstring     jstr;
+    const char *chars;
+    int         year, month, day, hour, minute, second;
+    int         micros = 0;
+    int         parsed, digits, i;
+    char        fraction[10] = "";
+
+    jstr = jobject_tostring(env, val);
+    if (process_java_exception(env) || !jstr) {
+        return NULL;
+    }
+    chars = (*env)->GetStringUTFChars(env, jstr, NULL);
+    if (!chars) {
+        (*env)->DeleteLocalRef(env, jstr);
+        process_java_exception(env);
+        return NULL;
+    }
+    parsed = sscanf(chars, "%d-%d-%d %d:%d:%d.%9[0-9]", &year, &month, &day,
+                    &hour, &minute, &second, fraction);
+    (*env)->ReleaseStringUTFChars(env, jstr, chars);
+    (*env)->DeleteLocalRef(env, jstr);
+    if (parsed < 6) {
+        PyErr_SetString(PyExc_ValueError, "Cannot parse the Timestamp");
+        return NULL;
+    }
+    digits = (int) strlen(fraction);
+    for (i = 0; i < 6; i++) {
+        micros = micros * 10 + (i < digits ? fraction[i] - '0' : 0);
+    }
+    return PyObject_CallFunction((PyObject*) pyType, "iiiiiii", year, month,
+                                 day, hour, minute, second, micros);
+}
+
+typedef struct {
+    const char      *module;    /* python module of the type */
+    const char      *type;      /* name of the type in the module */
+    const char      *className; /* JNI name of the java class */
+    JepToJavaFunc    toJava;
+    JepToPythonFunc  toPython;
+} JepBuiltinConverter;
+
+static JepBuiltinConverter builtinConverters[] = {
+    {
+        "decimal", "Decimal", "java/math/BigDecimal",
+        decimal_to_bigdecimal, bigdecimal_to_decimal
+    },
+    {
+        "datetime", "datetime", "java/sql/Timestamp",
+        datetime_to_timestamp, timestamp_to_datetime
+    },
+    { NULL }
+};
+
+
+static void converter_free(JNIEnv *env, JepConverter *converter)
+{
+    Py_XDECREF(converter->pyType);
+    Py_XDECREF(converter->toJava);
+    Py_XDECREF(converter->toPython);
+    if (converter->clazz) {
+        (*env)->DeleteGlobalRef(env, converter->clazz);
+    }
+    PyMem_Free(converter);
+}
+
+/* Called whenever the converters change */
+static void registry_changed(JepConverterRegistry *registry)
+{
+    registry->serial++;
+    Py_CLEAR(registry->typeCache);
+}
+
+int JepConverter_Remove(JNIEnv *env, PyTypeObject *pyType, jclass clazz)
+{
+    JepConverterRegistry *registry = get_registry();
+    JepConverter        **link;
+
+    if (!registry) {
+        return PyErr_Occurred() ? -1 : 0;
+    }
+    for (link = &registry->first; *link; link = &(*link)->next) {
+        JepConverter *converter = *link;
+        if (converter->pyType == pyType
+                && (*env)->IsSameObject(env, converter->clazz, clazz)) {
+            *link = converter->next;
+            registry_changed(registry);
+            converter_free(env, converter);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int JepConverter_Add(JNIEnv *env, PyTypeObject *pyType, jclass clazz,
+                     JepToJavaFunc toJavaFunc, JepToPythonFunc toPythonFunc,
+                     PyObject *toJava, PyObject *toPython)
+{
+    JepConverterRegistry *registry;
+    JepConverter         *converter;
+    JepConverter        **link;
+
+    JepThread            *jepThread;
+    int                   toJavaIsFunction, toPythonIsFunction;
+
+    toJavaIsFunction   = toJava && is_java_function(env, toJava);
+    toPythonIsFunction = toPython && is_java_function(env, toPython);
+    if (toJava && !toJavaIsFunction && !PyCallable_Check(toJava)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "toJava must be callable or a java.util.function.Function");
+        return -1;
+    }
+    if (toPython && !toPythonIsFunction && !PyCallable_Check(toPython)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "toPython must be callable or a java.util.function.Function");
+        return -1;
+    }
+    jepThread = pyembed_get_interpreter_jepthread();
+    if (!jepThread || JepConverter_Remove(env, pyType, clazz) < 0) {
+        return -1;
+    }
+    registry = &jepThread->converters;
+
+    converter = PyMem_Malloc(sizeof(JepConverter));
+    if (!converter) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    Py_INCREF(pyType);
+    Py_XINCREF(toJava);
+    Py_XINCREF(toPython);
+    converter->pyType             = pyType;
+    converter->clazz              = (*env)->NewGlobalRef(env, clazz);
+    converter->toJavaFunc         = toJavaFunc;
+    converter->toPythonFunc       = toPythonFunc;
+    converter->toJava             = toJava;
+    converter->toPython           = toPython;
+    converter->toJavaIsFunction   = toJavaIsFunction;
+    converter->toPythonIsFunction = toPythonIsFunction;
+    converter->next               = NULL;
+
+    /* earlier converters are preferred when more than one applies */
+    for (link = &registry->first; *link; link = &(*link)->next);
+    *link = converter;
+    registry_changed(registry);
+    return 0;
+}
+
+int JepConverter_AddBuiltin(JNIEnv *env, PyTypeObject *pyType, jclass clazz)
+{
+    JepBuiltinConverter *builtin;
+
+    for (builtin = builtinConverters; builtin->module; builtin++) {
+        PyObject *module, *type;
+        jclass    builtinClass;
+        int       same;
+
+        module = PyImport_ImportModule(builtin->module);
+        if (!module) {
+            return -1;
+        }
+        type = PyObject_GetAttrString(module, builtin->type);
+        Py_DECREF(module);
+        if (!type) {
+            return -1;
+        }
+        Py_DECREF(type);
+        if (type != (PyObject*) pyType) {
+            continue;
+        }
+
+        builtinClass = (*env)->FindClass(env, builtin->className);
+        if (!builtinClass) {
+            (*env)->ExceptionClear(env);
+            continue;
+        }
+        same = (*env)->IsSameObject(env, builtinClass, clazz);
+        (*env)->DeleteLocalRef(env, builtinClass);
+        if (same) {
+            return JepConverter_Add(env, pyType, clazz, builtin->toJava,
+                                    builtin->toPython, NULL, NULL);
+        }
+    }
+    PyErr_Format(PyExc_TypeError, "There is no built in converter for %s",
+                 pyType->tp_name);
+    return -1;
+}
+
+
+/*
+ * The converters to java that apply to a python type. The converter that was
+ * chosen for the last java type the python type was converted to is
+ * remembered, which is usually the type of the next conversion as well, so
+ * most conversions only compare the java type instead of searching.
+ */
+typedef struct {
+    jclass        lastType;      /* global ref to the last java type */
+    JepConverter *lastConverter; /* converter for lastType, or NULL */
+    JepConverter *converters[1]; /* NULL terminated */
+} JepTypeConverters;
+
+static void type_converters_capsule_free(PyObject *capsule)
+{
+    JepTypeConverters *entry = PyCapsule_GetPointer(capsule, NULL);
+    if (entry->lastType) {
+        JNIEnv *env = pyembed_get_env();
+        (*env)->DeleteGlobalRef(env, entry->lastType);
+    }
+    PyMem_Free(entry);
+}
+
+/*
+ * Get the converters to java that apply to a python type, or NULL if there
+ * are none. The result is cached in a dict until the converters change, the
+ * dict holds references to the types so it is emptied when it reaches
+ * JEP_CONVERTER_TYPE_CACHE_SIZE to not keep many short lived types alive.
+ * Returns -1 with a python exception set on error.
+ */
+static int get_type_converters(JepConverterRegistry *registry,
+                               PyTypeObject *pyType,
+                               JepTypeConverters **result)
+{
+    PyObject          *cached;
+    JepConverter      *converter;
+    JepTypeConverters *entry;
+    int                count = 0;
+
+    *result = NULL;
+    if (!registry->typeCache) {
+        registry->typeCache = PyDict_New();
+        if (!registry->typeCache) {
+            return -1;
+        }
+    }
+    cached = PyDict_GetItem(registry->typeCache, (PyObject*) pyType);
+    if (cached) {
+        if (cached != Py_None) {
+            *result = PyCapsule_GetPointer(cached, NULL);
+        }
+        return 0;
+    }
+    if (PyDict_Size(registry->typeCache) >= JEP_CONVERTER_TYPE_CACHE_SIZE) {
+        PyDict_Clear(registry->typeCache);
+    }
+
+    for (converter = registry->first; converter; converter = converter->next) {
+        if ((converter->toJavaFunc || converter->toJava)
+                && PyType_IsSubtype(pyType, converter->pyType)) {
+            count++;
+        }
+    }
+    if (count == 0) {
+        return PyDict_SetItem(registry->typeCache, (PyObject*) pyType, Py_None);
+    }
+    entry = PyMem_Malloc(sizeof(JepTypeConverters)
+                         + count * sizeof(JepConverter*));
+    if (!entry) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    entry->lastType      = NULL;
+    entry->lastConverter = NULL;
+    count = 0;
+    for (converter = registry->first; converter; converter = converter->next) {
+        if ((converter->toJavaFunc || converter->toJava)
+                && PyType_IsSubtype(pyType, converter->pyType)) {
+            entry->converters[count++] = converter;
+        }
+    }
+    entry->converters[count] = NULL;
+    cached = PyCapsule_New(entry, NULL, type_converters_capsule_free);
+    if (!cached) {
+        PyMem_Free(entry);
+        return -1;
+    }
+    count = PyDict_SetItem(registry->typeCache, (PyObject*) pyType, cached);
+    Py_DECREF(cached);
+    if (count == 0) {
+        *result = entry;
+    }
+    return count;
+}
+
+/* Find the converter of a python object for a java type, NULL if none apply */
+static JepConverter* find_java_converter(JNIEnv *env, PyObject *pyobject,
+        jclass expectedType)
+{
+    JepConverterRegistry *registry = get_registry();
+    JepTypeConverters    *entry;
+    JepConverter        **converters;
+
+    if (!registry || !registry->first) {
+        return NULL;
+    }
+    if (get_type_converters(registry, Py_TYPE(pyobject), &entry) != 0) {
+        /* the type is searched again next time */
+        PyErr_Clear();
+        return NULL;
+    }
+    if (!entry) {
+        return NULL;
+    }
+    if (entry->lastType
+            && (*env)->IsSameObject(env, entry->lastType, expectedType)) {
+        return entry->lastConverter;
+    }
+
+    if (entry->lastType) {
+        (*env)->DeleteGlobalRef(env, entry->lastType);
+    }
+    entry->lastType      = (*env)->NewGlobalRef(env, expectedType);
+    entry->lastConverter = NULL;
+    for (converters = entry->converters; *converters; converters++) {
+        if ((*env)->IsAssignableFrom(env, (*converters)->clazz, expectedType)) {
+            entry->lastConverter = *converters;
+            break;
+        }
+    }
+    return entry->lastConverter;
+}
+
+int JepConverter_GetSerial(void)
+{
+    JepConverterRegistry *registry = get_registry();
+    return registry ? registry->serial : 0;
+}
+
+int JepConverter_Matches(JNIEnv *env, PyObject *pyobject, jclass expectedType)
+{
+    return find_java_converter(env, pyobject, expectedType) != NULL;
+}
+
+int JepConverter_ToJava(JNIEnv *env, PyObject *pyobject, jclass expectedType,
+                        jobject *result)
+{
+    JepConverter *converter = find_java_converter(env, pyobject, expectedType);
+    PyObject     *toJava;
+    PyObject     *value;
+    jclass        clazz;
+
+    if (!converter) {
+        return 0;
+    }
+    *result = NULL;
+    if (converter->toJavaFunc) {
+        *result = converter->toJavaFunc(env, pyobject, converter->clazz);
+        return 1;
+    }
+
+    /* the converter can be removed while it runs */
+    toJava = converter->toJava;
+    clazz  = (*env)->NewLocalRef(env, converter->clazz);
+    Py_INCREF(toJava);
+    if (converter->toJavaIsFunction) {
+        /* java functions are given the string form of the object */
+        jstring jstr = NULL;
+        value = PyObject_Str(pyobject);
+        if (value) {
+            jstr = PyObject_As_jstring(env, value);
+            Py_DECREF(value);
+        }
+        if (jstr) {
+            *result = apply_java_function(env, toJava, jstr);
+            (*env)->DeleteLocalRef(env, jstr);
+            if (*result && !(*env)->IsInstanceOf(env, *result, clazz)) {
+                (*env)->DeleteLocalRef(env, *result);
+                *result = NULL;
+                PyErr_Format(PyExc_TypeError,
+                             "The converter of %s did not return the expected type",
+                             Py_TYPE(pyobject)->tp_name);
+            }
+        }
+    } else if (!Py_EnterRecursiveCall(" in a converter")) {
+        value = PyObject_CallFunctionObjArgs(toJava, pyobject, NULL);
+        if (value) {
+            *result = PyObject_As_jobject(env, value, clazz);
+            Py_DECREF(value);
+        }
+        Py_LeaveRecursiveCall();
+    }
+    Py_DECREF(toJava);
+    (*env)->DeleteLocalRef(env, clazz);
+    return 1;
+}
+
+PyObject* JepConverter_ToPython(JNIEnv *env, PyJClassInfoObject *info,
+                                jobject val)
+{
+    JepConverterRegistry *registry = get_registry();
+    JepConverter         *converter;
+    PyObject             *toPython;
+    PyObject             *pyType;
+    PyObject             *result = NULL;
+
+    if (!registry || !registry->first) {
+        return NULL;
+    }
+    if (info->converterSerial != registry->serial) {
+        info->converter = NULL;
+        for (converter = registry->first; converter; converter = converter->next) {
+            if ((converter->toPythonFunc || converter->toPython)
+                    && (*env)->IsAssignableFrom(env, info->clazz, converter->clazz)) {
+                info->converter = converter;
+                break;
+            }
+        }
+        info->converterSerial = registry->serial;
+    }
+    converter = info->converter;
+    if (!converter) {
+        return NULL;
+    }
+    if (converter->toPythonFunc) {
+        return converter->toPythonFunc(env, converter->pyType, val);
+    }
+
+    /* the converter can be removed while it runs */
+    toPython = converter->toPython;
+    pyType   = (PyObject*) converter->pyType;
+    Py_INCREF(toPython);
+    Py_INCREF(pyType);
+    if (Py_EnterRecursiveCall(" in a converter")) {
+        goto EXIT;
+    }
+    if (converter->toPythonIsFunction) {
+        /* the result is passed to the python type unless it is one already */
+        jobject value = apply_java_function(env, toPython, val);
+        if (!PyErr_Occurred()) {
+            result = convert_jobject_pyobject(env, value);
+            (*env)->DeleteLocalRef(env, value);
+        }
+        if (result && !PyObject_TypeCheck(result, (PyTypeObject*) pyType)) {
+            PyObject *converted = PyObject_CallFunctionObjArgs(pyType, result,
+                                  NULL);
+            Py_DECREF(result);
+            result = converted;
+        }
+    } else {
+        PyObject *pyjobject = PyJObject_New(env, val);
+        if (pyjobject) {
+            result = PyObject_CallFunctionObjArgs(toPython, pyjobject, NULL);
+            Py_DECREF(pyjobject);
+        }
+    }
+    Py_LeaveRecursiveCall();
+EXIT:
+    Py_DECREF(toPython);
+    Py_DECREF(pyType);
+    return result;
+}
+
+void JepConverter_ClearRegistry(JNIEnv *env, JepConverterRegistry *registry)
+{
+    JepConverter *converter = registry->first;
+
+    registry->first = NULL;
+    registry_changed(registry);
+    while (converter) {
+        JepConverter *next = converter->next;
+        converter_free(env, converter);
+        converter = next;
+    }
+}
@@ -0,0 +1,152 @@
+/*
+   jep - Java Embedded Python
+
+   Copyright (c) 2017 JEP_AUTHORS.
+
+   This file is licensed under the the zlib/libpng License.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+   must not claim that you wrote the original software. If you use
+   this software in a product, an acknowledgment in the product
+   documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+   must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+
+/*
+ * Contains a registry of converters between python types and java classes
+ * that jep does not convert by itself, such as decimal.Decimal and
+ * java.math.BigDecimal. Each JepThread has its own registry.
+ *
+ * A converter is registered for a pair of a python type and a java class and
+ * can convert in one or both directions. Python objects are converted to java
+ * when java expects the class of the converter or one of its supertypes, and
+ * java objects of the class or a subclass are converted to python. A
+ * conversion is done by a C function, a python callable or a java
+ * java.util.function.Function.
+ *
+ * Lookups are cached so the registry is not searched for every conversion.
+ * The converters that apply to a python type are cached in a bounded dict
+ * along with the converter chosen for the last java type the python type was
+ * converted to, so converting to a different java type than last time checks
+ * the cached converters again. The converter for a java class is cached in the
+ * descriptor of the class. Both caches are invalidated when a converter is
+ * added or removed.
+ */
+
+#include "jep_platform.h"
+
+#ifndef _Included_jep_converters
+#define _Included_jep_converters
+
+
+struct _PyJClassInfoObject;
+
+/*
+ * Converts a python object to an instance of the java class, returns a new
+ * local reference or NULL with a python exception set.
+ */
+typedef jobject (*JepToJavaFunc)(JNIEnv*, PyObject*, jclass);
+
+/*
+ * Converts a java object to an instance of the python type, returns a new
+ * reference or NULL with a python exception set.
+ */
+typedef PyObject* (*JepToPythonFunc)(JNIEnv*, PyTypeObject*, jobject);
+
+typedef struct _JepConverter {
+    PyTypeObject         *pyType;       /* the python type */
+    jclass                clazz;        /* global ref to the java class */
+    JepToJavaFunc         toJavaFunc;   /* C function, or NULL */
+    JepToPythonFunc       toPythonFunc; /* C function, or NULL */
+    PyObject             *toJava;       /* python callable or java Function,
+                                           or NULL */
+    PyObject             *toPython;     /* python callable or java Function,
+                                           or NULL */
+    int                   toJavaIsFunction;   /* toJava is a java Function */
+    int                   toPythonIsFunction; /* toPython is a java Function */
+    struct _JepConverter *next;         /* next converter in the registry */
+} JepConverter;
+
+/*
+ * The maximum number of python types in the cache of the converters that
+ * apply to each type, the cache is emptied when it is full.
+ */
+#define JEP_CONVERTER_TYPE_CACHE_SIZE 256
+
+typedef struct {
+    JepConverter *first;     /* converters in the order they were added */
+    int           serial;    /* changed whenever the converters change */
+    PyObject     *typeCache; /* dict of python types to a capsule of the
+                                converters to java that apply to the type,
+                                or None, lazily created and bounded */
+} JepConverterRegistry;
+
+/*
+ * Add a converter to the registry of the current JepThread, replacing any
+ * converter for the same pair. The functions and objects may be NULL when a
+ * direction is not supported, the objects are python callables or PyJObjects
+ * of a java.util.function.Function. Returns 0 on success or -1 with a python
+ * exception set.
+ */
+int JepConverter_Add(JNIEnv*, PyTypeObject*, jclass, JepToJavaFunc,
+                     JepToPythonFunc, PyObject*, PyObject*);
+
+/*
+ * Add the built in C converter for a pair, currently decimal.Decimal with
+ * java.math.BigDecimal and datetime.datetime with java.sql.Timestamp. Returns
+ * 0 on success or -1 with a python exception set, which is a TypeError when
+ * there is no built in converter for the pair.
+ */
+int JepConverter_AddBuiltin(JNIEnv*, PyTypeObject*, jclass);
+
+/*
+ * Remove the converter for a pair from the registry of the current JepThread.
+ * Returns 1 if it was removed, 0 if there was no converter for the pair or -1
+ * with a python exception set.
+ */
+int JepConverter_Remove(JNIEnv*, PyTypeObject*, jclass);
+
+/*
+ * Convert a python object with the registry of the current JepThread. Returns
+ * 1 if a converter applies and stores the new local reference in the last
+ * arg, which is NULL with a python exception set if the conversion failed.
+ * Returns 0 if no converter applies.
+ */
+int JepConverter_ToJava(JNIEnv*, PyObject*, jclass, jobject*);
+
+/*
+ * Get the serial of the converters of the current JepThread, which changes
+ * whenever a converter is added or removed. Anything that depends on the
+ * converters, like the choice between overloaded methods, can be cached until
+ * the serial changes.
+ */
+int JepConverter_GetSerial(void);
+
+/* Check if a converter of the current JepThread applies to a python object */
+int JepConverter_Matches(JNIEnv*, PyObject*, jclass);
+
+/*
+ * Convert a java object with the registry of the current JepThread, the
+ * descriptor must be for the class of the object. Returns a new reference, or
+ * NULL without an exception set if no converter applies.
+ */
+PyObject* JepConverter_ToPython(JNIEnv*, struct _PyJClassInfoObject*, jobject);
+
+/* Release all the converters in a registry. Hold the GIL before calling. */
+void JepConverter_ClearRegistry(JNIEnv*, JepConverterRegistry*);
+
+#endif // ndef _Included_jep_converters
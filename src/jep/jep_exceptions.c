@@ -418,7 +418,7 @@ int process_import_exception(JNIEnv *env)
         return 0;
     }
 
-    jepThread = pyembed_get_jepthread();
+    jepThread = pyembed_get_interpreter_jepthread();
     if (!jepThread) {
         printf("Error while processing a Java exception, "
                "invalid JepThread.\n");
@@ -483,10 +483,11 @@ int process_java_exception(JNIEnv *env)
         PyErr_Print();
     }
 
-    jepThread = pyembed_get_jepthread();
+    jepThread = pyembed_get_interpreter_jepthread();
     if (!jepThread) {
         printf("Error while processing a Java exception, "
                "invalid JepThread.\n");
+        (*env)->DeleteLocalRef(env, exception);
         return 1;
     }
 
@@ -497,6 +498,19 @@ int process_java_exception(JNIEnv *env)
     // we're already processing this one, clear the old
     (*env)->ExceptionClear(env);
 
+    /*
+     * Callers that convert only primitives do not push a local frame, so
+     * every local reference made while wrapping the exception is released
+     * here. Otherwise a loop that keeps catching java exceptions would fill
+     * the local reference table of the caller.
+     */
+    if ((*env)->PushLocalFrame(env, JLOCAL_REFS) != 0) {
+        (*env)->ExceptionClear(env);
+        (*env)->DeleteLocalRef(env, exception);
+        PyErr_NoMemory();
+        return 1;
+    }
+
     /*
      * Java does not fill in a stack trace until getStackTrace() is called. If
      * it is not called now then the stack trace can be lost so even though
@@ -506,6 +520,8 @@ int process_java_exception(JNIEnv *env)
     if ((*env)->ExceptionCheck(env)) {
         PyErr_Format(PyExc_RuntimeError,
                      "wrapping java exception in pyjobject failed.");
+        (*env)->PopLocalFrame(env, NULL);
+        (*env)->DeleteLocalRef(env, exception);
         return 1;
 
     }
@@ -517,11 +533,14 @@ int process_java_exception(JNIEnv *env)
     if ((*env)->ExceptionCheck(env) || !jpyExc) {
         PyErr_Format(PyExc_RuntimeError,
                      "wrapping java exception in pyjobject failed.");
+        (*env)->PopLocalFrame(env, NULL);
+        (*env)->DeleteLocalRef(env, exception);
         return 1;
     }
 
     PyErr_SetObject(pyExceptionType, jpyExc);
     Py_DECREF(jpyExc);
+    (*env)->PopLocalFrame(env, NULL);
     (*env)->DeleteLocalRef(env, exception);
     return 1;
 }
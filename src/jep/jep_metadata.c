@@ -0,0 +1,1440 @@
+/*
+   jep - Java Embedded Python
+
+   Copyright (c) 2017 JEP AUTHORS.
+
+   This file is licensed under the the zlib/libpng License.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+   must not claim that you wrote the original software. If you use
+   this software in a product, an acknowledgment in the product
+   documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+   must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+#include "Jep.h"
+
+#ifdef WIN32
+    #include <process.h>
+    #define getpid _getpid
+#endif
+
+/* The initial number of buckets, the table doubles in size when it fills. */
+#define METADATA_INITIAL_SIZE 256
+
+/* The first line of a metadata file, changes if the format changes. */
+#define METADATA_FILE_HEADER "jep metadata 1"
+
+static JepClassMetadata **buckets     = NULL;
+static int                bucketsSize = 0;
+static int                classCount  = 0;
+
+
+/* Copy a string into a malloc'd string, NULL if out of memory. */
+static char* jep_metadata_strdup(const char *str)
+{
+    char *copy = malloc(strlen(str) + 1);
+    if (copy) {
+        strcpy(copy, str);
+    }
+    return copy;
+}
+
+
+/*
+ * Copy a java string into a malloc'd modified UTF-8 string. Returns NULL on
+ * failure without setting a python exception.
+ */
+static char* jep_metadata_utf(JNIEnv *env, jstring str)
+{
+    const char *chars;
+    char       *copy;
+
+    chars = (*env)->GetStringUTFChars(env, str, NULL);
+    if (!chars) {
+        return NULL;
+    }
+    copy = jep_metadata_strdup(chars);
+    (*env)->ReleaseStringUTFChars(env, str, chars);
+    return copy;
+}
+
+
+/* Same as jep_metadata_utf() but sets a python exception on failure. */
+static char* jep_metadata_name(JNIEnv *env, jstring jname)
+{
+    char *name = jep_metadata_utf(env, jname);
+    if (!name && !process_java_exception(env)) {
+        PyErr_NoMemory();
+    }
+    return name;
+}
+
+
+static int jep_metadata_is_static(JNIEnv *env, jobject member)
+{
+    jint modifier = java_lang_reflect_Member_getModifiers(env, member);
+    if (process_java_exception(env)) {
+        return -1;
+    }
+    if (java_lang_reflect_Modifier_isStatic(env, modifier) == JNI_TRUE) {
+        return 1;
+    }
+    if (process_java_exception(env)) {
+        return -1;
+    }
+    return 0;
+}
+
+
+/*
+ * Fill in the metadata of a java.lang.reflect.Method. Returns 1 if successful
+ * or 0 with a python exception set. A partially filled in method must still
+ * be released with jep_metadata_free_method().
+ */
+static int jep_metadata_init_method(JNIEnv *env, jobject rmethod,
+                                    JepMethodMetadata *method)
+{
+    jstring      jname      = NULL;
+    jclass       returnType = NULL;
+    jobjectArray paramArray = NULL;
+    int          pos;
+
+    jname = java_lang_reflect_Member_getName(env, rmethod);
+    if (process_java_exception(env) || !jname) {
+        return 0;
+    }
+    method->name = jep_metadata_name(env, jname);
+    (*env)->DeleteLocalRef(env, jname);
+    if (!method->name) {
+        return 0;
+    }
+
+    method->methodId = (*env)->FromReflectedMethod(env, rmethod);
+    method->overloads = 1;
+
+    returnType = java_lang_reflect_Method_getReturnType(env, rmethod);
+    if (process_java_exception(env) || !returnType) {
+        return 0;
+    }
+    method->returnTypeId = get_jtype(env, returnType);
+    method->returnType   = (*env)->NewWeakGlobalRef(env, returnType);
+    (*env)->DeleteLocalRef(env, returnType);
+    if (process_java_exception(env)) {
+        return 0;
+    }
+
+    method->isStatic = jep_metadata_is_static(env, rmethod);
+    if (method->isStatic < 0) {
+        return 0;
+    }
+
+    paramArray = java_lang_reflect_Method_getParameterTypes(env, rmethod);
+    if (process_java_exception(env) || !paramArray) {
+        return 0;
+    }
+    method->lenParameters = (*env)->GetArrayLength(env, paramArray);
+    if (method->lenParameters > 0) {
+        method->parameters = calloc(method->lenParameters,
+                                    sizeof(JepParameterMetadata));
+        if (!method->parameters) {
+            method->lenParameters = 0;
+            (*env)->DeleteLocalRef(env, paramArray);
+            PyErr_NoMemory();
+            return 0;
+        }
+    }
+    for (pos = 0; pos < method->lenParameters; pos++) {
+        jclass paramType = (jclass) (*env)->GetObjectArrayElement(env,
+                           paramArray, pos);
+        if (process_java_exception(env) || !paramType) {
+            (*env)->DeleteLocalRef(env, paramArray);
+            return 0;
+        }
+        method->parameters[pos].typeId = get_jtype(env, paramType);
+        method->parameters[pos].type   = (*env)->NewWeakGlobalRef(env, paramType);
+        (*env)->DeleteLocalRef(env, paramType);
+        if (process_java_exception(env)) {
+            (*env)->DeleteLocalRef(env, paramArray);
+            return 0;
+        }
+    }
+    (*env)->DeleteLocalRef(env, paramArray);
+    return 1;
+}
+
+
+/*
+ * Fill in the metadata of a java.lang.reflect.Field. Returns 1 if successful
+ * or 0 with a python exception set.
+ */
+static int jep_metadata_init_field(JNIEnv *env, jobject rfield,
+                                   JepFieldMetadata *field)
+{
+    jstring jname     = NULL;
+    jclass  fieldType = NULL;
+
+    jname = java_lang_reflect_Member_getName(env, rfield);
+    if (process_java_exception(env) || !jname) {
+        return 0;
+    }
+    field->name = jep_metadata_name(env, jname);
+    (*env)->DeleteLocalRef(env, jname);
+    if (!field->name) {
+        return 0;
+    }
+
+    field->fieldId = (*env)->FromReflectedField(env, rfield);
+
+    fieldType = java_lang_reflect_Field_getType(env, rfield);
+    if (process_java_exception(env) || !fieldType) {
+        return 0;
+    }
+    field->fieldTypeId = get_jtype(env, fieldType);
+    field->fieldType   = (*env)->NewWeakGlobalRef(env, fieldType);
+    (*env)->DeleteLocalRef(env, fieldType);
+    if (process_java_exception(env)) {
+        return 0;
+    }
+
+    field->isStatic = jep_metadata_is_static(env, rfield);
+    return field->isStatic >= 0;
+}
+
+
+static void jep_metadata_free_class(JNIEnv *env, JepClassMetadata *meta)
+{
+    int i, pos;
+
+    for (i = 0; i < meta->lenMethods; i++) {
+        JepMethodMetadata *method = &meta->methods[i];
+        for (pos = 0; pos < method->lenParameters; pos++) {
+            if (method->parameters[pos].type) {
+                (*env)->DeleteWeakGlobalRef(env, method->parameters[pos].type);
+            }
+        }
+        free(method->parameters);
+        if (method->returnType) {
+            (*env)->DeleteWeakGlobalRef(env, method->returnType);
+        }
+        free(method->signature);
+        free(method->name);
+    }
+    free(meta->methods);
+
+    for (i = 0; i < meta->lenFields; i++) {
+        if (meta->fields[i].fieldType) {
+            (*env)->DeleteWeakGlobalRef(env, meta->fields[i].fieldType);
+        }
+        free(meta->fields[i].signature);
+        free(meta->fields[i].name);
+    }
+    free(meta->fields);
+    free(meta->name);
+    free(meta->fingerprint);
+
+    if (meta->clazz) {
+        (*env)->DeleteWeakGlobalRef(env, meta->clazz);
+    }
+    free(meta);
+}
+
+
+/*
+ * Sort the methods by name so overloads are adjacent and count the overloads
+ * of each name. This is an insertion sort because it is stable, which keeps
+ * the overloads in the order reflection returned them.
+ */
+static void jep_metadata_group_methods(JepClassMetadata *meta)
+{
+    int i, j, start;
+
+    for (i = 1; i < meta->lenMethods; i++) {
+        JepMethodMetadata method = meta->methods[i];
+        for (j = i; j > 0 && strcmp(meta->methods[j - 1].name, method.name) > 0;
+                j--) {
+            meta->methods[j] = meta->methods[j - 1];
+        }
+        meta->methods[j] = method;
+    }
+
+    for (start = 0; start < meta->lenMethods; start = i) {
+        for (i = start + 1; i < meta->lenMethods
+                && strcmp(meta->methods[i].name, meta->methods[start].name) == 0;
+                i++) {
+        }
+        for (j = start; j < i; j++) {
+            meta->methods[j].overloads = i - start;
+        }
+    }
+}
+
+
+/* Reflect on a class to build its metadata, NULL with an exception on error. */
+static JepClassMetadata* jep_metadata_new_class(JNIEnv *env, jclass clazz,
+        jint hash)
+{
+    JepClassMetadata *meta        = NULL;
+    jobjectArray      methodArray = NULL;
+    jobjectArray      fieldArray  = NULL;
+    int               i, len;
+
+    meta = calloc(1, sizeof(JepClassMetadata));
+    if (!meta) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    meta->hash = hash;
+
+    if ((*env)->PushLocalFrame(env, JLOCAL_REFS) != 0) {
+        process_java_exception(env);
+        free(meta);
+        return NULL;
+    }
+
+    methodArray = java_lang_Class_getMethods(env, clazz);
+    if (process_java_exception(env) || !methodArray) {
+        goto EXIT_ERROR;
+    }
+    len = (*env)->GetArrayLength(env, methodArray);
+    if (len > 0) {
+        meta->methods = calloc(len, sizeof(JepMethodMetadata));
+        if (!meta->methods) {
+            PyErr_NoMemory();
+            goto EXIT_ERROR;
+        }
+    }
+    for (i = 0; i < len; i++) {
+        jobject rmethod = (*env)->GetObjectArrayElement(env, methodArray, i);
+        meta->lenMethods = i + 1;
+        if (!jep_metadata_init_method(env, rmethod, &meta->methods[i])) {
+            goto EXIT_ERROR;
+        }
+        (*env)->DeleteLocalRef(env, rmethod);
+    }
+    jep_metadata_group_methods(meta);
+
+    fieldArray = java_lang_Class_getFields(env, clazz);
+    if (process_java_exception(env) || !fieldArray) {
+        goto EXIT_ERROR;
+    }
+    len = (*env)->GetArrayLength(env, fieldArray);
+    if (len > 0) {
+        meta->fields = calloc(len, sizeof(JepFieldMetadata));
+        if (!meta->fields) {
+            PyErr_NoMemory();
+            goto EXIT_ERROR;
+        }
+    }
+    for (i = 0; i < len; i++) {
+        jobject rfield = (*env)->GetObjectArrayElement(env, fieldArray, i);
+        meta->lenFields = i + 1;
+        if (!jep_metadata_init_field(env, rfield, &meta->fields[i])) {
+            goto EXIT_ERROR;
+        }
+        (*env)->DeleteLocalRef(env, rfield);
+    }
+
+    meta->clazz = (*env)->NewWeakGlobalRef(env, clazz);
+    (*env)->PopLocalFrame(env, NULL);
+    return meta;
+
+EXIT_ERROR:
+    (*env)->PopLocalFrame(env, NULL);
+    jep_metadata_free_class(env, meta);
+    if (!PyErr_Occurred()) {
+        PyErr_SetString(PyExc_RuntimeError, "Unknown");
+    }
+    return NULL;
+}
+
+
+/*
+ * The classes of a file written by JepMetadata_Save(). The whole file is read
+ * into recordBuffer and the records point into it. The class records are
+ * sorted by name and the members of each class are contiguous in
+ * memberRecords.
+ */
+typedef struct {
+    char  kind;              /* 'M' for a method or 'F' for a field */
+    int   isStatic;
+    char *name;
+    char *signature;
+} JepMemberRecord;
+
+typedef struct {
+    char            *name;
+    char            *fingerprint;
+    JepMemberRecord *members;
+    int              lenMembers;
+    int              used;   /* set once the record is resolved or stale */
+} JepClassRecord;
+
+static int              recordsLoaded   = 0;
+static char            *recordBuffer    = NULL;
+static JepClassRecord  *classRecords    = NULL;
+static int              lenClassRecords = 0;
+static JepMemberRecord *memberRecords   = NULL;
+
+
+/* Check if the descriptor between start and end is the same as desc. */
+static int jep_metadata_descriptor_is(const char *start, const char *end,
+                                      const char *desc)
+{
+    size_t len = end - start;
+    return strlen(desc) == len && strncmp(start, desc, len) == 0;
+}
+
+
+/*
+ * Get the type id of the JNI type descriptor at the start of desc and advance
+ * desc past it. Returns -1 if the descriptor is invalid.
+ */
+static int jep_metadata_descriptor_type(const char **desc)
+{
+    const char *start  = *desc;
+    const char *end    = start + 1;
+    int         typeId = -1;
+
+    switch (*start) {
+    case 'Z':
+        typeId = JBOOLEAN_ID;
+        break;
+    case 'B':
+        typeId = JBYTE_ID;
+        break;
+    case 'C':
+        typeId = JCHAR_ID;
+        break;
+    case 'S':
+        typeId = JSHORT_ID;
+        break;
+    case 'I':
+        typeId = JINT_ID;
+        break;
+    case 'J':
+        typeId = JLONG_ID;
+        break;
+    case 'F':
+        typeId = JFLOAT_ID;
+        break;
+    case 'D':
+        typeId = JDOUBLE_ID;
+        break;
+    case 'V':
+        typeId = JVOID_ID;
+        break;
+    case 'L':
+        end = strchr(start, ';');
+        if (!end) {
+            return -1;
+        }
+        end++;
+        if (jep_metadata_descriptor_is(start, end, "Ljava/lang/String;")) {
+            typeId = JSTRING_ID;
+        } else if (jep_metadata_descriptor_is(start, end, "Ljava/lang/Class;")) {
+            typeId = JCLASS_ID;
+        } else {
+            typeId = JOBJECT_ID;
+        }
+        break;
+    case '[':
+        while (*end == '[') {
+            end++;
+        }
+        if (*end == 'L') {
+            end = strchr(end, ';');
+            if (!end) {
+                return -1;
+            }
+        } else if (!*end) {
+            return -1;
+        }
+        end++;
+        typeId = JARRAY_ID;
+        break;
+    default:
+        return -1;
+    }
+    *desc = end;
+    return typeId;
+}
+
+
+/*
+ * Find the class of the JNI type descriptor between start and end. Classes
+ * that are not cached by Jep are found with the ClassLoader of context.
+ * Returns a new local reference or NULL with a java exception set.
+ */
+static jclass jep_metadata_descriptor_class(JNIEnv *env, jclass context,
+        const char *start, const char *end)
+{
+    jclass  cached = NULL;
+    jclass  result = NULL;
+    jstring jname  = NULL;
+    char   *name;
+    size_t  i, len;
+
+    if (end - start == 1) {
+        switch (*start) {
+        case 'Z':
+            cached = JBOOLEAN_TYPE;
+            break;
+        case 'B':
+            cached = JBYTE_TYPE;
+            break;
+        case 'C':
+            cached = JCHAR_TYPE;
+            break;
+        case 'S':
+            cached = JSHORT_TYPE;
+            break;
+        case 'I':
+            cached = JINT_TYPE;
+            break;
+        case 'J':
+            cached = JLONG_TYPE;
+            break;
+        case 'F':
+            cached = JFLOAT_TYPE;
+            break;
+        case 'D':
+            cached = JDOUBLE_TYPE;
+            break;
+        case 'V':
+            cached = JVOID_TYPE;
+            break;
+        }
+    } else if (jep_metadata_descriptor_is(start, end, "Ljava/lang/String;")) {
+        cached = JSTRING_TYPE;
+    } else if (jep_metadata_descriptor_is(start, end, "Ljava/lang/Object;")) {
+        cached = JOBJECT_TYPE;
+    } else if (jep_metadata_descriptor_is(start, end, "Ljava/lang/Class;")) {
+        cached = JCLASS_TYPE;
+    } else if (jep_metadata_descriptor_is(start, end, "[I")) {
+        cached = JINT_ARRAY_TYPE;
+    } else if (jep_metadata_descriptor_is(start, end, "[B")) {
+        cached = JBYTE_ARRAY_TYPE;
+    } else if (jep_metadata_descriptor_is(start, end, "[D")) {
+        cached = JDOUBLE_ARRAY_TYPE;
+    }
+    if (cached) {
+        return (jclass) (*env)->NewLocalRef(env, cached);
+    }
+
+    /* Class.forName() uses dots, and the L and ; only within arrays */
+    if (*start == 'L') {
+        start++;
+        end--;
+    }
+    len  = end - start;
+    name = malloc(len + 1);
+    if (!name) {
+        return NULL;
+    }
+    for (i = 0; i < len; i++) {
+        name[i] = start[i] == '/' ? '.' : start[i];
+    }
+    name[len] = '\0';
+    jname = (*env)->NewStringUTF(env, name);
+    free(name);
+    if (!jname) {
+        return NULL;
+    }
+    result = jep_Util_forName(env, context, jname);
+    (*env)->DeleteLocalRef(env, jname);
+    return result;
+}
+
+
+/*
+ * Get the type of the JNI type descriptor at the start of desc and advance desc
+ * past it. If type is not NULL it is set to a weak global reference to the
+ * class of the descriptor. Returns 1 if successful, or 0 if the descriptor is
+ * invalid or the class cannot be found.
+ */
+static int jep_metadata_parse_type(JNIEnv *env, jclass context,
+                                   const char **desc, jweak *type, int *typeId)
+{
+    const char *start = *desc;
+    jclass      clazz;
+
+    *typeId = jep_metadata_descriptor_type(desc);
+    if (*typeId < 0) {
+        return 0;
+    }
+    if (type) {
+        clazz = jep_metadata_descriptor_class(env, context, start, *desc);
+        if (!clazz) {
+            return 0;
+        }
+        *type = (*env)->NewWeakGlobalRef(env, clazz);
+        (*env)->DeleteLocalRef(env, clazz);
+    }
+    return 1;
+}
+
+
+/*
+ * Fill in the parameters and return type of a method from its signature.
+ * Returns 1 if successful or 0 if the signature could not be resolved.
+ */
+static int jep_metadata_parse_method(JNIEnv *env, jclass clazz,
+                                     JepMethodMetadata *method)
+{
+    const char *desc = method->signature;
+    const char *scan;
+    int         count = 0;
+    int         pos;
+
+    if (*desc++ != '(') {
+        return 0;
+    }
+    for (scan = desc; *scan != ')'; count++) {
+        if (jep_metadata_descriptor_type(&scan) < 0) {
+            return 0;
+        }
+    }
+    if (count > 0) {
+        method->parameters = calloc(count, sizeof(JepParameterMetadata));
+        if (!method->parameters) {
+            return 0;
+        }
+        method->lenParameters = count;
+    }
+    for (pos = 0; pos < count; pos++) {
+        if (!jep_metadata_parse_type(env, clazz, &desc,
+                                     &method->parameters[pos].type,
+                                     &method->parameters[pos].typeId)) {
+            return 0;
+        }
+    }
+    desc++;
+    return jep_metadata_parse_type(env, clazz, &desc, NULL,
+                                   &method->returnTypeId);
+}
+
+
+/*
+ * Build the metadata of a class from a record in a metadata file, resolving
+ * every member with GetMethodID() or GetFieldID(). Returns NULL without an
+ * exception if the record does not match the class, or NULL with a python
+ * exception set on any other error.
+ */
+static JepClassMetadata* jep_metadata_from_record(JNIEnv *env, jclass clazz,
+        jint hash, JepClassRecord *record)
+{
+    JepClassMetadata *meta = NULL;
+    int               i, lenMethods = 0, lenFields = 0;
+
+    meta = calloc(1, sizeof(JepClassMetadata));
+    if (!meta) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    meta->hash = hash;
+
+    for (i = 0; i < record->lenMembers; i++) {
+        if (record->members[i].kind == 'M') {
+            lenMethods++;
+        } else {
+            lenFields++;
+        }
+    }
+    if ((lenMethods && !(meta->methods = calloc(lenMethods,
+                                         sizeof(JepMethodMetadata))))
+            || (lenFields && !(meta->fields = calloc(lenFields,
+                                              sizeof(JepFieldMetadata))))) {
+        jep_metadata_free_class(env, meta);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    if ((*env)->PushLocalFrame(env, JLOCAL_REFS) != 0) {
+        jep_metadata_free_class(env, meta);
+        process_java_exception(env);
+        return NULL;
+    }
+
+    for (i = 0; i < record->lenMembers; i++) {
+        JepMemberRecord *member = &record->members[i];
+        if (member->kind == 'M') {
+            JepMethodMetadata *method = &meta->methods[meta->lenMethods++];
+            method->isStatic  = member->isStatic;
+            method->overloads = 1;
+            method->name      = jep_metadata_strdup(member->name);
+            method->signature = jep_metadata_strdup(member->signature);
+            if (!method->name || !method->signature) {
+                goto EXIT_STALE;
+            }
+            if (method->isStatic) {
+                method->methodId = (*env)->GetStaticMethodID(env, clazz,
+                                   method->name, method->signature);
+            } else {
+                method->methodId = (*env)->GetMethodID(env, clazz, method->name,
+                                                       method->signature);
+            }
+            if (!method->methodId
+                    || !jep_metadata_parse_method(env, clazz, method)) {
+                goto EXIT_STALE;
+            }
+        } else {
+            JepFieldMetadata *field = &meta->fields[meta->lenFields++];
+            const char       *desc;
+
+            field->isStatic  = member->isStatic;
+            field->name      = jep_metadata_strdup(member->name);
+            field->signature = jep_metadata_strdup(member->signature);
+            if (!field->name || !field->signature) {
+                goto EXIT_STALE;
+            }
+            if (field->isStatic) {
+                field->fieldId = (*env)->GetStaticFieldID(env, clazz,
+                                 field->name, field->signature);
+            } else {
+                field->fieldId = (*env)->GetFieldID(env, clazz, field->name,
+                                                    field->signature);
+            }
+            desc = field->signature;
+            if (!field->fieldId
+                    || !jep_metadata_parse_type(env, clazz, &desc,
+                                                &field->fieldType,
+                                                &field->fieldTypeId)) {
+                goto EXIT_STALE;
+            }
+        }
+    }
+    jep_metadata_group_methods(meta);
+
+    meta->clazz = (*env)->NewWeakGlobalRef(env, clazz);
+    (*env)->PopLocalFrame(env, NULL);
+    return meta;
+
+EXIT_STALE:
+    /*
+     * Members that no longer exist throw NoSuchMethodError or
+     * NoSuchFieldError, which only means the class is reflected on instead.
+     */
+    (*env)->ExceptionClear(env);
+    (*env)->PopLocalFrame(env, NULL);
+    jep_metadata_free_class(env, meta);
+    return NULL;
+}
+
+
+static int jep_metadata_compare_records(const void *a, const void *b)
+{
+    return strcmp(((const JepClassRecord*) a)->name,
+                  ((const JepClassRecord*) b)->name);
+}
+
+
+/*
+ * Build the metadata of a class from a metadata file if the file has a record
+ * of the class with the same fingerprint. Returns NULL without an exception if
+ * there is no usable record, or NULL with a python exception set on error.
+ */
+static JepClassMetadata* jep_metadata_from_file(JNIEnv *env, jclass clazz,
+        jint hash)
+{
+    JepClassMetadata *meta        = NULL;
+    JepClassRecord    key;
+    JepClassRecord   *record      = NULL;
+    jstring           jstr        = NULL;
+    char             *name        = NULL;
+    char             *fingerprint = NULL;
+
+    if (lenClassRecords == 0) {
+        return NULL;
+    }
+
+    jstr = java_lang_Class_getName(env, clazz);
+    if (process_java_exception(env) || !jstr) {
+        return NULL;
+    }
+    name = jep_metadata_name(env, jstr);
+    (*env)->DeleteLocalRef(env, jstr);
+    if (!name) {
+        return NULL;
+    }
+
+    key.name = name;
+    record = bsearch(&key, classRecords, lenClassRecords,
+                     sizeof(JepClassRecord), jep_metadata_compare_records);
+    if (!record) {
+        free(name);
+        return NULL;
+    }
+
+    jstr = jep_Util_getFingerprint(env, clazz);
+    if (process_java_exception(env) || !jstr) {
+        free(name);
+        return NULL;
+    }
+    fingerprint = jep_metadata_name(env, jstr);
+    (*env)->DeleteLocalRef(env, jstr);
+    if (!fingerprint) {
+        free(name);
+        return NULL;
+    }
+
+    /* there can be several classes with the same name */
+    while (record > classRecords && strcmp(record[-1].name, name) == 0) {
+        record--;
+    }
+    for (; record < classRecords + lenClassRecords
+            && strcmp(record->name, name) == 0; record++) {
+        if (record->used) {
+            continue;
+        }
+        if (strcmp(record->fingerprint, fingerprint) != 0) {
+            /* the class has changed, it will be saved again when reflected */
+            record->used = 1;
+            continue;
+        }
+        record->used = 1;
+        meta = jep_metadata_from_record(env, clazz, hash, record);
+        break;
+    }
+
+    if (meta) {
+        meta->name        = name;
+        meta->fingerprint = fingerprint;
+    } else {
+        free(name);
+        free(fingerprint);
+    }
+    return meta;
+}
+
+
+/*
+ * Find the metadata of a class in the table. The metadata of any class in the
+ * same bucket that has been unloaded is released along the way.
+ */
+static JepClassMetadata* jep_metadata_lookup(JNIEnv *env, jclass clazz,
+        jint hash)
+{
+    JepClassMetadata **link;
+    JepClassMetadata  *meta;
+
+    if (!buckets) {
+        return NULL;
+    }
+
+    link = &buckets[hash & (bucketsSize - 1)];
+    while ((meta = *link) != NULL) {
+        if (meta->hash == hash && (*env)->IsSameObject(env, meta->clazz, clazz)) {
+            return meta;
+        }
+        if ((*env)->IsSameObject(env, meta->clazz, NULL)) {
+            *link = meta->next;
+            jep_metadata_free_class(env, meta);
+            classCount--;
+        } else {
+            link = &meta->next;
+        }
+    }
+    return NULL;
+}
+
+
+/* Double the number of buckets, returns 0 on failure. */
+static int jep_metadata_grow(void)
+{
+    JepClassMetadata **newBuckets;
+    int                newSize = bucketsSize ? bucketsSize * 2 : METADATA_INITIAL_SIZE;
+    int                i;
+
+    newBuckets = calloc(newSize, sizeof(JepClassMetadata*));
+    if (!newBuckets) {
+        return 0;
+    }
+    for (i = 0; i < bucketsSize; i++) {
+        JepClassMetadata *meta = buckets[i];
+        while (meta) {
+            JepClassMetadata *next = meta->next;
+            meta->next = newBuckets[meta->hash & (newSize - 1)];
+            newBuckets[meta->hash & (newSize - 1)] = meta;
+            meta = next;
+        }
+    }
+    free(buckets);
+    buckets     = newBuckets;
+    bucketsSize = newSize;
+    return 1;
+}
+
+
+JepClassMetadata* JepMetadata_FindClass(JNIEnv *env, jclass clazz, jint hash)
+{
+    return jep_metadata_lookup(env, clazz, hash);
+}
+
+
+JepClassMetadata* JepMetadata_GetClass(JNIEnv *env, jclass clazz, jint hash)
+{
+    JepClassMetadata *meta;
+    JepClassMetadata *existing;
+    int               index;
+
+    meta = jep_metadata_lookup(env, clazz, hash);
+    if (meta) {
+        return meta;
+    }
+
+    meta = jep_metadata_from_file(env, clazz, hash);
+    if (!meta) {
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+        meta = jep_metadata_new_class(env, clazz, hash);
+        if (!meta) {
+            return NULL;
+        }
+    }
+
+    /*
+     * The GIL is released during the reflection so another thread may have
+     * added the same class in the meantime.
+     */
+    existing = jep_metadata_lookup(env, clazz, hash);
+    if (existing) {
+        jep_metadata_free_class(env, meta);
+        return existing;
+    }
+
+    if (classCount >= bucketsSize && !jep_metadata_grow()) {
+        jep_metadata_free_class(env, meta);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    index = hash & (bucketsSize - 1);
+    meta->next     = buckets[index];
+    buckets[index] = meta;
+    classCount++;
+    return meta;
+}
+
+
+JepMethodMetadata* JepMetadata_FindMethod(JepClassMetadata *meta,
+        const char *name)
+{
+    int low  = 0;
+    int high = meta->lenMethods - 1;
+
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        int cmp = strcmp(meta->methods[mid].name, name);
+        if (cmp < 0) {
+            low = mid + 1;
+        } else if (cmp > 0) {
+            high = mid - 1;
+        } else {
+            /* back up to the first overload */
+            while (mid > 0 && strcmp(meta->methods[mid - 1].name, name) == 0) {
+                mid--;
+            }
+            return &meta->methods[mid];
+        }
+    }
+    return NULL;
+}
+
+
+JepFieldMetadata* JepMetadata_FindField(JepClassMetadata *meta,
+                                        const char *name)
+{
+    int i;
+    /* the last field with a name hides the others, like in the attr dict */
+    for (i = meta->lenFields - 1; i >= 0; i--) {
+        if (strcmp(meta->fields[i].name, name) == 0) {
+            return &meta->fields[i];
+        }
+    }
+    return NULL;
+}
+
+
+/* Split a line into at most maxFields tab separated fields. */
+static int jep_metadata_split(char *line, char **fields, int maxFields)
+{
+    int count = 0;
+
+    fields[count++] = line;
+    while (count < maxFields && (line = strchr(line, '\t')) != NULL) {
+        *line++ = '\0';
+        fields[count++] = line;
+    }
+    return count;
+}
+
+
+/*
+ * Find the end of the line that starts at line, which is the next newline or
+ * end. If terminate is set the line is terminated in place and a carriage
+ * return before the newline is removed too. Returns the start of the next
+ * line. Both passes of JepMetadata_Load() step through the buffer with this so
+ * they always see the same lines, even if the file has NULs.
+ */
+static char* jep_metadata_next_line(char *line, char *end, int terminate)
+{
+    char *newline = memchr(line, '\n', end - line);
+
+    if (!newline) {
+        /* the buffer has a NUL at end */
+        return end;
+    }
+    if (terminate) {
+        *newline = '\0';
+        if (newline > line && newline[-1] == '\r') {
+            newline[-1] = '\0';
+        }
+    }
+    return newline + 1;
+}
+
+
+int JepMetadata_Load(const char *path)
+{
+    FILE           *file;
+    long            size;
+    char           *buffer, *first, *line, *next, *end;
+    int             lenClasses = 0, lenMembers = 0, usedMembers = 0;
+    JepClassRecord *record     = NULL;
+
+    if (recordsLoaded) {
+        return 1;
+    }
+    recordsLoaded = 1;
+
+    file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0
+            || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return 0;
+    }
+    buffer = malloc(size + 1);
+    if (!buffer) {
+        fclose(file);
+        return 0;
+    }
+    if (fread(buffer, 1, size, file) != (size_t) size) {
+        free(buffer);
+        fclose(file);
+        return 0;
+    }
+    fclose(file);
+    buffer[size] = '\0';
+    end = buffer + size;
+
+    first = jep_metadata_next_line(buffer, end, 1);
+    if (strcmp(buffer, METADATA_FILE_HEADER) != 0) {
+        free(buffer);
+        return 0;
+    }
+
+    /* count the records */
+    for (line = first; line < end; line = next) {
+        next = jep_metadata_next_line(line, end, 0);
+        if (line[0] == 'C') {
+            lenClasses++;
+        } else if (line[0] == 'M' || line[0] == 'F') {
+            lenMembers++;
+        }
+    }
+
+    classRecords  = calloc(lenClasses + 1, sizeof(JepClassRecord));
+    memberRecords = calloc(lenMembers + 1, sizeof(JepMemberRecord));
+    if (!classRecords || !memberRecords) {
+        free(classRecords);
+        free(memberRecords);
+        classRecords  = NULL;
+        memberRecords = NULL;
+        free(buffer);
+        return 0;
+    }
+
+    /* split the lines in place, never more records than were counted */
+    for (line = first; line < end; line = next) {
+        char *fields[4];
+        int   count;
+
+        next  = jep_metadata_next_line(line, end, 1);
+        count = jep_metadata_split(line, fields, 4);
+        if (count == 3 && strcmp(fields[0], "C") == 0
+                && lenClassRecords < lenClasses) {
+            record = &classRecords[lenClassRecords++];
+            record->name        = fields[1];
+            record->fingerprint = fields[2];
+            record->members     = &memberRecords[usedMembers];
+        } else if (record && count == 4 && (strcmp(fields[0], "M") == 0
+                                            || strcmp(fields[0], "F") == 0)
+                   && usedMembers < lenMembers) {
+            JepMemberRecord *member = &memberRecords[usedMembers++];
+            member->kind      = fields[0][0];
+            member->isStatic  = fields[1][0] == '1';
+            member->name      = fields[2];
+            member->signature = fields[3];
+            record->lenMembers++;
+        } else if (record && line[0]) {
+            /* a damaged record is never used or saved again */
+            record->used = 1;
+        }
+    }
+
+    qsort(classRecords, lenClassRecords, sizeof(JepClassRecord),
+          jep_metadata_compare_records);
+    recordBuffer = buffer;
+    return 1;
+}
+
+
+/* A growable string for building JNI signatures. */
+typedef struct {
+    char   *data;
+    size_t  length;
+    size_t  capacity;
+} JepMetadataString;
+
+
+static int jep_metadata_append(JepMetadataString *str, const char *chars,
+                               size_t len)
+{
+    if (str->length + len + 1 > str->capacity) {
+        size_t capacity = (str->length + len + 1) * 2;
+        char  *data     = realloc(str->data, capacity);
+        if (!data) {
+            return 0;
+        }
+        str->data     = data;
+        str->capacity = capacity;
+    }
+    memcpy(str->data + str->length, chars, len);
+    str->length += len;
+    str->data[str->length] = '\0';
+    return 1;
+}
+
+
+/*
+ * Append the JNI type descriptor of a class to a string. The type is a weak
+ * global reference and is only used for object types. Returns 0 on failure,
+ * possibly with a java exception set.
+ */
+static int jep_metadata_append_descriptor(JNIEnv *env, JepMetadataString *str,
+        jweak type, int typeId)
+{
+    const char *primitive = NULL;
+    jclass      clazz;
+    jstring     jname;
+    char       *name;
+    size_t      i;
+    int         result;
+
+    switch (typeId) {
+    case JBOOLEAN_ID:
+        primitive = "Z";
+        break;
+    case JBYTE_ID:
+        primitive = "B";
+        break;
+    case JCHAR_ID:
+        primitive = "C";
+        break;
+    case JSHORT_ID:
+        primitive = "S";
+        break;
+    case JINT_ID:
+        primitive = "I";
+        break;
+    case JLONG_ID:
+        primitive = "J";
+        break;
+    case JFLOAT_ID:
+        primitive = "F";
+        break;
+    case JDOUBLE_ID:
+        primitive = "D";
+        break;
+    case JVOID_ID:
+        primitive = "V";
+        break;
+    case JSTRING_ID:
+        primitive = "Ljava/lang/String;";
+        break;
+    case JCLASS_ID:
+        primitive = "Ljava/lang/Class;";
+        break;
+    }
+    if (primitive) {
+        return jep_metadata_append(str, primitive, strlen(primitive));
+    }
+
+    clazz = (jclass) (*env)->NewLocalRef(env, type);
+    if (!clazz) {
+        return 0;
+    }
+    jname = java_lang_Class_getName(env, clazz);
+    (*env)->DeleteLocalRef(env, clazz);
+    if (!jname) {
+        return 0;
+    }
+    name = jep_metadata_utf(env, jname);
+    (*env)->DeleteLocalRef(env, jname);
+    if (!name) {
+        return 0;
+    }
+    for (i = 0; name[i]; i++) {
+        if (name[i] == '.') {
+            name[i] = '/';
+        }
+    }
+    if (name[0] == '[') {
+        result = jep_metadata_append(str, name, strlen(name));
+    } else {
+        result = jep_metadata_append(str, "L", 1)
+                 && jep_metadata_append(str, name, strlen(name))
+                 && jep_metadata_append(str, ";", 1);
+    }
+    free(name);
+    return result;
+}
+
+
+/*
+ * Fill in the name, fingerprint and member signatures of reflected metadata
+ * so it can be saved. Returns 0 on failure, possibly with a java exception
+ * set.
+ */
+static int jep_metadata_describe_class(JNIEnv *env, jclass clazz,
+                                       JepClassMetadata *meta)
+{
+    JepMetadataString str;
+    jstring           jstr;
+    char             *chars;
+    int               i, pos, ok;
+
+    if (!meta->name) {
+        jstr = java_lang_Class_getName(env, clazz);
+        if (!jstr) {
+            return 0;
+        }
+        chars = jep_metadata_utf(env, jstr);
+        (*env)->DeleteLocalRef(env, jstr);
+        if (!chars) {
+            return 0;
+        }
+        /* the GIL was released so another thread may have done the same */
+        if (meta->name) {
+            free(chars);
+        } else {
+            meta->name = chars;
+        }
+    }
+
+    if (!meta->fingerprint) {
+        jstr = jep_Util_getFingerprint(env, clazz);
+        if (!jstr) {
+            return 0;
+        }
+        chars = jep_metadata_utf(env, jstr);
+        (*env)->DeleteLocalRef(env, jstr);
+        if (!chars) {
+            return 0;
+        }
+        if (meta->fingerprint) {
+            free(chars);
+        } else {
+            meta->fingerprint = chars;
+        }
+    }
+
+    for (i = 0; i < meta->lenMethods; i++) {
+        JepMethodMetadata *method = &meta->methods[i];
+        if (method->signature) {
+            continue;
+        }
+        memset(&str, 0, sizeof(str));
+        ok = jep_metadata_append(&str, "(", 1);
+        for (pos = 0; ok && pos < method->lenParameters; pos++) {
+            ok = jep_metadata_append_descriptor(env, &str,
+                                                method->parameters[pos].type,
+                                                method->parameters[pos].typeId);
+        }
+        ok = ok && jep_metadata_append(&str, ")", 1)
+             && jep_metadata_append_descriptor(env, &str, method->returnType,
+                     method->returnTypeId);
+        if (!ok) {
+            free(str.data);
+            return 0;
+        }
+        if (method->signature) {
+            free(str.data);
+        } else {
+            method->signature = str.data;
+        }
+    }
+
+    for (i = 0; i < meta->lenFields; i++) {
+        JepFieldMetadata *field = &meta->fields[i];
+        if (field->signature) {
+            continue;
+        }
+        memset(&str, 0, sizeof(str));
+        if (!jep_metadata_append_descriptor(env, &str, field->fieldType,
+                                            field->fieldTypeId)) {
+            free(str.data);
+            return 0;
+        }
+        if (field->signature) {
+            free(str.data);
+        } else {
+            field->signature = str.data;
+        }
+    }
+    return 1;
+}
+
+
+int JepMetadata_Save(JNIEnv *env, const char *path)
+{
+    JepClassMetadata **snapshot = NULL;
+    jclass            *classes  = NULL;
+    int                lenSnapshot = 0;
+    char              *tmpPath  = NULL;
+    FILE              *file     = NULL;
+    int                i, j, result = 0;
+
+    snapshot = malloc(sizeof(JepClassMetadata*) * (classCount + 1));
+    classes  = malloc(sizeof(jclass) * (classCount + 1));
+    tmpPath  = malloc(strlen(path) + 32);
+    if (!snapshot || !classes || !tmpPath) {
+        goto EXIT;
+    }
+    if ((*env)->PushLocalFrame(env, classCount + JLOCAL_REFS) != 0) {
+        (*env)->ExceptionClear(env);
+        goto EXIT;
+    }
+
+    /*
+     * Hold a strong reference to every class so none of them is unloaded, and
+     * its metadata released, while the GIL is released to describe them.
+     */
+    for (i = 0; i < bucketsSize; i++) {
+        JepClassMetadata *meta;
+        for (meta = buckets[i]; meta; meta = meta->next) {
+            jclass clazz = (jclass) (*env)->NewLocalRef(env, meta->clazz);
+            if (clazz) {
+                snapshot[lenSnapshot] = meta;
+                classes[lenSnapshot]  = clazz;
+                lenSnapshot++;
+            }
+        }
+    }
+    for (i = 0; i < lenSnapshot; i++) {
+        if (!jep_metadata_describe_class(env, classes[i], snapshot[i])) {
+            /* the class is left out, it will be reflected on next time */
+            (*env)->ExceptionClear(env);
+            snapshot[i] = NULL;
+        }
+    }
+
+    /* write a new file and replace the old one so readers never see half */
+    sprintf(tmpPath, "%s.%d.tmp", path, (int) getpid());
+    file = fopen(tmpPath, "wb");
+    if (!file) {
+        (*env)->PopLocalFrame(env, NULL);
+        goto EXIT;
+    }
+    fprintf(file, "%s\n", METADATA_FILE_HEADER);
+    for (i = 0; i < lenSnapshot; i++) {
+        JepClassMetadata *meta = snapshot[i];
+        if (!meta) {
+            continue;
+        }
+        fprintf(file, "C\t%s\t%s\n", meta->name, meta->fingerprint);
+        for (j = 0; j < meta->lenMethods; j++) {
+            fprintf(file, "M\t%d\t%s\t%s\n", meta->methods[j].isStatic,
+                    meta->methods[j].name, meta->methods[j].signature);
+        }
+        for (j = 0; j < meta->lenFields; j++) {
+            fprintf(file, "F\t%d\t%s\t%s\n", meta->fields[j].isStatic,
+                    meta->fields[j].name, meta->fields[j].signature);
+        }
+    }
+    for (i = 0; i < lenClassRecords; i++) {
+        JepClassRecord *record = &classRecords[i];
+        if (record->used) {
+            continue;
+        }
+        fprintf(file, "C\t%s\t%s\n", record->name, record->fingerprint);
+        for (j = 0; j < record->lenMembers; j++) {
+            fprintf(file, "%c\t%d\t%s\t%s\n", record->members[j].kind,
+                    record->members[j].isStatic, record->members[j].name,
+                    record->members[j].signature);
+        }
+    }
+    (*env)->PopLocalFrame(env, NULL);
+
+    if (fclose(file) != 0) {
+        remove(tmpPath);
+        goto EXIT;
+    }
+#ifdef WIN32
+    remove(path);
+#endif
+    if (rename(tmpPath, path) != 0) {
+        remove(tmpPath);
+        goto EXIT;
+    }
+    result = 1;
+
+EXIT:
+    free(snapshot);
+    free(classes);
+    free(tmpPath);
+    return result;
+}
+
+void JepMetadata_Clear(JNIEnv *env)
+{
+    int i;
+
+    for (i = 0; i < bucketsSize; i++) {
+        JepClassMetadata *meta = buckets[i];
+        while (meta) {
+            JepClassMetadata *next = meta->next;
+            jep_metadata_free_class(env, meta);
+            meta = next;
+        }
+    }
+    free(buckets);
+    buckets     = NULL;
+    bucketsSize = 0;
+    classCount  = 0;
+
+    free(classRecords);
+    free(memberRecords);
+    free(recordBuffer);
+    classRecords    = NULL;
+    memberRecords   = NULL;
+    recordBuffer    = NULL;
+    lenClassRecords = 0;
+}
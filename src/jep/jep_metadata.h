@@ -0,0 +1,139 @@
+/*
+   jep - Java Embedded Python
+
+   Copyright (c) 2017 JEP AUTHORS.
+
+   This file is licensed under the the zlib/libpng License.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+   must not claim that you wrote the original software. If you use
+   this software in a product, an acknowledgment in the product
+   documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+   must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+/*
+ * Contains a process wide store of metadata about the public methods and
+ * fields of java classes. Reflecting on a class is the same for every
+ * interpreter so the results are kept independent of any interpreter and
+ * each interpreter only builds its own python wrappers, see
+ * PyJMethod_NewFromMetadata() and PyJField_NewFromMetadata().
+ *
+ * The store only holds weak global references so it does not keep classes
+ * from being unloaded, the metadata of unloaded classes is released when it
+ * is found during a lookup. The python wrappers hold their own global
+ * references to everything they use. Every interpreter shares the same GIL
+ * and the store must only be used while holding it.
+ *
+ * The store can also be saved to a file and loaded by a later process. The
+ * members of a class are then resolved from their recorded JNI signatures
+ * with GetMethodID() and GetFieldID() instead of java.lang.reflect, as long
+ * as the class was loaded from the same place, see jep.Util.getFingerprint().
+ */
+
+#include "jep_platform.h"
+
+#ifndef _Included_jep_metadata
+#define _Included_jep_metadata
+
+
+typedef struct {
+    jweak                 type;          /* the class of the parameter */
+    int                   typeId;        /* type id of the parameter */
+} JepParameterMetadata;
+
+typedef struct {
+    char                 *name;          /* modified UTF-8 name */
+    jmethodID             methodId;
+    int                   returnTypeId;  /* type id of the return type */
+    int                   isStatic;
+    int                   lenParameters;
+    JepParameterMetadata *parameters;
+    int                   overloads;     /* number of methods with this name */
+    jweak                 returnType;    /* NULL if loaded from a file */
+    char                 *signature;     /* JNI signature, NULL until saved */
+} JepMethodMetadata;
+
+typedef struct {
+    char                 *name;          /* modified UTF-8 name */
+    jfieldID              fieldId;
+    jweak                 fieldType;     /* the class of the field */
+    int                   fieldTypeId;   /* type id of the field */
+    int                   isStatic;
+    char                 *signature;     /* JNI signature, NULL until saved */
+} JepFieldMetadata;
+
+/*
+ * The public members of a class. Methods are sorted by name so all the
+ * overloads of a method are adjacent, in the order they were returned by
+ * Class.getMethods().
+ */
+typedef struct _JepClassMetadata {
+    jweak                 clazz;
+    jint                  hash;          /* System.identityHashCode(clazz) */
+    int                   lenMethods;
+    JepMethodMetadata    *methods;
+    int                   lenFields;
+    JepFieldMetadata     *fields;
+    char                 *name;          /* class name, NULL until saved */
+    char                 *fingerprint;   /* NULL until saved */
+    struct _JepClassMetadata *next;      /* next class in the same bucket */
+} JepClassMetadata;
+
+/*
+ * Get the metadata of a class, reflecting on the class if this is the first
+ * time it is used by any interpreter. The hash must be the identity hash code
+ * of the class. Returns NULL with a python exception set on failure.
+ */
+JepClassMetadata* JepMetadata_GetClass(JNIEnv*, jclass, jint);
+
+/*
+ * Get the metadata of a class if it has already been created. Returns NULL
+ * without setting an exception if it has not.
+ */
+JepClassMetadata* JepMetadata_FindClass(JNIEnv*, jclass, jint);
+
+/*
+ * Find the first method with a name in the metadata of a class, the other
+ * overloads of the method follow it. Returns NULL if there is no method with
+ * the name.
+ */
+JepMethodMetadata* JepMetadata_FindMethod(JepClassMetadata*, const char*);
+
+/*
+ * Find a field by name in the metadata of a class, NULL if there is none. If
+ * several fields have the name the last one is returned.
+ */
+JepFieldMetadata* JepMetadata_FindField(JepClassMetadata*, const char*);
+
+/*
+ * Load a file written by JepMetadata_Save(), classes in the file are used
+ * when they are first needed. Only the first file is loaded, later calls do
+ * nothing. A missing or invalid file is ignored since it will be written when
+ * the interpreter is closed. Returns 0 if the file could not be read.
+ */
+int JepMetadata_Load(const char*);
+
+/*
+ * Write all the metadata, including any classes loaded from a file that have
+ * not been used, to a file. Returns 0 if the file could not be written.
+ */
+int JepMetadata_Save(JNIEnv*, const char*);
+
+/* Release all metadata, only used when the JVM is shutting down Jep. */
+void JepMetadata_Clear(JNIEnv*);
+
+#endif // ndef jep_metadata
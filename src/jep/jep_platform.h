@@ -88,6 +88,7 @@
 
         /* Python 3 separated Strings into PyBytes and PyUnicode */
         #define PyString_FromString(str)          PyUnicode_FromString(str)
+        #define PyString_FromStringAndSize(str, len) PyUnicode_FromStringAndSize(str, len)
         #define PyString_Check(str)               PyUnicode_Check(str)
         #define PyString_FromFormat(fmt, ...)     PyUnicode_FromFormat(fmt, ##__VA_ARGS__)
 
@@ -95,8 +96,39 @@
         #define PyString_AS_STRING(str)           PyUnicode_AsUTF8(str)
         #define PyString_Size(str)                PyUnicode_GetLength(str)
         #define PyString_GET_SIZE(str)            PyUnicode_GET_LENGTH(str)
+        #define PyString_InternInPlace(str)       PyUnicode_InternInPlace(str)
 
     #endif // Python 3 compatibility
 
+    /*
+     * Python 3.8 added the vectorcall protocol from PEP 590 which allows
+     * callables to receive their arguments as a C array instead of a tuple.
+     * JEP_VECTORCALL is 1 when it is available and JEP_TPFLAGS_METHOD should
+     * be used in the tp_flags of types that wrap java methods so they can be
+     * called that way and behave like unbound methods when they are found on
+     * a type. JEP_TPFLAGS_VECTORCALL is for other callable types that set
+     * tp_vectorcall_offset.
+     */
+    #if PY_VERSION_HEX >= 0x03080000
+        #define JEP_VECTORCALL 1
+
+        /* offsetof is needed to fill in tp_vectorcall_offset */
+        #include <stddef.h>
+
+        #ifndef Py_TPFLAGS_HAVE_VECTORCALL
+            #define Py_TPFLAGS_HAVE_VECTORCALL _Py_TPFLAGS_HAVE_VECTORCALL
+        #endif
+        #if PY_VERSION_HEX < 0x03090000
+            #define PyObject_Vectorcall _PyObject_Vectorcall
+        #endif
+
+        #define JEP_TPFLAGS_VECTORCALL Py_TPFLAGS_HAVE_VECTORCALL
+        #define JEP_TPFLAGS_METHOD     (Py_TPFLAGS_HAVE_VECTORCALL | Py_TPFLAGS_METHOD_DESCRIPTOR)
+    #else
+        #define JEP_VECTORCALL 0
+        #define JEP_TPFLAGS_VECTORCALL 0
+        #define JEP_TPFLAGS_METHOD     0
+    #endif // vectorcall
+
 
 #endif // ifndef _Included_jep_platform
@@ -87,6 +87,11 @@ jclass JMODIFIER_TYPE    = NULL;
 jclass JARRAYLIST_TYPE   = NULL;
 jclass JHASHMAP_TYPE     = NULL;
 jclass JCOLLECTIONS_TYPE = NULL;
+jclass JSYSTEM_TYPE      = NULL;
+jclass JPROXY_TYPE       = NULL;
+jclass JEP_UTIL_TYPE     = NULL;
+jclass JEP_LISTVIEW_TYPE = NULL;
+jclass JEP_MAPVIEW_TYPE  = NULL;
 #if JEP_NUMPY_ENABLED
     jclass JEP_NDARRAY_TYPE = NULL;
     jclass JEP_DNDARRAY_TYPE = NULL;
@@ -336,6 +341,11 @@ int cache_frequent_classes(JNIEnv *env)
     CACHE_CLASS(JARRAYLIST_TYPE, "java/util/ArrayList");
     CACHE_CLASS(JHASHMAP_TYPE, "java/util/HashMap");
     CACHE_CLASS(JCOLLECTIONS_TYPE, "java/util/Collections");
+    CACHE_CLASS(JSYSTEM_TYPE, "java/lang/System");
+    CACHE_CLASS(JPROXY_TYPE, "java/lang/reflect/Proxy");
+    CACHE_CLASS(JEP_UTIL_TYPE, "jep/Util");
+    CACHE_CLASS(JEP_LISTVIEW_TYPE, "jep/python/PyListView");
+    CACHE_CLASS(JEP_MAPVIEW_TYPE, "jep/python/PyMapView");
 
 #if JEP_NUMPY_ENABLED
     CACHE_CLASS(JEP_NDARRAY_TYPE, "jep/NDArray");
@@ -391,6 +401,11 @@ void unref_cache_frequent_classes(JNIEnv *env)
     UNCACHE_CLASS(JARRAYLIST_TYPE);
     UNCACHE_CLASS(JHASHMAP_TYPE);
     UNCACHE_CLASS(JCOLLECTIONS_TYPE);
+    UNCACHE_CLASS(JSYSTEM_TYPE);
+    UNCACHE_CLASS(JPROXY_TYPE);
+    UNCACHE_CLASS(JEP_UTIL_TYPE);
+    UNCACHE_CLASS(JEP_LISTVIEW_TYPE);
+    UNCACHE_CLASS(JEP_MAPVIEW_TYPE);
 
 #if JEP_NUMPY_ENABLED
     UNCACHE_CLASS(JEP_NDARRAY_TYPE);
@@ -541,6 +556,65 @@ int get_jtype(JNIEnv *env, jclass clazz)
 }
 
 
+/*
+ * Returns the type id of the component of an array of a numeric primitive
+ * type, like JDOUBLE_ID for double[], or -1 for any other class. These are
+ * the arrays that lists and tuples of numbers can be converted to.
+ */
+int get_numeric_array_jtype(JNIEnv *env, jclass clazz)
+{
+    if ((*env)->IsSameObject(env, clazz, JDOUBLE_ARRAY_TYPE)) {
+        return JDOUBLE_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JFLOAT_ARRAY_TYPE)) {
+        return JFLOAT_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JLONG_ARRAY_TYPE)) {
+        return JLONG_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JINT_ARRAY_TYPE)) {
+        return JINT_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JSHORT_ARRAY_TYPE)) {
+        return JSHORT_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JBYTE_ARRAY_TYPE)) {
+        return JBYTE_ID;
+    }
+    return -1;
+}
+
+
+/*
+ * Determines how well a list or tuple matches a numeric primitive array. The
+ * first item is matched against the component type so the arrays are ranked
+ * the same way as the primitive types of a single number, which also puts
+ * them above every other match of a list or tuple. Sequences that are empty or
+ * do not start with a number do not match. Only the first item is checked so
+ * choosing a method does not scan the sequence, the sequence is expected to
+ * hold numbers of one type and any other item fails when it is converted.
+ */
+static int pyseq_matches_numeric_array(JNIEnv *env, PyObject *param,
+                                       jclass paramType)
+{
+    PyObject *first;
+    int       number;
+    int       componentTypeId;
+
+    if (PySequence_Fast_GET_SIZE(param) == 0) {
+        return 0;
+    }
+    first  = PySequence_Fast_GET_ITEM(param, 0);
+    number = PyLong_Check(first) || PyFloat_Check(first);
+#if PY_MAJOR_VERSION < 3
+    number = number || PyInt_Check(first);
+#endif
+    if (!number || PyBool_Check(first)) {
+        return 0;
+    }
+    componentTypeId = get_numeric_array_jtype(env, paramType);
+    if (componentTypeId < 0) {
+        return 0;
+    }
+    return pyarg_matches_jtype(env, first, paramType, componentTypeId);
+}
+
+
 /*
  * Determines how well a parameter matches the expected type. For example a
  * python integer can be passed to java as a bool, int, long, or
@@ -728,12 +802,15 @@ int pyarg_matches_jtype(JNIEnv *env,
         switch (paramTypeId) {
         case JBOOLEAN_ID:
             return 1;
+        case JARRAY_ID:
+            return pyseq_matches_numeric_array(env, param, paramType);
         case JOBJECT_ID:
             if ((*env)->IsSameObject(env, JOBJECT_TYPE, paramType)) {
                 return 2;
             } else if ((*env)->IsSameObject(env, JARRAYLIST_TYPE, paramType)) {
                 return 4;
-            } else if ((*env)->IsAssignableFrom(env, JLIST_TYPE, paramType)) {
+            } else if ((*env)->IsAssignableFrom(env, JLIST_TYPE, paramType)
+                       || (*env)->IsSameObject(env, JEP_LISTVIEW_TYPE, paramType)) {
                 return 3;
             }
         }
@@ -741,10 +818,13 @@ int pyarg_matches_jtype(JNIEnv *env,
         switch (paramTypeId) {
         case JBOOLEAN_ID:
             return 1;
+        case JARRAY_ID:
+            return pyseq_matches_numeric_array(env, param, paramType);
         case JOBJECT_ID:
             if ((*env)->IsSameObject(env, JOBJECT_TYPE, paramType)) {
                 return 2;
-            } else if ((*env)->IsAssignableFrom(env, JLIST_TYPE, paramType)) {
+            } else if ((*env)->IsAssignableFrom(env, JLIST_TYPE, paramType)
+                       || (*env)->IsSameObject(env, JEP_LISTVIEW_TYPE, paramType)) {
                 return 3;
             }
         }
@@ -755,16 +835,155 @@ int pyarg_matches_jtype(JNIEnv *env,
         case JOBJECT_ID:
             if ((*env)->IsSameObject(env, JOBJECT_TYPE, paramType)) {
                 return 2;
-            } else if ((*env)->IsAssignableFrom(env, JMAP_TYPE, paramType)) {
+            } else if ((*env)->IsAssignableFrom(env, JMAP_TYPE, paramType)
+                       || (*env)->IsSameObject(env, JEP_MAPVIEW_TYPE, paramType)) {
                 return 3;
             }
         }
+    } else if ((paramTypeId == JOBJECT_ID || paramTypeId == JSTRING_ID)
+               && JepConverter_Matches(env, param, paramType)) {
+        /* only types that are not converted above use the converters */
+        return 2;
     }
     // no match
     return 0;
 }
 
 
+#if PY_MAJOR_VERSION >= 3
+/*
+ * Build a python string from UTF-16 data. Strings without surrogate pairs are
+ * copied directly into the narrowest PEP 393 kind that fits, which for most
+ * strings is one byte per character, instead of going through the UTF-16
+ * decoder. The loops only use simple bitwise operations so that compilers can
+ * vectorize them.
+ */
+static PyObject* jchars_To_PyObject(const jchar *str, jsize size)
+{
+    PyObject *result;
+    jchar     any        = 0;
+    int       surrogates = 0;
+    jsize     i;
+
+    for (i = 0; i < size; i++) {
+        any        |= str[i];
+        surrogates |= (str[i] & 0xF800) == 0xD800;
+    }
+
+    if (any < 0x100) {
+        /* ASCII or Latin-1, every bit of any is set by some character */
+        Py_UCS1 *data;
+        result = PyUnicode_New(size, any);
+        if (!result) {
+            return NULL;
+        }
+        data = PyUnicode_1BYTE_DATA(result);
+        for (i = 0; i < size; i++) {
+            data[i] = (Py_UCS1) str[i];
+        }
+    } else if (!surrogates) {
+        result = PyUnicode_New(size, 0xFFFF);
+        if (!result) {
+            return NULL;
+        }
+        memcpy(PyUnicode_2BYTE_DATA(result), str, size * sizeof(jchar));
+    } else {
+        /* use native order explicitly so a leading U+FEFF is not a BOM */
+        int byteorder = PY_BIG_ENDIAN ? 1 : -1;
+        result = PyUnicode_DecodeUTF16((const char*) str, size * 2, NULL,
+                                       &byteorder);
+    }
+    return result;
+}
+
+
+/*
+ * Get the python string for some UTF-16 characters from an intern cache,
+ * converting and adding it on a miss.
+ */
+static PyObject* intern_cache_get(JepInternCache *cache, const jchar *str,
+                                  jsize size)
+{
+    JepInternEntry *entry;
+    PyObject       *result;
+    unsigned int    hash = 2166136261u;
+    jsize           i;
+
+    if (!cache->entries) {
+        cache->entries = PyMem_Malloc(sizeof(JepInternEntry) * cache->size);
+        if (!cache->entries) {
+            /* the cache is only an optimization */
+            cache->size = 0;
+            return jchars_To_PyObject(str, size);
+        }
+        memset(cache->entries, 0, sizeof(JepInternEntry) * cache->size);
+    }
+
+    /* FNV-1a */
+    for (i = 0; i < size; i++) {
+        hash = (hash ^ str[i]) * 16777619u;
+    }
+    entry = &cache->entries[hash & (cache->size - 1)];
+    if (entry->str && entry->hash == hash
+            && PyUnicode_GET_LENGTH(entry->str) == size) {
+        int   kind = PyUnicode_KIND(entry->str);
+        void *data = PyUnicode_DATA(entry->str);
+        for (i = 0; i < size; i++) {
+            if (PyUnicode_READ(kind, data, i) != str[i]) {
+                break;
+            }
+        }
+        if (i == size) {
+            cache->hits += 1;
+            Py_INCREF(entry->str);
+            return entry->str;
+        }
+    }
+
+    cache->misses += 1;
+    result = jchars_To_PyObject(str, size);
+    if (!result) {
+        return NULL;
+    }
+    PyUnicode_InternInPlace(&result);
+    Py_XDECREF(entry->str);
+    Py_INCREF(result);
+    entry->str  = result;
+    entry->hash = hash;
+    return result;
+}
+#endif
+
+
+void init_intern_cache(JepInternCache *cache, int size)
+{
+    cache->entries = NULL;
+    cache->size    = 0;
+    cache->hits    = 0;
+    cache->misses  = 0;
+    if (size > 0) {
+        cache->size = 1;
+        while (cache->size < size && cache->size < (1 << 20)) {
+            cache->size <<= 1;
+        }
+    }
+}
+
+
+void clear_intern_cache(JepInternCache *cache)
+{
+    int i;
+    if (cache->entries) {
+        for (i = 0; i < cache->size; i++) {
+            Py_XDECREF(cache->entries[i].str);
+        }
+        PyMem_Free(cache->entries);
+        cache->entries = NULL;
+    }
+    cache->size = 0;
+}
+
+
 PyObject* jstring_To_PyObject(JNIEnv *env, jobject jstr)
 {
     PyObject* result;
@@ -793,10 +1012,35 @@ PyObject* jstring_To_PyObject(JNIEnv *env, jobject jstr)
     (*env)->ReleaseByteArrayElements(env, stringJbytes, stringBytes, JNI_ABORT);
     (*env)->DeleteLocalRef(env, stringJbytes);
 #else
-    const jchar *str = (*env)->GetStringChars(env, jstr, 0);
     jsize size = (*env)->GetStringLength(env, jstr);
-    result = PyUnicode_DecodeUTF16((const char*) str, size * 2, NULL, NULL);
-    (*env)->ReleaseStringChars(env, jstr, str);
+
+    /*
+     * Short strings are copied out so the string is not pinned, longer
+     * strings are read in place without a copy.
+     */
+    if (size <= JEP_STRING_STACK_SIZE) {
+        jchar      buffer[JEP_STRING_STACK_SIZE];
+        JepThread *jepThread;
+        (*env)->GetStringRegion(env, jstr, 0, size, buffer);
+        if (size <= JEP_INTERN_MAX_LENGTH
+                && (jepThread = pyembed_find_jepthread()) != NULL
+                && jepThread->intern.size) {
+            result = intern_cache_get(&jepThread->intern, buffer, size);
+        } else {
+            result = jchars_To_PyObject(buffer, size);
+        }
+    } else {
+        const jchar *str = (*env)->GetStringCritical(env, jstr, NULL);
+        if (!str) {
+            if (!process_java_exception(env)) {
+                PyErr_NoMemory();
+            }
+            return NULL;
+        }
+        /* no JNI calls are allowed until the string is released */
+        result = jchars_To_PyObject(str, size);
+        (*env)->ReleaseStringCritical(env, jstr, str);
+    }
 #endif
     return result;
 }
@@ -847,48 +1091,50 @@ PyObject* convert_jobject(JNIEnv *env, jobject val, int typeid)
     // pass through
     // wrap as a object... try to be diligent.
 
-    case JOBJECT_ID:
-        if ((*env)->IsInstanceOf(env, val, JNUMBER_TYPE)) {
-            if ((*env)->IsInstanceOf(env, val, JBYTE_OBJ_TYPE)) {
-                return convert_jobject(env, val, JBYTE_ID);
-            } else if ((*env)->IsInstanceOf(env, val, JSHORT_OBJ_TYPE)) {
-                return convert_jobject(env, val, JSHORT_ID);
-            } else if ((*env)->IsInstanceOf(env, val, JINT_OBJ_TYPE)) {
-                return convert_jobject(env, val, JINT_ID);
-            } else if ((*env)->IsInstanceOf(env, val, JLONG_OBJ_TYPE)) {
-                return convert_jobject(env, val, JLONG_ID);
-            } else if ((*env)->IsInstanceOf(env, val, JDOUBLE_OBJ_TYPE)) {
-                return convert_jobject(env, val, JDOUBLE_ID);
-            } else if ((*env)->IsInstanceOf(env, val, JFLOAT_OBJ_TYPE)) {
-                return convert_jobject(env, val, JFLOAT_ID);
-            }
-        } else if ((*env)->IsInstanceOf(env, val, JBOOL_OBJ_TYPE)) {
-            return convert_jobject(env, val, JBOOLEAN_ID);
-        } else if ((*env)->IsInstanceOf(env, val, JCHAR_OBJ_TYPE)) {
-            return convert_jobject(env, val, JCHAR_ID);
+    case JOBJECT_ID: {
+        /* the descriptor of the class knows if it is a boxed primitive */
+        PyJClassInfoObject *info;
+        jclass              clazz;
+        PyObject           *ret;
+
+        if (!val) {
+            Py_RETURN_NONE;
+        }
+        clazz = (*env)->GetObjectClass(env, val);
+        info  = PyJClassInfo_Get(env, clazz);
+        (*env)->DeleteLocalRef(env, clazz);
+        if (!info) {
+            return NULL;
+        }
+        if (info->boxedTypeId >= 0) {
+            return convert_jobject(env, val, info->boxedTypeId);
+        }
+        ret = JepConverter_ToPython(env, info, val);
+        if (ret || PyErr_Occurred()) {
+            return ret;
+        }
 #if JEP_NUMPY_ENABLED
-        } else if (jndarray_check(env, val)) {
+        if (jndarray_check(env, val)) {
             return convert_jndarray_pyndarray(env, val);
-#endif
         }
+#endif
 
         // none of the above checks matched, make a new PyJObject
-        {
-            PyObject* ret = (PyObject*) PyJObject_New(env, val);
+        ret = (PyObject*) PyJObject_New(env, val);
 #if JEP_NUMPY_ENABLED
-            /*
-             * check for jep/DirectNDArray and autoconvert to numpy.ndarray
-             * pyjobject
-             */
-            if (jdndarray_check(env, val)) {
-                return convert_jdndarray_pyndarray(env, ret);
-            }
-            if (PyErr_Occurred()) {
-                return NULL;
-            }
-#endif
-            return ret;
+        /*
+         * check for jep/DirectNDArray and autoconvert to numpy.ndarray
+         * pyjobject
+         */
+        if (jdndarray_check(env, val)) {
+            return convert_jdndarray_pyndarray(env, ret);
         }
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+#endif
+        return ret;
+    }
 
     case JBOOLEAN_ID: {
         jboolean b = java_lang_Boolean_booleanValue(env, val);
@@ -968,22 +1214,292 @@ PyObject* convert_jobject_pyobject(JNIEnv *env, jobject val)
     int typeId         = -1;
 
     if (val != NULL) {
-        jclass retClass = (*env)->GetObjectClass(env, val);
-        typeId = get_jtype(env, retClass);
+        PyJClassInfoObject *info;
+        jclass              retClass = (*env)->GetObjectClass(env, val);
+
+        /* the descriptor remembers the type id of the class */
+        info = PyJClassInfo_Get(env, retClass);
         (*env)->DeleteLocalRef(env, retClass);
+        if (!info) {
+            return NULL;
+        }
+        typeId = info->typeId;
     }
 
     return convert_jobject(env, val, typeId);
 }
 
 
+/* The kinds written by jep.Util.snapshot() */
+#define SNAPSHOT_LIST   0
+#define SNAPSHOT_SET    1
+#define SNAPSHOT_MAP    2
+
+#define SNAPSHOT_NULL   0
+#define SNAPSHOT_TRUE   1
+#define SNAPSHOT_FALSE  2
+#define SNAPSHOT_LONG   3
+#define SNAPSHOT_DOUBLE 4
+#define SNAPSHOT_OBJECT 5
+#define SNAPSHOT_STRING 6
+
+/*
+ * Converts a string that jep.Util.snapshot() copied into its chars to a python
+ * string the same way jstring_To_PyObject() would.
+ */
+static PyObject* snapshot_string_To_PyObject(const jchar *str, jsize size)
+{
+#if PY_MAJOR_VERSION < 3
+    /* use native order explicitly so a leading U+FEFF is not a BOM */
+    const jchar  one       = 1;
+    int          byteorder = *((const char*) &one) ? -1 : 1;
+    PyObject    *unicode   = PyUnicode_DecodeUTF16((const char*) str,
+                             size * 2, NULL, &byteorder);
+    PyObject    *result;
+
+    if (!unicode) {
+        return NULL;
+    }
+    result = PyUnicode_AsUTF8String(unicode);
+    Py_DECREF(unicode);
+    return result;
+#else
+    JepThread *jepThread;
+
+    if (size <= JEP_INTERN_MAX_LENGTH
+            && (jepThread = pyembed_find_jepthread()) != NULL
+            && jepThread->intern.size) {
+        return intern_cache_get(&jepThread->intern, str, size);
+    }
+    return jchars_To_PyObject(str, size);
+#endif
+}
+
+/*
+ * Converts one object from a snapshot, with deep nested collections and maps
+ * are converted as well instead of being wrapped in a PyJObject.
+ */
+static PyObject* snapshot_object_To_PyObject(JNIEnv *env, jobject val,
+        int deep)
+{
+    PyObject *result;
+
+    if (deep && ((*env)->IsInstanceOf(env, val, JCOLLECTION_TYPE)
+                 || (*env)->IsInstanceOf(env, val, JMAP_TYPE))) {
+        if (Py_EnterRecursiveCall(" in toPython")) {
+            return NULL;
+        }
+        result = jcollection_To_PyObject(env, val, deep);
+        Py_LeaveRecursiveCall();
+        return result;
+    }
+    return convert_jobject_pyobject(env, val);
+}
+
+/*
+ * Converts a java.util.Collection or java.util.Map into a python list, set or
+ * dict. All the values are copied out of java with a single call to
+ * jep.Util.snapshot() so boxed numbers, booleans and strings are converted
+ * without calling back into java for every element.
+ */
+PyObject* jcollection_To_PyObject(JNIEnv *env, jobject container, int deep)
+{
+    jobjectArray  arrays;
+    jbyteArray    jkinds   = NULL;
+    jlongArray    jlongs   = NULL;
+    jdoubleArray  jdoubles = NULL;
+    jobjectArray  objects;
+    jcharArray    jchars   = NULL;
+    jintArray     jlengths = NULL;
+    jbyte        *kinds   = NULL;
+    jlong        *longs   = NULL;
+    jdouble      *doubles = NULL;
+    jchar        *chars   = NULL;
+    jint         *lengths = NULL;
+    jsize         count, i;
+    jsize         nextLong = 0, nextDouble = 0, nextObject = 0;
+    jsize         nextString = 0, nextChar = 0;
+    PyObject     *values  = NULL;
+    PyObject     *result  = NULL;
+
+    if ((*env)->PushLocalFrame(env, 8) != 0) {
+        process_java_exception(env);
+        return NULL;
+    }
+    arrays = jep_Util_snapshot(env, container);
+    if (!arrays) {
+        if (!process_java_exception(env)) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Unable to copy the values of a java collection.");
+        }
+        goto EXIT;
+    }
+    jkinds   = (jbyteArray) (*env)->GetObjectArrayElement(env, arrays, 0);
+    jlongs   = (jlongArray) (*env)->GetObjectArrayElement(env, arrays, 1);
+    jdoubles = (jdoubleArray) (*env)->GetObjectArrayElement(env, arrays, 2);
+    objects  = (jobjectArray) (*env)->GetObjectArrayElement(env, arrays, 3);
+    jchars   = (jcharArray) (*env)->GetObjectArrayElement(env, arrays, 4);
+    jlengths = (jintArray) (*env)->GetObjectArrayElement(env, arrays, 5);
+    if (process_java_exception(env)) {
+        goto EXIT;
+    }
+
+    kinds   = (*env)->GetByteArrayElements(env, jkinds, NULL);
+    longs   = (*env)->GetLongArrayElements(env, jlongs, NULL);
+    doubles = (*env)->GetDoubleArrayElements(env, jdoubles, NULL);
+    chars   = (*env)->GetCharArrayElements(env, jchars, NULL);
+    lengths = (*env)->GetIntArrayElements(env, jlengths, NULL);
+    if (!kinds || !longs || !doubles || !chars || !lengths) {
+        if (!process_java_exception(env)) {
+            PyErr_NoMemory();
+        }
+        goto EXIT;
+    }
+
+    count  = (*env)->GetArrayLength(env, jkinds) - 1;
+    values = PyList_New(count);
+    if (!values) {
+        goto EXIT;
+    }
+    for (i = 0; i < count; i++) {
+        PyObject *item;
+        jobject   val;
+
+        switch (kinds[i + 1]) {
+        case SNAPSHOT_NULL:
+            Py_INCREF(Py_None);
+            item = Py_None;
+            break;
+        case SNAPSHOT_TRUE:
+            Py_INCREF(Py_True);
+            item = Py_True;
+            break;
+        case SNAPSHOT_FALSE:
+            Py_INCREF(Py_False);
+            item = Py_False;
+            break;
+        case SNAPSHOT_LONG:
+            item = PyLong_FromLongLong(longs[nextLong++]);
+            break;
+        case SNAPSHOT_DOUBLE:
+            item = PyFloat_FromDouble(doubles[nextDouble++]);
+            break;
+        case SNAPSHOT_STRING:
+            item = snapshot_string_To_PyObject(chars + nextChar,
+                                               lengths[nextString]);
+            nextChar += lengths[nextString++];
+            break;
+        default:
+            val  = (*env)->GetObjectArrayElement(env, objects, nextObject++);
+            item = snapshot_object_To_PyObject(env, val, deep);
+            (*env)->DeleteLocalRef(env, val);
+            break;
+        }
+        if (!item) {
+            goto EXIT;
+        }
+        PyList_SET_ITEM(values, i, item);
+    }
+
+    switch (kinds[0]) {
+    case SNAPSHOT_SET:
+        result = PySet_New(values);
+        break;
+    case SNAPSHOT_MAP:
+        result = PyDict_New();
+        for (i = 0; result && i + 1 < count; i += 2) {
+            if (PyDict_SetItem(result, PyList_GET_ITEM(values, i),
+                               PyList_GET_ITEM(values, i + 1)) != 0) {
+                Py_CLEAR(result);
+            }
+        }
+        break;
+    default:
+        Py_INCREF(values);
+        result = values;
+        break;
+    }
+
+EXIT:
+    Py_XDECREF(values);
+    if (kinds) {
+        (*env)->ReleaseByteArrayElements(env, jkinds, kinds, JNI_ABORT);
+    }
+    if (longs) {
+        (*env)->ReleaseLongArrayElements(env, jlongs, longs, JNI_ABORT);
+    }
+    if (doubles) {
+        (*env)->ReleaseDoubleArrayElements(env, jdoubles, doubles, JNI_ABORT);
+    }
+    if (chars) {
+        (*env)->ReleaseCharArrayElements(env, jchars, chars, JNI_ABORT);
+    }
+    if (lengths) {
+        (*env)->ReleaseIntArrayElements(env, jlengths, lengths, JNI_ABORT);
+    }
+    (*env)->PopLocalFrame(env, NULL);
+    return result;
+}
+
+
 // for parsing args.
 // takes a python object and sets the right jvalue member for the given java type.
 // returns uninitialized on error and raises a python exception.
-jvalue convert_pyarg_jvalue(JNIEnv *env, PyObject *param, jclass paramType,
-                            int paramTypeId, int pos)
+jvalue convert_pyarg_jvalue(JNIEnv *env, PyObject *param,
+                            PyJMethodParameter *parameter, int pos)
 {
-    jvalue ret = PyObject_As_jvalue(env, param, paramType);
+    jvalue ret;
+
+    /*
+     * The type id of the parameter is already known so there is no need to
+     * compare the parameter class to every primitive type.
+     */
+    switch (parameter->typeId) {
+    case JBOOLEAN_ID:
+        ret.z = PyObject_As_jboolean(param);
+        break;
+    case JINT_ID:
+        ret.i = PyObject_As_jint(param);
+        break;
+    case JLONG_ID:
+        ret.j = PyObject_As_jlong(param);
+        break;
+    case JDOUBLE_ID:
+        ret.d = PyObject_As_jdouble(param);
+        break;
+    case JSHORT_ID:
+        ret.s = PyObject_As_jshort(param);
+        break;
+    case JFLOAT_ID:
+        ret.f = PyObject_As_jfloat(param);
+        break;
+    case JCHAR_ID:
+        ret.c = PyObject_As_jchar(param);
+        break;
+    case JBYTE_ID:
+        ret.b = PyObject_As_jbyte(param);
+        break;
+    case JOBJECT_ID:
+    case JARRAY_ID:
+        /*
+         * Objects of the class that was last passed for this parameter are
+         * known to be assignable, so the java object is used directly. The
+         * global ref of the PyJObject is valid for the duration of the call.
+         */
+        if (PyJObject_Check(param) && ((PyJObject*) param)->object
+                && ((PyJObject*) param)->classInfo == parameter->assignable) {
+            ret.l = ((PyJObject*) param)->object;
+            break;
+        }
+        ret.l = PyObject_As_jobject(env, param, parameter->type);
+        if (ret.l && PyJObject_Check(param) && ((PyJObject*) param)->object) {
+            parameter->assignable = ((PyJObject*) param)->classInfo;
+        }
+        break;
+    default:
+        ret = PyObject_As_jvalue(env, param, parameter->type);
+    }
+
     if (PyErr_Occurred()) {
         PyObject *ptype, *pvalue, *ptrace, *pvalue_string;
         PyErr_Fetch(&ptype, &pvalue, &ptrace);
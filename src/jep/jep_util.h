@@ -67,13 +67,53 @@ void unref_cache_primitive_classes(JNIEnv*);
 int cache_frequent_classes(JNIEnv*);
 void unref_cache_frequent_classes(JNIEnv*);
 
+/*
+ * Strings with at most this many characters are converted between java and
+ * python through a buffer on the stack.
+ */
+#define JEP_STRING_STACK_SIZE 256
+
+/*
+ * The maximum number of characters a java string can have to be kept in the
+ * intern cache of an interpreter, see JepConfig.setStringInternCacheSize(int).
+ */
+#define JEP_INTERN_MAX_LENGTH 32
+
+typedef struct {
+    PyObject    *str;   /* an interned python string or NULL */
+    unsigned int hash;  /* hash of the UTF-16 characters of str */
+} JepInternEntry;
+
+/*
+ * A direct mapped cache of interned python strings for short java strings
+ * that are converted over and over, such as map keys or field names. Strings
+ * are found by a hash of their UTF-16 characters so a hit does not allocate
+ * and the string compares by pointer when it is used as a dict key. The
+ * cache owns a reference to each string. Only used with python 3.
+ */
+typedef struct {
+    JepInternEntry *entries; /* lazily allocated */
+    int             size;    /* number of entries, a power of two, 0 when
+                                disabled */
+    Py_ssize_t      hits;
+    Py_ssize_t      misses;
+} JepInternCache;
+
+/* Set up a cache with at least the given number of entries, 0 disables it */
+void init_intern_cache(JepInternCache*, int);
+/* Release the strings and entries of a cache, it is disabled afterwards */
+void clear_intern_cache(JepInternCache*);
+
 int get_jtype(JNIEnv*, jclass);
+/* The type id of the elements of a numeric primitive array class or -1 */
+int get_numeric_array_jtype(JNIEnv*, jclass);
 int pyarg_matches_jtype(JNIEnv*, PyObject*, jclass, int);
 PyObject* jstring_To_PyObject(JNIEnv*, jobject);
 PyObject* jchar_To_PyObject(jchar);
 PyObject* convert_jobject(JNIEnv*, jobject, int);
 PyObject* convert_jobject_pyobject(JNIEnv*, jobject);
-jvalue convert_pyarg_jvalue(JNIEnv*, PyObject*, jclass, int, int);
+/* Copies a java Collection or Map into a python list, set or dict */
+PyObject* jcollection_To_PyObject(JNIEnv*, jobject, int);
 
 
 #define JBOOLEAN_ID 0
@@ -142,6 +182,11 @@ extern jclass JMODIFIER_TYPE;
 extern jclass JARRAYLIST_TYPE;
 extern jclass JHASHMAP_TYPE;
 extern jclass JCOLLECTIONS_TYPE;
+extern jclass JSYSTEM_TYPE;
+extern jclass JPROXY_TYPE;
+extern jclass JEP_UTIL_TYPE;
+extern jclass JEP_LISTVIEW_TYPE;
+extern jclass JEP_MAPVIEW_TYPE;
 
 // cache frequently used method
 extern jmethodID JCLASS_GET_NAME;
@@ -49,6 +49,10 @@
  */
 #include "marshal.h"
 
+#ifndef WIN32
+    #include <pthread.h>
+#endif
+
 
 #ifdef __APPLE__
     #ifndef WITH_NEXT_FRAMEWORK
@@ -65,12 +69,59 @@ static PyThreadState *mainThreadState = NULL;
 static PyObject* mainThreadModules = NULL;
 static PyObject* mainThreadModulesLock = NULL;
 
+/*
+ * The thread state and JepThread most recently found by
+ * pyembed_find_jepthread(), protected by the GIL.
+ */
+static PyThreadState *lastJepThreadState = NULL;
+static JepThread     *lastJepThread      = NULL;
+
+/*
+ * Every open JepThread so the JepThread of an interpreter can be found from
+ * threads started by python, see pyembed_find_interpreter_jepthread().
+ * Protected by the GIL.
+ */
+static JepThread     *firstJepThread     = NULL;
+
+/* The JavaVM that loaded jep, saved by pyembed_set_jvm(). */
+static JavaVM *jvm = NULL;
+
+/*
+ * The JNIEnv of each thread is kept in thread local storage by
+ * pyembed_get_env() so the JavaVM does not need to be asked for it on every
+ * call. A JNIEnv is valid for as long as its thread is attached, which for
+ * the java threads that use jep is the life of the thread. Threads that were
+ * not attached to the JVM when they first needed a JNIEnv, such as threads
+ * started by python, are attached by pyembed_get_env() and marked with
+ * attachedKey so they are detached when they exit. If the keys cannot be
+ * created the JNIEnv is looked up every time.
+ */
+#ifdef WIN32
+static DWORD envKey      = TLS_OUT_OF_INDEXES;
+static DWORD attachedKey = TLS_OUT_OF_INDEXES;
+#define pyembed_tls_get(key)        TlsGetValue(key)
+#define pyembed_tls_set(key, value) TlsSetValue(key, value)
+#else
+static pthread_key_t envKey;
+static pthread_key_t attachedKey;
+#define pyembed_tls_get(key)        pthread_getspecific(key)
+#define pyembed_tls_set(key, value) pthread_setspecific(key, value)
+#endif
+static int tlsKeysCreated = 0;
+
 int pyembed_version_unsafe(void);
 
 static PyObject* pyembed_findclass(PyObject*, PyObject*);
 static PyObject* pyembed_forname(PyObject*, PyObject*);
 static PyObject* pyembed_set_print_stack(PyObject*, PyObject*);
 static PyObject* pyembed_jproxy(PyObject*, PyObject*);
+static PyObject* pyembed_identity_cache_stats(PyObject*, PyObject*);
+static PyObject* pyembed_intern_cache_stats(PyObject*, PyObject*);
+static PyObject* pyembed_flush_refs_v(PyObject*, PyObject*);
+static PyObject* pyembed_ref_stats(PyObject*, PyObject*);
+static PyObject* pyembed_to_python(PyObject*, PyObject*, PyObject*);
+static PyObject* pyembed_add_converter(PyObject*, PyObject*, PyObject*);
+static PyObject* pyembed_remove_converter(PyObject*, PyObject*);
 
 static int maybe_pyc_file(FILE*, const char*, const char*, int);
 static void pyembed_run_pyc(JepThread *jepThread, FILE *);
@@ -126,6 +177,73 @@ static struct PyMethodDef jep_methods[] = {
         "to implement, string names])"
     },
 
+    {
+        "identityCacheStats",
+        pyembed_identity_cache_stats,
+        METH_NOARGS,
+        "Get a dict with the hits, misses and current size of the cache of\n"
+        "live java objects, see JepConfig.setIdentityCache(boolean)"
+    },
+
+    {
+        "internCacheStats",
+        pyembed_intern_cache_stats,
+        METH_NOARGS,
+        "Get a dict with the hits, misses and size of the cache of interned\n"
+        "java strings, see JepConfig.setStringInternCacheSize(int)"
+    },
+
+    {
+        "flushRefs",
+        pyembed_flush_refs_v,
+        METH_NOARGS,
+        "Delete the java references of freed objects that are waiting to be\n"
+        "deleted, this happens automatically when python returns to java."
+    },
+
+    {
+        "refStats",
+        pyembed_ref_stats,
+        METH_NOARGS,
+        "Get a dict with the number of java references waiting to be deleted,\n"
+        "the number deleted so far, the number of times they were flushed and\n"
+        "the number held by java objects, classes, fields and methods that\n"
+        "have not been deleted yet."
+    },
+
+    {
+        "toPython",
+        (PyCFunction) pyembed_to_python,
+        METH_VARARGS | METH_KEYWORDS,
+        "Copy a java Collection or Map into a new python list, set or dict.\n"
+        "Accepts (obj, deep=False), with deep nested collections and maps are\n"
+        "copied as well instead of being left as java objects."
+    },
+
+    {
+        "addConverter",
+        (PyCFunction) pyembed_add_converter,
+        METH_VARARGS | METH_KEYWORDS,
+        "Add a converter between a python type and a java class.\n"
+        "Accepts (pytype, javaClass, toJava=None, toPython=None), where the\n"
+        "converters are python callables or java.util.function.Functions.\n"
+        "A java Function converting to java is given str() of the python\n"
+        "object and the result of one converting to python is passed to\n"
+        "pytype unless it is already an instance. Without converters the\n"
+        "built in converter for the pair is used, which exists for\n"
+        "decimal.Decimal with java.math.BigDecimal and datetime.datetime\n"
+        "with java.sql.Timestamp."
+    },
+
+    {
+        "removeConverter",
+        pyembed_remove_converter,
+        METH_VARARGS,
+        "Remove the converter between a python type and a java class.\n"
+        "Returns True if there was a converter for the pair, otherwise it does\n"
+        "nothing and returns False."
+    },
+
     { NULL, NULL }
 };
 
@@ -395,6 +513,42 @@ int pyembed_version_unsafe(void)
 }
 
 
+#ifdef WIN32
+void pyembed_detach_thread(void)
+{
+    if (tlsKeysCreated && jvm && pyembed_tls_get(attachedKey)) {
+        pyembed_tls_set(attachedKey, NULL);
+        pyembed_tls_set(envKey, NULL);
+        (*jvm)->DetachCurrentThread(jvm);
+    }
+}
+#else
+/* Destructor of attachedKey, called when a thread attached by jep exits. */
+static void pyembed_detach_thread(void *attached)
+{
+    if (jvm) {
+        (*jvm)->DetachCurrentThread(jvm);
+    }
+}
+#endif
+
+
+void pyembed_set_jvm(JavaVM *vm)
+{
+    jvm = vm;
+#ifdef WIN32
+    envKey         = TlsAlloc();
+    attachedKey    = TlsAlloc();
+    tlsKeysCreated = envKey != TLS_OUT_OF_INDEXES
+                     && attachedKey != TLS_OUT_OF_INDEXES;
+#else
+    tlsKeysCreated = pthread_key_create(&envKey, NULL) == 0
+                     && pthread_key_create(&attachedKey,
+                                           pyembed_detach_thread) == 0;
+#endif
+}
+
+
 void pyembed_shutdown(JavaVM *vm)
 {
     JNIEnv *env;
@@ -403,11 +557,28 @@ void pyembed_shutdown(JavaVM *vm)
     PyEval_AcquireThread(mainThreadState);
     Py_Finalize();
 
+    /*
+     * The library is being unloaded so threads must no longer be detached by
+     * code that will be gone.
+     */
+    if (tlsKeysCreated) {
+        tlsKeysCreated = 0;
+#ifdef WIN32
+        TlsFree(envKey);
+        TlsFree(attachedKey);
+#else
+        pthread_key_delete(envKey);
+        pthread_key_delete(attachedKey);
+#endif
+    }
+
     if ((*vm)->GetEnv(vm, (void **) &env, JNI_VERSION_1_6) != JNI_OK) {
         // failed to get a JNIEnv*, we can hope it's just shutting down fast
         return;
     } else {
         // delete global references
+        JepMetadata_Clear(env);
+        JBox_ClearCache(env);
         unref_cache_primitive_classes(env);
         unref_cache_frequent_classes(env);
     }
@@ -510,7 +681,12 @@ void unshareBuiltins(JepThread *jepThread)
 #endif
 
 intptr_t pyembed_thread_init(JNIEnv *env, jobject cl, jobject caller,
-                             jboolean hasSharedModules)
+                             jboolean hasSharedModules, jint objectFreeListLimit,
+                             jboolean lazyMembers, jstring metadataCacheFile,
+                             jboolean identityCache, jint internCacheSize,
+                             jboolean classTypes, jboolean adaptiveGIL,
+                             jobjectArray keepGILMethods,
+                             jboolean collectionViews)
 {
     JepThread *jepThread;
     PyObject  *tdict, *mod_main, *globals;
@@ -575,7 +751,62 @@ intptr_t pyembed_thread_init(JNIEnv *env, jobject cl, jobject caller,
     jepThread->classloader     = (*env)->NewGlobalRef(env, cl);
     jepThread->caller          = (*env)->NewGlobalRef(env, caller);
     jepThread->printStack      = 0;
-    jepThread->fqnToPyJAttrs = NULL;
+    memset(&jepThread->classInfo, 0, sizeof(PyJClassInfoTable));
+    jepThread->scratch         = NULL;
+    jepThread->scratchUsed     = 0;
+    jepThread->objectFreeList      = NULL;
+    jepThread->objectFreeListSize  = 0;
+    jepThread->objectFreeListLimit = objectFreeListLimit;
+    jepThread->lazyMembers         = lazyMembers;
+    jepThread->metadataCacheFile   = NULL;
+    memset(&jepThread->identity, 0, sizeof(PyJObjectIdentityTable));
+    jepThread->identity.enabled    = identityCache;
+    jepThread->releaseQueue        = NULL;
+    jepThread->releaseQueueSize    = 0;
+    jepThread->createdRefs         = 0;
+    jepThread->releasedRefs        = 0;
+    jepThread->releaseFlushes      = 0;
+    init_intern_cache(&jepThread->intern, internCacheSize);
+    jepThread->classTypes          = classTypes;
+    jepThread->sharedMethods       = NULL;
+    jepThread->sharedFields        = NULL;
+    jepThread->adaptiveGIL         = adaptiveGIL;
+    jepThread->keepGILMethods      = NULL;
+    jepThread->collectionViews     = collectionViews;
+    memset(&jepThread->converters, 0, sizeof(JepConverterRegistry));
+    jepThread->next                = firstJepThread;
+    firstJepThread                 = jepThread;
+    if (keepGILMethods) {
+        jsize i, len = (*env)->GetArrayLength(env, keepGILMethods);
+        jepThread->keepGILMethods = PySet_New(NULL);
+        for (i = 0; i < len && jepThread->keepGILMethods; i++) {
+            jstring   jname = (*env)->GetObjectArrayElement(env,
+                              keepGILMethods, i);
+            PyObject *name  = jstring_To_PyObject(env, jname);
+            (*env)->DeleteLocalRef(env, jname);
+            if (!name || PySet_Add(jepThread->keepGILMethods, name) != 0) {
+                Py_CLEAR(jepThread->keepGILMethods);
+            }
+            Py_XDECREF(name);
+        }
+        if (!jepThread->keepGILMethods) {
+            /* the methods release the GIL like any other */
+            PyErr_Print();
+        }
+    }
+    if (metadataCacheFile) {
+        const char *path = (*env)->GetStringUTFChars(env, metadataCacheFile, 0);
+        if (path) {
+            jepThread->metadataCacheFile = malloc(strlen(path) + 1);
+            if (jepThread->metadataCacheFile) {
+                strcpy(jepThread->metadataCacheFile, path);
+            }
+            (*env)->ReleaseStringUTFChars(env, metadataCacheFile, path);
+        }
+        if (jepThread->metadataCacheFile) {
+            JepMetadata_Load(jepThread->metadataCacheFile);
+        }
+    }
 
     if ((tdict = PyThreadState_GetDict()) != NULL) {
         PyObject *key, *t;
@@ -601,6 +832,7 @@ intptr_t pyembed_thread_init(JNIEnv *env, jobject cl, jobject caller,
 void pyembed_thread_close(JNIEnv *env, intptr_t _jepThread)
 {
     JepThread     *jepThread;
+    JepThread    **link;
     PyObject      *tdict, *key;
 
     jepThread = (JepThread *) _jepThread;
@@ -623,8 +855,35 @@ void pyembed_thread_close(JNIEnv *env, intptr_t _jepThread)
     Py_DECREF(key);
 
     Py_CLEAR(jepThread->globals);
-    Py_CLEAR(jepThread->fqnToPyJAttrs);
+    PyJClassInfo_ClearTable(&jepThread->classInfo);
+    JepConverter_ClearRegistry(env, &jepThread->converters);
+    Py_CLEAR(jepThread->sharedMethods);
+    Py_CLEAR(jepThread->sharedFields);
+    Py_CLEAR(jepThread->keepGILMethods);
+    if (jepThread->metadataCacheFile) {
+        JepMetadata_Save(env, jepThread->metadataCacheFile);
+        free(jepThread->metadataCacheFile);
+    }
     Py_CLEAR(jepThread->modjep);
+    PyMem_Free(jepThread->scratch);
+    jepThread->scratch = NULL;
+    PyJObject_ClearFreeList(jepThread);
+
+    if (lastJepThread == jepThread) {
+        lastJepThreadState = NULL;
+        lastJepThread      = NULL;
+    }
+    for (link = &firstJepThread; *link; link = &(*link)->next) {
+        if (*link == jepThread) {
+            *link = jepThread->next;
+            break;
+        }
+    }
+    /* no PyJObject can find the table anymore */
+    PyJObject_ClearIdentityTable(&jepThread->identity);
+    clear_intern_cache(&jepThread->intern);
+    pyembed_flush_refs(jepThread);
+    PyMem_Free(jepThread->releaseQueue);
 
     if (jepThread->classloader) {
         (*env)->DeleteGlobalRef(env, jepThread->classloader);
@@ -642,32 +901,53 @@ void pyembed_thread_close(JNIEnv *env, intptr_t _jepThread)
 
 JNIEnv* pyembed_get_env(void)
 {
-    JavaVM *jvm;
-    JNIEnv *env;
-    jsize nVMs;
-
+    JNIEnv *env = NULL;
+    jsize   nVMs;
 
-    JNI_GetCreatedJavaVMs(&jvm, 1, &nVMs);
-    /*
-     * If the thread is already part of the JVM, the daemon status is not
-     * changed. If this is a new thread, started by Python then this tells
-     * Java to allow the process to exit even if the thread is still attached.
-     * Since there are no hooks to detach the thread later daemon is the only
-     * way to let the process exit normally.
-     */
-    (*jvm)->AttachCurrentThreadAsDaemon(jvm, (void**) &env, NULL);
+    if (tlsKeysCreated) {
+        env = (JNIEnv*) pyembed_tls_get(envKey);
+        if (env) {
+            return env;
+        }
+    }
 
+    if (!jvm) {
+        JNI_GetCreatedJavaVMs(&jvm, 1, &nVMs);
+    }
+    if ((*jvm)->GetEnv(jvm, (void**) &env, JNI_VERSION_1_6) == JNI_EDETACHED) {
+        /*
+         * This is a new thread, started by Python. Attaching it as a daemon
+         * tells Java to allow the process to exit even if the thread is still
+         * running, the thread is detached when it exits.
+         */
+        if ((*jvm)->AttachCurrentThreadAsDaemon(jvm, (void**) &env,
+                                                NULL) != JNI_OK) {
+            return NULL;
+        }
+        if (tlsKeysCreated) {
+            pyembed_tls_set(attachedKey, (void*) jvm);
+        }
+    }
+    if (tlsKeysCreated) {
+        pyembed_tls_set(envKey, (void*) env);
+    }
     return env;
 }
 
 
-// get thread struct when called from internals.
-// NULL if not found.
-// hold the lock before calling.
-JepThread* pyembed_get_jepthread(void)
+/*
+ * The last JepThread that was found is remembered since almost every lookup
+ * is for the same thread state as the previous one.
+ */
+JepThread* pyembed_find_jepthread(void)
 {
-    PyObject  *tdict, *t, *key;
-    JepThread *ret = NULL;
+    PyThreadState *tstate = PyThreadState_GET();
+    PyObject      *tdict, *t, *key;
+    JepThread     *ret    = NULL;
+
+    if (tstate == lastJepThreadState) {
+        return lastJepThread;
+    }
 
     key = PyString_FromString(DICT_KEY);
     if ((tdict = PyThreadState_GetDict()) != NULL && key != NULL) {
@@ -681,6 +961,49 @@ JepThread* pyembed_get_jepthread(void)
         }
     }
     Py_XDECREF(key);
+    if (ret) {
+        lastJepThreadState = tstate;
+        lastJepThread      = ret;
+    }
+    return ret;
+}
+
+
+JepThread* pyembed_find_interpreter_jepthread(void)
+{
+    JepThread          *jepThread = pyembed_find_jepthread();
+    PyInterpreterState *interp;
+
+    if (jepThread) {
+        return jepThread;
+    }
+    interp = PyThreadState_GET()->interp;
+    for (jepThread = firstJepThread; jepThread; jepThread = jepThread->next) {
+        if (jepThread->tstate->interp == interp) {
+            return jepThread;
+        }
+    }
+    return NULL;
+}
+
+
+JepThread* pyembed_get_interpreter_jepthread(void)
+{
+    JepThread *ret = pyembed_find_interpreter_jepthread();
+    if (!ret && !PyErr_Occurred()) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "No Jep instance available for the current interpreter.");
+    }
+    return ret;
+}
+
+
+// get thread struct when called from internals.
+// NULL if not found.
+// hold the lock before calling.
+JepThread* pyembed_get_jepthread(void)
+{
+    JepThread *ret = pyembed_find_jepthread();
     if (!ret && !PyErr_Occurred()) {
         PyErr_SetString(PyExc_RuntimeError,
                         "No Jep instance available on current thread.");
@@ -689,6 +1012,124 @@ JepThread* pyembed_get_jepthread(void)
 }
 
 
+/*
+ * Scratch allocations are rounded up to this alignment so that any buffer
+ * in the scratch memory is suitably aligned for jvalues and pointers.
+ */
+#define SCRATCH_ALIGN(size) (((size) + 15) & ~((size_t) 15))
+
+void* pyembed_scratch_alloc(size_t size)
+{
+    JepThread *jepThread = pyembed_find_jepthread();
+    void      *ret       = NULL;
+
+    if (jepThread && SCRATCH_ALIGN(size) <= JEP_SCRATCH_SIZE -
+            jepThread->scratchUsed) {
+        if (!jepThread->scratch) {
+            jepThread->scratch = PyMem_Malloc(JEP_SCRATCH_SIZE);
+        }
+        if (jepThread->scratch) {
+            ret = jepThread->scratch + jepThread->scratchUsed;
+            jepThread->scratchUsed += SCRATCH_ALIGN(size);
+            return ret;
+        }
+    }
+    if (PyErr_Occurred()) {
+        return NULL;
+    }
+
+    ret = PyMem_Malloc(size);
+    if (!ret) {
+        PyErr_NoMemory();
+    }
+    return ret;
+}
+
+void pyembed_scratch_free(void *ptr)
+{
+    JepThread *jepThread = pyembed_find_jepthread();
+    char      *mem       = (char*) ptr;
+
+    if (jepThread && jepThread->scratch && mem >= jepThread->scratch
+            && mem < jepThread->scratch + JEP_SCRATCH_SIZE) {
+        /* everything allocated after ptr must already have been freed */
+        jepThread->scratchUsed = mem - jepThread->scratch;
+    } else {
+        PyMem_Free(ptr);
+    }
+}
+
+
+jobject pyembed_new_ref(JNIEnv *env, jobject obj)
+{
+    JepThread *jepThread;
+    jobject    ref;
+
+    ref = (*env)->NewGlobalRef(env, obj);
+    if (ref) {
+        jepThread = pyembed_find_interpreter_jepthread();
+        if (jepThread) {
+            jepThread->createdRefs++;
+        }
+    }
+    return ref;
+}
+
+
+void pyembed_release_ref(jobject ref)
+{
+    JepThread *jepThread;
+    JNIEnv    *env;
+
+    if (!ref) {
+        return;
+    }
+    jepThread = pyembed_find_jepthread();
+    if (jepThread) {
+        if (!jepThread->releaseQueue) {
+            jepThread->releaseQueue = PyMem_Malloc(sizeof(jobject) *
+                                                   JEP_RELEASE_QUEUE_SIZE);
+        }
+        if (jepThread->releaseQueue) {
+            if (jepThread->releaseQueueSize == JEP_RELEASE_QUEUE_SIZE) {
+                pyembed_flush_refs(jepThread);
+            }
+            jepThread->releaseQueue[jepThread->releaseQueueSize++] = ref;
+            return;
+        }
+    }
+    env = pyembed_get_env();
+    if (env) {
+        (*env)->DeleteGlobalRef(env, ref);
+        jepThread = pyembed_find_interpreter_jepthread();
+        if (jepThread) {
+            jepThread->releasedRefs++;
+        }
+    }
+}
+
+
+void pyembed_flush_refs(JepThread *jepThread)
+{
+    JNIEnv *env;
+    int     i;
+
+    if (!jepThread->releaseQueueSize) {
+        return;
+    }
+    env = pyembed_get_env();
+    if (!env) {
+        return;
+    }
+    for (i = 0; i < jepThread->releaseQueueSize; i++) {
+        (*env)->DeleteGlobalRef(env, jepThread->releaseQueue[i]);
+    }
+    jepThread->releasedRefs    += jepThread->releaseQueueSize;
+    jepThread->releaseFlushes  += 1;
+    jepThread->releaseQueueSize = 0;
+}
+
+
 // used by _forname
 #define LOAD_CLASS_METHOD(env, cl)                                          \
 {                                                                           \
@@ -842,6 +1283,176 @@ static PyObject* pyembed_set_print_stack(PyObject *self, PyObject *args)
 }
 
 
+static PyObject* pyembed_identity_cache_stats(PyObject *self,
+        PyObject *unused)
+{
+    JepThread *jepThread = pyembed_get_jepthread();
+    if (!jepThread) {
+        return NULL;
+    }
+    return Py_BuildValue("{s:n,s:n,s:i}",
+                         "hits", jepThread->identity.hits,
+                         "misses", jepThread->identity.misses,
+                         "size", jepThread->identity.count);
+}
+
+
+static PyObject* pyembed_flush_refs_v(PyObject *self, PyObject *unused)
+{
+    JepThread *jepThread = pyembed_get_jepthread();
+    if (!jepThread) {
+        return NULL;
+    }
+    pyembed_flush_refs(jepThread);
+    Py_RETURN_NONE;
+}
+
+
+static PyObject* pyembed_ref_stats(PyObject *self, PyObject *unused)
+{
+    JepThread *jepThread = pyembed_get_jepthread();
+    if (!jepThread) {
+        return NULL;
+    }
+    return Py_BuildValue("{s:i,s:n,s:n,s:n}",
+                         "pending", jepThread->releaseQueueSize,
+                         "released", jepThread->releasedRefs,
+                         "flushes", jepThread->releaseFlushes,
+                         "outstanding",
+                         jepThread->createdRefs - jepThread->releasedRefs);
+}
+
+
+static PyObject* pyembed_intern_cache_stats(PyObject *self, PyObject *unused)
+{
+    JepThread *jepThread = pyembed_get_jepthread();
+    if (!jepThread) {
+        return NULL;
+    }
+    return Py_BuildValue("{s:n,s:n,s:i}",
+                         "hits", jepThread->intern.hits,
+                         "misses", jepThread->intern.misses,
+                         "size", jepThread->intern.size);
+}
+
+
+static PyObject* pyembed_to_python(PyObject *self, PyObject *args,
+                                   PyObject *kwargs)
+{
+    static char *kwlist[] = {"obj", "deep", NULL};
+    PyObject    *obj;
+    PyObject    *deep     = Py_False;
+    JepThread   *jepThread;
+    JNIEnv      *env;
+    jobject      container;
+    int          isDeep;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O:toPython", kwlist,
+                                     &obj, &deep)) {
+        return NULL;
+    }
+    isDeep = PyObject_IsTrue(deep);
+    if (isDeep < 0) {
+        return NULL;
+    }
+
+    jepThread = pyembed_get_jepthread();
+    if (!jepThread) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_RuntimeError, "Invalid JepThread pointer.");
+        }
+        return NULL;
+    }
+    env = jepThread->env;
+
+    container = PyJObject_Check(obj) ? ((PyJObject*) obj)->object : NULL;
+    if (!container || !((*env)->IsInstanceOf(env, container, JCOLLECTION_TYPE)
+                        || (*env)->IsInstanceOf(env, container, JMAP_TYPE))) {
+        PyErr_Format(PyExc_TypeError,
+                     "toPython expects a java Collection or Map, not %s",
+                     Py_TYPE(obj)->tp_name);
+        return NULL;
+    }
+    return jcollection_To_PyObject(env, container, isDeep);
+}
+
+
+/*
+ * Parse the python type and java class of a converter, returns 0 with a python
+ * exception set if they are the wrong types.
+ */
+static int pyembed_parse_converter_pair(PyObject *pyType, PyObject *javaClass)
+{
+    if (!PyType_Check(pyType)) {
+        PyErr_Format(PyExc_TypeError, "Expected a python type, not %s",
+                     Py_TYPE(pyType)->tp_name);
+        return 0;
+    }
+    if (!PyJClass_Check(javaClass)) {
+        PyErr_Format(PyExc_TypeError, "Expected a java class, not %s",
+                     Py_TYPE(javaClass)->tp_name);
+        return 0;
+    }
+    return 1;
+}
+
+
+static PyObject* pyembed_add_converter(PyObject *self, PyObject *args,
+                                       PyObject *kwargs)
+{
+    static char *kwlist[] = {"pytype", "javaClass", "toJava", "toPython",
+                             NULL};
+    PyObject    *pyType, *javaClass;
+    PyObject    *toJava   = Py_None;
+    PyObject    *toPython = Py_None;
+    JNIEnv      *env;
+    jclass       clazz;
+    int          result;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|OO:addConverter",
+                                     kwlist, &pyType, &javaClass, &toJava,
+                                     &toPython)) {
+        return NULL;
+    }
+    if (!pyembed_parse_converter_pair(pyType, javaClass)) {
+        return NULL;
+    }
+    env   = pyembed_get_env();
+    clazz = ((PyJObject*) javaClass)->clazz;
+    if (toJava == Py_None && toPython == Py_None) {
+        result = JepConverter_AddBuiltin(env, (PyTypeObject*) pyType, clazz);
+    } else {
+        result = JepConverter_Add(env, (PyTypeObject*) pyType, clazz, NULL,
+                                  NULL, toJava == Py_None ? NULL : toJava,
+                                  toPython == Py_None ? NULL : toPython);
+    }
+    if (result != 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+
+static PyObject* pyembed_remove_converter(PyObject *self, PyObject *args)
+{
+    PyObject *pyType, *javaClass;
+    int       removed;
+
+    if (!PyArg_ParseTuple(args, "OO:removeConverter", &pyType, &javaClass)) {
+        return NULL;
+    }
+    if (!pyembed_parse_converter_pair(pyType, javaClass)) {
+        return NULL;
+    }
+    removed = JepConverter_Remove(pyembed_get_env(), (PyTypeObject*) pyType,
+                                  ((PyJObject*) javaClass)->clazz);
+    if (removed < 0) {
+        return NULL;
+    }
+    return PyBool_FromLong(removed);
+}
+
+
 static PyObject* pyembed_forname(PyObject *self, PyObject *args)
 {
     JNIEnv    *env       = NULL;
@@ -961,6 +1572,7 @@ jobject pyembed_invoke_method(JNIEnv *env,
     ret = pyembed_invoke(env, callable, args, types);
 
 EXIT:
+    pyembed_flush_refs(jepThread);
     PyEval_ReleaseThread(jepThread->tstate);
 
     return ret;
@@ -1085,6 +1697,7 @@ void pyembed_eval(JNIEnv *env,
     Py_XDECREF(result);
 
 EXIT:
+    pyembed_flush_refs(jepThread);
     PyEval_ReleaseThread(jepThread->tstate);
 }
 
@@ -1257,7 +1870,9 @@ void pyembed_setloader(JNIEnv *env, intptr_t _jepThread, jobject cl)
     }
 
     PyEval_AcquireThread(jepThread->tstate);
-    Py_CLEAR(jepThread->fqnToPyJAttrs);
+    PyJClassInfo_ClearTable(&jepThread->classInfo);
+    Py_CLEAR(jepThread->sharedMethods);
+    Py_CLEAR(jepThread->sharedFields);
 
     oldLoader = jepThread->classloader;
     if (oldLoader) {
@@ -1500,6 +2115,7 @@ void pyembed_run(JNIEnv *env,
     }
 
 EXIT:
+    pyembed_flush_refs(jepThread);
     PyEval_ReleaseThread(jepThread->tstate);
 }
 
@@ -26,6 +26,9 @@
 */
 
 #include "jep_platform.h"
+#include "jep_converters.h"
+#include "pyjclassinfo.h"
+#include "pyjobject.h"
 
 #ifndef _Included_pyembed
 #define _Included_pyembed
@@ -33,6 +36,18 @@
 
 #define DICT_KEY "jep"
 
+/*
+ * The size of the scratch memory each JepThread uses for temporary buffers,
+ * see pyembed_scratch_alloc().
+ */
+#define JEP_SCRATCH_SIZE 4096
+
+/*
+ * The number of global references each JepThread queues for deletion before
+ * they are all deleted, see pyembed_release_ref().
+ */
+#define JEP_RELEASE_QUEUE_SIZE 1024
+
 struct __JepThread {
     PyObject      *modjep;
     PyObject      *globals;
@@ -41,21 +56,60 @@ struct __JepThread {
     jobject        classloader;
     jobject        caller;      /* Jep instance that called us. */
     int            printStack;
-    PyObject      *fqnToPyJAttrs; /* a dictionary of fully qualified Java
-                                       classnames to PyJMethods and PyJFields */
+    PyJClassInfoTable classInfo; /* descriptors of the java classes that have
+                                    been used in this interpreter */
 #if PY_MAJOR_VERSION < 3
     PyObject      *originalBuiltins;
 #endif
+    char          *scratch;     /* lazily allocated, JEP_SCRATCH_SIZE bytes */
+    size_t         scratchUsed; /* bytes of scratch currently in use */
+    PyObject      *objectFreeList;      /* freed PyJObjects for reuse */
+    int            objectFreeListSize;  /* number of PyJObjects in the list */
+    int            objectFreeListLimit; /* maximum size of the list */
+    int            lazyMembers; /* resolve members of java classes on access */
+    char          *metadataCacheFile; /* file to save java metadata in */
+    PyJObjectIdentityTable identity; /* live PyJObjects by java identity */
+    jobject       *releaseQueue;     /* lazily allocated, global refs waiting
+                                        to be deleted */
+    int            releaseQueueSize; /* number of refs in the queue */
+    Py_ssize_t     createdRefs;      /* number of refs made by
+                                        pyembed_new_ref() */
+    Py_ssize_t     releasedRefs;     /* number of refs deleted after
+                                        pyembed_release_ref() */
+    Py_ssize_t     releaseFlushes;   /* number of times the queue was emptied */
+    JepInternCache intern;           /* interned python strings for short
+                                        java strings */
+    int            classTypes;       /* make a python type per java class */
+    PyObject      *sharedMethods;    /* PyJMethods by jmethodID, shared by
+                                        the classes that inherit them */
+    PyObject      *sharedFields;     /* PyJFields by jfieldID */
+    int            adaptiveGIL;      /* time java calls to decide whether
+                                        they release the GIL */
+    PyObject      *keepGILMethods;   /* set of "class.method" names of java
+                                        methods that keep the GIL, or NULL */
+    int            collectionViews;  /* convert lists and dicts to views
+                                        instead of copying them */
+    JepConverterRegistry converters; /* converters added with
+                                        jep.addConverter() */
+    struct __JepThread *next;        /* next JepThread of the process */
 };
 typedef struct __JepThread JepThread;
 
 
 void pyembed_preinit(jint, jint, jint, jint, jint, jint, jint);
 void pyembed_startup(JNIEnv*, jobjectArray);
+/* Save the JavaVM that loaded jep, called from JNI_OnLoad. */
+void pyembed_set_jvm(JavaVM*);
 void pyembed_shutdown(JavaVM*);
+#ifdef WIN32
+/* Detach the current thread if it was attached by pyembed_get_env(). */
+void pyembed_detach_thread(void);
+#endif
 void pyembed_shared_import(JNIEnv*, jstring);
 
-intptr_t pyembed_thread_init(JNIEnv*, jobject, jobject, jboolean);
+intptr_t pyembed_thread_init(JNIEnv*, jobject, jobject, jboolean, jint,
+                             jboolean, jstring, jboolean, jint, jboolean,
+                             jboolean, jobjectArray, jboolean);
 void pyembed_thread_close(JNIEnv*, intptr_t);
 
 void pyembed_close(void);
@@ -72,6 +126,54 @@ jobject pyembed_getvalue_on(JNIEnv*, intptr_t, intptr_t, char*);
 
 JNIEnv* pyembed_get_env(void);
 JepThread* pyembed_get_jepthread(void);
+/*
+ * Same as pyembed_get_jepthread() but does not set a python exception when
+ * there is no Jep instance on the current thread, for use when an exception
+ * cannot be raised such as in tp_dealloc.
+ */
+JepThread* pyembed_find_jepthread(void);
+/*
+ * Get the JepThread of the current interpreter, which also works on threads
+ * that were started by python. Only use it for state that belongs to the
+ * interpreter, like the descriptors of java classes, and never for the
+ * JNIEnv of the JepThread. Returns NULL without setting a python exception
+ * if the interpreter is not used by a Jep instance.
+ */
+JepThread* pyembed_find_interpreter_jepthread(void);
+/* Same as above but sets a python exception if there is no JepThread */
+JepThread* pyembed_get_interpreter_jepthread(void);
+
+/*
+ * Allocate a temporary buffer from the scratch memory of the current
+ * JepThread. Buffers must be released with pyembed_scratch_free() in the
+ * reverse order they were allocated, which naturally happens when they are
+ * only used for the duration of a call, including nested calls from java
+ * back into python. If the scratch memory is full or there is no JepThread
+ * the buffer is allocated with PyMem_Malloc instead. Sets a python exception
+ * and returns NULL if allocation fails. Hold the GIL before calling.
+ */
+void* pyembed_scratch_alloc(size_t);
+void pyembed_scratch_free(void*);
+
+/*
+ * Create a global reference for a python wrapper of a java object, class,
+ * field or method and count it on the JepThread of the current interpreter so
+ * jep.refStats() can report how many are still alive. References made here
+ * must be released with pyembed_release_ref(). Returns NULL if obj is NULL.
+ */
+jobject pyembed_new_ref(JNIEnv*, jobject);
+/*
+ * Delete a global reference that is no longer used. When there is a JepThread
+ * on the current thread the reference is added to its release queue and all
+ * the references in the queue are deleted together when it is full, when the
+ * interpreter returns to java after an eval, run or invoke, or when
+ * jep.flushRefs() is called. This keeps the deletes out of the deallocation of
+ * large groups of wrappers. Without a JepThread the reference is deleted
+ * immediately. Hold the GIL before calling.
+ */
+void pyembed_release_ref(jobject);
+/* Delete every global reference in the release queue of a JepThread. */
+void pyembed_flush_refs(JepThread*);
 
 intptr_t pyembed_create_module(JNIEnv*, intptr_t, char*);
 intptr_t pyembed_create_module_on(JNIEnv*, intptr_t, intptr_t, char*);
@@ -55,8 +55,8 @@ PyObject* pyjarray_new(JNIEnv *env, jobjectArray obj)
     clazz = (*env)->GetObjectClass(env, obj);
 
     pyarray                 = PyObject_NEW(PyJArrayObject, &PyJArray_Type);
-    pyarray->object         = (*env)->NewGlobalRef(env, obj);
-    pyarray->clazz          = (*env)->NewGlobalRef(env, clazz);
+    pyarray->object         = pyembed_new_ref(env, obj);
+    pyarray->clazz          = pyembed_new_ref(env, clazz);
     pyarray->componentType  = -1;
     pyarray->componentClass = NULL;
     pyarray->length         = -1;
@@ -193,15 +193,15 @@ PyObject* pyjarray_new_v(PyObject *isnull, PyObject *args)
     clazz = (*env)->GetObjectClass(env, arrayObj);
 
     pyarray                 = PyObject_NEW(PyJArrayObject, &PyJArray_Type);
-    pyarray->object         = (*env)->NewGlobalRef(env, arrayObj);
-    pyarray->clazz          = (*env)->NewGlobalRef(env, clazz);
+    pyarray->object         = pyembed_new_ref(env, arrayObj);
+    pyarray->clazz          = pyembed_new_ref(env, clazz);
     pyarray->componentType  = (int) typeId;
     pyarray->componentClass = NULL;
     pyarray->length         = -1;
     pyarray->pinnedArray    = NULL;
 
     if (typeId == JOBJECT_ID || typeId == JARRAY_ID) {
-        pyarray->componentClass = (*env)->NewGlobalRef(env, componentClass);
+        pyarray->componentClass = pyembed_new_ref(env, componentClass);
     }
 
     (*env)->DeleteLocalRef(env, arrayObj);
@@ -237,7 +237,7 @@ static int pyjarray_init(JNIEnv *env,
             goto EXIT_ERROR;
         }
 
-        pyarray->componentClass = (*env)->NewGlobalRef(env, compType);
+        pyarray->componentClass = pyembed_new_ref(env, compType);
         pyarray->componentType  = comp;
     }
 
@@ -494,24 +494,14 @@ void pyjarray_pin(PyJArrayObject *self)
 static void pyjarray_dealloc(PyJArrayObject *self)
 {
 #if USE_DEALLOC
-    JNIEnv *env = pyembed_get_env();
-    if (env) {
-        if (self->clazz) {
-            (*env)->DeleteGlobalRef(env, self->clazz);
-        }
-        if (self->componentClass) {
-            (*env)->DeleteGlobalRef(env, self->componentClass);
-        }
-
-        // can't guarantee mode 0 will work in this case...
-        pyjarray_release_pinned(self, JNI_ABORT);
-
-        // pyjarray_release_pinned potentially uses self->object so we can
-        // only delete self->object afterwards
-        if (self->object) {
-            (*env)->DeleteGlobalRef(env, self->object);
-        }
-    } // if env
+    // can't guarantee mode 0 will work in this case...
+    pyjarray_release_pinned(self, JNI_ABORT);
+
+    pyembed_release_ref(self->clazz);
+    pyembed_release_ref(self->componentClass);
+    // pyjarray_release_pinned potentially uses self->object so we can
+    // only release self->object afterwards
+    pyembed_release_ref(self->object);
 
     PyObject_Del(self);
 #endif
@@ -27,6 +27,16 @@
 
 #include "Jep.h"
 
+#if JEP_VECTORCALL
+/*
+ * The number of arguments that a constructor can be called with before the
+ * argument array needs to be allocated on the heap.
+ */
+#define PYJCLASS_STACK_ARGS 8
+
+static PyObject* pyjclass_vectorcall(PyObject*, PyObject *const*, size_t,
+                                     PyObject*);
+#endif
 
 /*
  * Adds a single inner class as attributes to the pyjclass. This will check if
@@ -138,6 +148,9 @@ static PyObject* pyjclass_add_inner_classes(JNIEnv *env,
 int pyjclass_init(JNIEnv *env, PyObject *pyjob)
 {
     ((PyJClassObject*) pyjob)->constructor = NULL;
+#if JEP_VECTORCALL
+    ((PyJClassObject*) pyjob)->vectorcall  = pyjclass_vectorcall;
+#endif
 
     /*
      * attempt to add public inner classes as attributes since lots of people
@@ -251,13 +264,13 @@ EXIT_ERROR:
     return -1;
 }
 
-// call constructor as a method and return pyjobject.
-static PyObject* pyjclass_call(PyJClassObject *self,
-                               PyObject *args,
-                               PyObject *keywords)
+/*
+ * Get the constructor field of a pyjclass, initializing it if necessary.
+ *
+ * @return a borrowed reference to the constructor, NULL on error.
+ */
+static PyObject* pyjclass_get_constructor(PyJClassObject *self)
 {
-    PyObject *boundConstructor = NULL;
-    PyObject *result           = NULL;
     if (self->constructor == NULL) {
         if (pyjclass_init_constructors(self) == -1) {
             return NULL;
@@ -267,6 +280,19 @@ static PyObject* pyjclass_call(PyJClassObject *self,
             return NULL;
         }
     }
+    return self->constructor;
+}
+
+// call constructor as a method and return pyjobject.
+static PyObject* pyjclass_call(PyJClassObject *self,
+                               PyObject *args,
+                               PyObject *keywords)
+{
+    PyObject *boundConstructor = NULL;
+    PyObject *result           = NULL;
+    if (pyjclass_get_constructor(self) == NULL) {
+        return NULL;
+    }
     /*
      * Bind the constructor to the class so that the class will
      * be the first arg when constructor is called.
@@ -283,13 +309,71 @@ static PyObject* pyjclass_call(PyJClassObject *self,
 }
 
 
+#if JEP_VECTORCALL
+/*
+ * Call the constructor with the class prepended to the arguments. When the
+ * caller allows it the slot before args is borrowed for the class, which is
+ * the same trick python uses for bound methods, otherwise the arguments are
+ * copied.
+ */
+static PyObject* pyjclass_vectorcall(PyObject *self, PyObject *const *args,
+                                     size_t nargsf, PyObject *kwnames)
+{
+    PyObject   *constructor = NULL;
+    PyObject   *result      = NULL;
+    PyObject   *stack[PYJCLASS_STACK_ARGS];
+    PyObject  **newargs     = NULL;
+    Py_ssize_t  nargs       = PyVectorcall_NARGS(nargsf);
+
+    if (kwnames != NULL && PyTuple_GET_SIZE(kwnames) > 0) {
+        PyErr_Format(PyExc_TypeError, "Keywords are not supported.");
+        return NULL;
+    }
+    constructor = pyjclass_get_constructor((PyJClassObject*) self);
+    if (constructor == NULL) {
+        return NULL;
+    }
+
+    if (nargsf & PY_VECTORCALL_ARGUMENTS_OFFSET) {
+        PyObject *tmp;
+        newargs    = (PyObject**) args - 1;
+        tmp        = newargs[0];
+        newargs[0] = self;
+        result     = PyObject_Vectorcall(constructor, newargs, nargs + 1, NULL);
+        newargs[0] = tmp;
+        return result;
+    }
+
+    if (nargs < PYJCLASS_STACK_ARGS) {
+        newargs = stack;
+    } else {
+        newargs = PyMem_Malloc(sizeof(PyObject*) * (nargs + 1));
+        if (newargs == NULL) {
+            return PyErr_NoMemory();
+        }
+    }
+    newargs[0] = self;
+    memcpy(newargs + 1, args, sizeof(PyObject*) * nargs);
+    result = PyObject_Vectorcall(constructor, newargs, nargs + 1, NULL);
+    if (newargs != stack) {
+        PyMem_Free(newargs);
+    }
+    return result;
+}
+#endif
+
+
 PyTypeObject PyJClass_Type = {
     PyVarObject_HEAD_INIT(NULL, 0)
     "jep.PyJClass",
     sizeof(PyJClassObject),
     0,
     (destructor) pyjclass_dealloc,            /* tp_dealloc */
+#if JEP_VECTORCALL
+    offsetof(PyJClassObject, vectorcall),     /* tp_vectorcall_offset */
+#else
     0,                                        /* tp_print */
+#endif
     0,                                        /* tp_getattr */
     0,                                        /* tp_setattr */
     0,                                        /* tp_compare */
@@ -303,7 +387,7 @@ PyTypeObject PyJClass_Type = {
     0,                                        /* tp_getattro */
     0,                                        /* tp_setattro */
     0,                                        /* tp_as_buffer */
-    Py_TPFLAGS_DEFAULT,                       /* tp_flags */
+    Py_TPFLAGS_DEFAULT | JEP_TPFLAGS_VECTORCALL, /* tp_flags */
     "jclass",                                 /* tp_doc */
     0,                                        /* tp_traverse */
     0,                                        /* tp_clear */
@@ -45,6 +45,9 @@ typedef struct {
      * PyJConstructors
      */
     PyObject  *constructor;
+#if JEP_VECTORCALL
+    vectorcallfunc vectorcall; /* PEP 590 entry point */
+#endif
 } PyJClassObject;
 
 int pyjclass_init(JNIEnv*, PyObject*);
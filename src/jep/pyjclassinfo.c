@@ -0,0 +1,325 @@
+/*
+   jep - Java Embedded Python
+
+   Copyright (c) 2017 JEP AUTHORS.
+
+   This file is licensed under the the zlib/libpng License.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+   must not claim that you wrote the original software. If you use
+   this software in a product, an acknowledgment in the product
+   documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+   must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+#include "Jep.h"
+
+/* The number of buckets a table starts with, must be a power of two. */
+#define CLASSINFO_INITIAL_SIZE 64
+
+
+/*
+ * Pick the PyJObject subtype for instances of a class. Extending PyJObject
+ * for these interfaces lets python code use the object more pythonically,
+ * e.g. a java.lang.Iterable becomes a PyJIterable that can be used in
+ * "for i in obj:".
+ */
+static PyTypeObject* pyjclassinfo_choose_type(JNIEnv *env, jclass clazz)
+{
+    if ((*env)->IsAssignableFrom(env, clazz, JITERABLE_TYPE)) {
+        if ((*env)->IsAssignableFrom(env, clazz, JCOLLECTION_TYPE)) {
+            if ((*env)->IsAssignableFrom(env, clazz, JLIST_TYPE)) {
+                return &PyJList_Type;
+            }
+            return &PyJCollection_Type;
+        }
+        return &PyJIterable_Type;
+    } else if ((*env)->IsAssignableFrom(env, clazz, JMAP_TYPE)) {
+        return &PyJMap_Type;
+    } else if ((*env)->IsAssignableFrom(env, clazz, JITERATOR_TYPE)) {
+        return &PyJIterator_Type;
+    } else if ((*env)->IsAssignableFrom(env, clazz, JAUTOCLOSEABLE_TYPE)) {
+        return &PyJAutoCloseable_Type;
+    } else if ((*env)->IsAssignableFrom(env, clazz, JNUMBER_TYPE)) {
+        return &PyJNumber_Type;
+    }
+    return &PyJObject_Type;
+}
+
+
+/*
+ * Get the type id of the primitive that a class boxes or -1 if the class is
+ * not a boxed primitive. The boxed classes are final so comparing the class is
+ * the same as checking if objects are instances of them.
+ */
+static int pyjclassinfo_boxed_type(JNIEnv *env, jclass clazz)
+{
+    if ((*env)->IsSameObject(env, clazz, JINT_OBJ_TYPE)) {
+        return JINT_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JLONG_OBJ_TYPE)) {
+        return JLONG_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JDOUBLE_OBJ_TYPE)) {
+        return JDOUBLE_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JBOOL_OBJ_TYPE)) {
+        return JBOOLEAN_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JFLOAT_OBJ_TYPE)) {
+        return JFLOAT_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JSHORT_OBJ_TYPE)) {
+        return JSHORT_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JBYTE_OBJ_TYPE)) {
+        return JBYTE_ID;
+    } else if ((*env)->IsSameObject(env, clazz, JCHAR_OBJ_TYPE)) {
+        return JCHAR_ID;
+    }
+    return -1;
+}
+
+
+static PyJClassInfoObject* pyjclassinfo_new(JNIEnv *env, jclass clazz,
+        jint hash)
+{
+    PyJClassInfoObject *info      = NULL;
+    jstring             className = NULL;
+
+    if (PyType_Ready(&PyJClassInfo_Type) < 0) {
+        return NULL;
+    }
+
+    className = java_lang_Class_getName(env, clazz);
+    if (process_java_exception(env) || !className) {
+        return NULL;
+    }
+
+    info = PyObject_NEW(PyJClassInfoObject, &PyJClassInfo_Type);
+    if (!info) {
+        (*env)->DeleteLocalRef(env, className);
+        return NULL;
+    }
+    info->clazz    = NULL;
+    info->hash     = hash;
+    info->typeId   = -1;
+    info->javaName = NULL;
+    info->pyjType  = &PyJObject_Type;
+    info->classType = NULL;
+    info->boxedTypeId = -1;
+    info->functional  = -1;
+    info->converter       = NULL;
+    info->converterSerial = -1;
+    info->attr     = NULL;
+    info->attrComplete = 0;
+    info->missing  = NULL;
+    info->next     = NULL;
+
+    info->javaName = jstring_To_PyObject(env, className);
+    (*env)->DeleteLocalRef(env, className);
+    if (!info->javaName) {
+        goto EXIT_ERROR;
+    }
+    PyString_InternInPlace(&info->javaName);
+
+    info->typeId = get_jtype(env, clazz);
+    if (process_java_exception(env)) {
+        goto EXIT_ERROR;
+    }
+    if (info->typeId != JARRAY_ID && info->typeId != JCLASS_ID) {
+        info->pyjType = pyjclassinfo_choose_type(env, clazz);
+    }
+    if (info->typeId == JOBJECT_ID) {
+        info->boxedTypeId = pyjclassinfo_boxed_type(env, clazz);
+    }
+
+    info->clazz = (*env)->NewGlobalRef(env, clazz);
+    return info;
+
+EXIT_ERROR:
+    Py_DECREF(info);
+    return NULL;
+}
+
+
+/* Double the number of buckets in a table, returns 0 on failure. */
+static int pyjclassinfo_grow(PyJClassInfoTable *table)
+{
+    PyJClassInfoObject **buckets = NULL;
+    int                  size    = table->size * 2;
+    int                  i;
+
+    buckets = PyMem_Malloc(sizeof(PyJClassInfoObject*) * size);
+    if (!buckets) {
+        return 0;
+    }
+    memset(buckets, 0, sizeof(PyJClassInfoObject*) * size);
+
+    for (i = 0; i < table->size; i++) {
+        PyJClassInfoObject *info = table->buckets[i];
+        while (info) {
+            PyJClassInfoObject *next  = info->next;
+            int                 index = info->hash & (size - 1);
+            info->next     = buckets[index];
+            buckets[index] = info;
+            info = next;
+        }
+    }
+
+    PyMem_Free(table->buckets);
+    table->buckets = buckets;
+    table->size    = size;
+    return 1;
+}
+
+
+PyJClassInfoObject* PyJClassInfo_Get(JNIEnv *env, jclass clazz)
+{
+    JepThread          *jepThread = NULL;
+    PyJClassInfoTable  *table     = NULL;
+    PyJClassInfoObject *info      = NULL;
+    jint                hash      = 0;
+    int                 index     = 0;
+
+    /* threads started by python use the descriptors of their interpreter */
+    jepThread = pyembed_get_interpreter_jepthread();
+    if (!jepThread) {
+        return NULL;
+    }
+    table = &jepThread->classInfo;
+
+    /* Objects are frequently wrapped in a loop so check the last class first. */
+    if (table->last && (*env)->IsSameObject(env, table->last->clazz, clazz)) {
+        return table->last;
+    }
+
+    hash = java_lang_System_identityHashCode(env, clazz);
+    if (process_java_exception(env)) {
+        return NULL;
+    }
+
+    if (table->buckets) {
+        for (info = table->buckets[hash & (table->size - 1)]; info;
+                info = info->next) {
+            if (info->hash == hash
+                    && (*env)->IsSameObject(env, info->clazz, clazz)) {
+                table->last = info;
+                return info;
+            }
+        }
+    } else {
+        table->buckets = PyMem_Malloc(sizeof(PyJClassInfoObject*) *
+                                      CLASSINFO_INITIAL_SIZE);
+        if (!table->buckets) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        memset(table->buckets, 0, sizeof(PyJClassInfoObject*) *
+               CLASSINFO_INITIAL_SIZE);
+        table->size = CLASSINFO_INITIAL_SIZE;
+    }
+
+    info = pyjclassinfo_new(env, clazz, hash);
+    if (!info) {
+        return NULL;
+    }
+
+    /* Growing is only to keep the buckets short, a failure is not an error. */
+    if (table->count >= table->size) {
+        pyjclassinfo_grow(table);
+    }
+    index = hash & (table->size - 1);
+    info->next = table->buckets[index];
+    table->buckets[index] = info;
+    table->count += 1;
+    table->last = info;
+    return info;
+}
+
+
+void PyJClassInfo_ClearTable(PyJClassInfoTable *table)
+{
+    int i;
+    for (i = 0; i < table->size; i++) {
+        PyJClassInfoObject *info = table->buckets[i];
+        while (info) {
+            PyJClassInfoObject *next = info->next;
+            /* unlink first so releasing a long bucket does not recurse */
+            info->next = NULL;
+            Py_DECREF(info);
+            info = next;
+        }
+    }
+    PyMem_Free(table->buckets);
+    table->buckets = NULL;
+    table->size    = 0;
+    table->count   = 0;
+    table->last    = NULL;
+}
+
+
+static void pyjclassinfo_dealloc(PyJClassInfoObject *self)
+{
+#if USE_DEALLOC
+    JNIEnv *env = pyembed_get_env();
+    if (env && self->clazz) {
+        (*env)->DeleteGlobalRef(env, self->clazz);
+    }
+    Py_CLEAR(self->javaName);
+    Py_CLEAR(self->attr);
+    Py_CLEAR(self->classType);
+    Py_CLEAR(self->missing);
+    Py_CLEAR(self->next);
+    PyObject_Del(self);
+#endif
+}
+
+
+PyTypeObject PyJClassInfo_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "jep.PyJClassInfo",
+    sizeof(PyJClassInfoObject),
+    0,
+    (destructor) pyjclassinfo_dealloc,        /* tp_dealloc */
+    0,                                        /* tp_print */
+    0,                                        /* tp_getattr */
+    0,                                        /* tp_setattr */
+    0,                                        /* tp_compare */
+    0,                                        /* tp_repr */
+    0,                                        /* tp_as_number */
+    0,                                        /* tp_as_sequence */
+    0,                                        /* tp_as_mapping */
+    0,                                        /* tp_hash  */
+    0,                                        /* tp_call */
+    0,                                        /* tp_str */
+    0,                                        /* tp_getattro */
+    0,                                        /* tp_setattro */
+    0,                                        /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                       /* tp_flags */
+    "jclassinfo",                             /* tp_doc */
+    0,                                        /* tp_traverse */
+    0,                                        /* tp_clear */
+    0,                                        /* tp_richcompare */
+    0,                                        /* tp_weaklistoffset */
+    0,                                        /* tp_iter */
+    0,                                        /* tp_iternext */
+    0,                                        /* tp_methods */
+    0,                                        /* tp_members */
+    0,                                        /* tp_getset */
+    0,                                        /* tp_base */
+    0,                                        /* tp_dict */
+    0,                                        /* tp_descr_get */
+    0,                                        /* tp_descr_set */
+    0,                                        /* tp_dictoffset */
+    0,                                        /* tp_init */
+    0,                                        /* tp_alloc */
+    NULL,                                     /* tp_new */
+};
@@ -0,0 +1,101 @@
+/*
+   jep - Java Embedded Python
+
+   Copyright (c) 2017 JEP AUTHORS.
+
+   This file is licensed under the the zlib/libpng License.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+   must not claim that you wrote the original software. If you use
+   this software in a product, an acknowledgment in the product
+   documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+   must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+#include "jep_platform.h"
+
+#ifndef _Included_pyjclassinfo
+#define _Included_pyjclassinfo
+
+
+extern PyTypeObject PyJClassInfo_Type;
+
+/*
+ * A descriptor of a java class that is shared by every PyJObject of that class
+ * within an interpreter. Descriptors are found by the identity of the jclass
+ * so classes with the same name from different classloaders do not collide,
+ * and everything that only depends on the class is computed once when the
+ * descriptor is created. Answers that are expensive to compute and are not
+ * always needed, like whether the class is a functional interface, are
+ * computed the first time they are needed. The attr dict holding the PyJMethods and PyJFields is
+ * only filled in when the first PyJObject of the class is initialized because
+ * descriptors are also used for arrays and classes, which do not need it.
+ *
+ * When the interpreter uses class types, see JepConfig.setClassTypes(boolean),
+ * the descriptor also owns a python type for the class that holds the members
+ * and is always complete.
+ *
+ * When the interpreter resolves members lazily the attr dict starts out empty
+ * and members are added one name at a time as they are accessed. Names that
+ * are not members of the class are remembered in missing so they are only
+ * looked up once, and attrComplete is set when attr holds every member.
+ */
+typedef struct _PyJClassInfoObject {
+    PyObject_HEAD
+    jclass        clazz;         /* global ref to the java class */
+    jint          hash;          /* System.identityHashCode() of clazz */
+    int           typeId;        /* type id of clazz from get_jtype() */
+    PyObject     *javaName;      /* interned fully qualified class name */
+    PyTypeObject *pyjType;       /* type to use for PyJObjects of this class */
+    PyTypeObject *classType;     /* heap type for PyJObjects of this class when
+                                    the interpreter uses class types */
+    int           boxedTypeId;   /* type id of the primitive that clazz boxes,
+                                    -1 if it is not a boxed primitive */
+    int           functional;    /* 1 if clazz is a functional interface, 0 if
+                                    not, -1 until it is first needed */
+    PyObject     *attr;          /* dict of PyJMethods and PyJFields */
+    int           attrComplete;  /* true if attr holds every member */
+    PyObject     *missing;       /* set of names that are not members */
+    struct _JepConverter *converter; /* borrowed, converter to python for
+                                        clazz, see jep_converters.h */
+    int           converterSerial; /* serial of the converters when converter
+                                      was found */
+    struct _PyJClassInfoObject *next; /* next descriptor in the same bucket */
+} PyJClassInfoObject;
+
+/*
+ * A hash table of PyJClassInfoObjects, each JepThread has its own table. The
+ * table owns a reference to the first descriptor in each bucket and each
+ * descriptor owns a reference to the next descriptor in its bucket.
+ */
+typedef struct {
+    PyJClassInfoObject **buckets;
+    int                  size;   /* number of buckets, a power of two */
+    int                  count;  /* number of descriptors in the table */
+    PyJClassInfoObject  *last;   /* borrowed, the most recent lookup */
+} PyJClassInfoTable;
+
+/*
+ * Get the descriptor for a class in the current interpreter, creating it if
+ * necessary. Returns a borrowed reference, or NULL with a python exception set
+ * if the descriptor could not be created.
+ */
+PyJClassInfoObject* PyJClassInfo_Get(JNIEnv*, jclass);
+
+/* Release all the descriptors in a table. Hold the GIL before calling. */
+void PyJClassInfo_ClearTable(PyJClassInfoTable*);
+
+#endif // ndef pyjclassinfo
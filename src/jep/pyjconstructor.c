@@ -34,6 +34,11 @@
  */
 static PyObject* initMethodName = NULL;
 
+#if JEP_VECTORCALL
+static PyObject* pyjconstructor_vectorcall(PyObject*, PyObject *const*,
+        size_t, PyObject*);
+#endif
+
 
 static int pyjconstructor_init(JNIEnv *env, PyJMethodObject *self)
 {
@@ -52,8 +57,9 @@ static int pyjconstructor_init(JNIEnv *env, PyJMethodObject *self)
         goto EXIT_ERROR;
     }
 
-    self->parameters    = (*env)->NewGlobalRef(env, paramArray);
-    self->lenParameters = (*env)->GetArrayLength(env, paramArray);
+    if (!PyJMethod_InitParameters(self, env, paramArray)) {
+        goto EXIT_ERROR;
+    }
     (*env)->PopLocalFrame(env, NULL);
     return 1;
 
@@ -78,11 +84,17 @@ PyObject* PyJConstructor_New(JNIEnv *env, jobject constructor)
     }
 
     pym = PyObject_NEW(PyJMethodObject, &PyJConstructor_Type);
-    pym->rmethod       = (*env)->NewGlobalRef(env, constructor);
+    pym->rmethod       = pyembed_new_ref(env, constructor);
     pym->parameters    = NULL;
-    pym->lenParameters = 0;
+    pym->lenParameters = -1;
     pym->isStatic      = 1;
     pym->returnTypeId  = JOBJECT_ID;
+    pym->gilPolicy     = PYJMETHOD_GIL_RELEASE;
+    pym->gilSamples    = 0;
+    pym->gilInterval   = 0;
+#if JEP_VECTORCALL
+    pym->vectorcall    = pyjconstructor_vectorcall;
+#endif
     if (!initMethodName) {
         initMethodName = PyString_FromString("<init>");
     }
@@ -110,32 +122,29 @@ int PyJConstructor_Check(PyObject* object)
 }
 
 
-static PyObject* pyjconstructor_call(PyJMethodObject *self, PyObject *args,
-                                     PyObject *keywords)
+PyObject* PyJConstructor_Call(PyJMethodObject *self, PyObject *const *args,
+                              Py_ssize_t nargs)
 {
     PyObject      *firstArg    = NULL;
     PyJObject     *clazz       = NULL;
     JNIEnv        *env         = NULL;
     int            pos         = 0;
     jvalue        *jargs       = NULL;
+    jvalue         stackArgs[PYJMETHOD_STACK_ARGS];
     int           foundArray   = 0; /* if params includes pyjarray instance */
+    int           localFrame   = 0; /* if a local frame was pushed */
     PyThreadState *_save       = NULL;
     jobject   obj  = NULL;
     PyObject *pobj = NULL;
 
-    if (keywords != NULL) {
-        PyErr_Format(PyExc_TypeError, "Keywords are not supported.");
-        return NULL;
-    }
-
-    if (self->lenParameters != PyTuple_GET_SIZE(args) - 1) {
+    if (self->lenParameters != nargs - 1) {
         PyErr_Format(PyExc_RuntimeError,
-                     "Invalid number of arguments: %i, expected %i.", (int) PyTuple_GET_SIZE(args),
+                     "Invalid number of arguments: %i, expected %i.", (int) nargs,
                      self->lenParameters + 1);
         return NULL;
     }
 
-    firstArg = PyTuple_GetItem(args, 0);
+    firstArg = args[0];
     if (!PyJClass_Check(firstArg)) {
         PyErr_SetString(PyExc_RuntimeError,
                         "First argument to a java constructor must be a java class.");
@@ -145,37 +154,39 @@ static PyObject* pyjconstructor_call(PyJMethodObject *self, PyObject *args,
     clazz = (PyJObject*) firstArg;
 
 
+    if (self->lenParameters <= PYJMETHOD_STACK_ARGS) {
+        jargs = stackArgs;
+    } else {
+        jargs = (jvalue *) pyembed_scratch_alloc(sizeof(jvalue) *
+                self->lenParameters);
+        if (!jargs) {
+            return NULL;
+        }
+    }
+
     // ------------------------------ build jargs off python values
     env = pyembed_get_env();
-    if ((*env)->PushLocalFrame(env, JLOCAL_REFS + self->lenParameters) != 0) {
-        process_java_exception(env);
-        return NULL;
+    if (self->objectParameters) {
+        if ((*env)->PushLocalFrame(env, JLOCAL_REFS + self->lenParameters) != 0) {
+            process_java_exception(env);
+            goto EXIT_ERROR;
+        }
+        localFrame = 1;
     }
 
-    jargs = (jvalue *) PyMem_Malloc(sizeof(jvalue) * self->lenParameters);
-
     for (pos = 0; pos < self->lenParameters; pos++) {
-        PyObject *param = NULL;
-        int paramTypeId = -1;
-        jclass paramType = (jclass) (*env)->GetObjectArrayElement(env,
-                           self->parameters, pos);
+        PyObject *param = args[pos + 1]; /* borrowed */
+        int paramTypeId = self->parameters[pos].typeId;
 
-        param = PyTuple_GetItem(args, pos + 1); /* borrowed */
-        if (PyErr_Occurred()) {
-            goto EXIT_ERROR;
-        }
-
-        paramTypeId = get_jtype(env, paramType);
         if (paramTypeId == JARRAY_ID) {
             foundArray = 1;
         }
 
-        jargs[pos] = convert_pyarg_jvalue(env, param, paramType, paramTypeId, pos);
+        jargs[pos] = convert_pyarg_jvalue(env, param,
+                                          &self->parameters[pos], pos);
         if (PyErr_Occurred()) {
             goto EXIT_ERROR;
         }
-
-        (*env)->DeleteLocalRef(env, paramType);
     }
 
     Py_UNBLOCK_THREADS;
@@ -191,37 +202,76 @@ static PyObject* pyjconstructor_call(PyJMethodObject *self, PyObject *args,
     // finally, make pyjobject and return
     pobj = PyJObject_New(env, obj);
 
-    // we already closed the local frame, so make
+    // there may not be a local frame, so make
     // sure to delete this local ref.
-    PyMem_Free(jargs);
+    (*env)->DeleteLocalRef(env, obj);
+    if (jargs != stackArgs) {
+        pyembed_scratch_free(jargs);
+    }
 
     // re pin array if needed
     if (foundArray) {
         for (pos = 0; pos < self->lenParameters; pos++) {
-            PyObject *param = PyTuple_GetItem(args, pos);
+            PyObject *param = args[pos + 1];
             if (param && pyjarray_check(param)) {
                 pyjarray_pin((PyJArrayObject *) param);
             }
         }
     }
 
-    (*env)->PopLocalFrame(env, NULL);
+    if (localFrame) {
+        (*env)->PopLocalFrame(env, NULL);
+    }
     return pobj;
 
 EXIT_ERROR:
-    PyMem_Free(jargs);
-    (*env)->PopLocalFrame(env, NULL);
+    if (jargs != stackArgs) {
+        pyembed_scratch_free(jargs);
+    }
+    if (localFrame) {
+        (*env)->PopLocalFrame(env, NULL);
+    }
     return NULL;
 }
 
 
+static PyObject* pyjconstructor_call(PyJMethodObject *self, PyObject *args,
+                                     PyObject *keywords)
+{
+    if (keywords != NULL) {
+        PyErr_Format(PyExc_TypeError, "Keywords are not supported.");
+        return NULL;
+    }
+    return PyJConstructor_Call(self, PySequence_Fast_ITEMS(args),
+                               PyTuple_GET_SIZE(args));
+}
+
+
+#if JEP_VECTORCALL
+static PyObject* pyjconstructor_vectorcall(PyObject *self,
+        PyObject *const *args, size_t nargsf, PyObject *kwnames)
+{
+    if (kwnames != NULL && PyTuple_GET_SIZE(kwnames) > 0) {
+        PyErr_Format(PyExc_TypeError, "Keywords are not supported.");
+        return NULL;
+    }
+    return PyJConstructor_Call((PyJMethodObject*) self, args,
+                               PyVectorcall_NARGS(nargsf));
+}
+#endif
+
+
 PyTypeObject PyJConstructor_Type = {
     PyVarObject_HEAD_INIT(NULL, 0)
     "jep.PyJConstructor",
     sizeof(PyJMethodObject),
     0,
     0,                                       /* tp_dealloc */
+#if JEP_VECTORCALL
+    offsetof(PyJMethodObject, vectorcall),    /* tp_vectorcall_offset */
+#else
     0,                                        /* tp_print */
+#endif
     0,                                        /* tp_getattr */
     0,                                        /* tp_setattr */
     0,                                        /* tp_compare */
@@ -235,7 +285,7 @@ PyTypeObject PyJConstructor_Type = {
     0,                                        /* tp_getattro */
     0,                                        /* tp_setattro */
     0,                                        /* tp_as_buffer */
-    Py_TPFLAGS_DEFAULT,                       /* tp_flags */
+    Py_TPFLAGS_DEFAULT | JEP_TPFLAGS_METHOD,  /* tp_flags */
     "jconstructor",                           /* tp_doc */
     0,                                        /* tp_traverse */
     0,                                        /* tp_clear */
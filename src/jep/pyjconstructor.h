@@ -38,4 +38,10 @@ PyObject* PyJConstructor_New(JNIEnv*, jobject);
 
 int PyJConstructor_Check(PyObject*);
 
+/*
+ * Call a PyJConstructor with an array of nargs arguments where the first
+ * argument is the PyJClass to instantiate.
+ */
+PyObject* PyJConstructor_Call(PyJMethodObject*, PyObject *const*, Py_ssize_t);
+
 #endif // ndef pyjconstructor
@@ -36,14 +36,13 @@
 static void pyjfield_dealloc(PyJFieldObject *self)
 {
 #if USE_DEALLOC
-    JNIEnv *env  = pyembed_get_env();
-    if (env) {
-        if (self->rfield) {
-            (*env)->DeleteGlobalRef(env, self->rfield);
-        }
+    pyembed_release_ref(self->rfield);
+    if (self->init) {
+        pyembed_release_ref(self->fieldType);
     }
 
     Py_CLEAR(self->pyFieldName);
+    Py_CLEAR(self->constant);
 
     PyObject_Del(self);
 #endif
@@ -60,11 +59,14 @@ PyJFieldObject* PyJField_New(JNIEnv *env, jobject rfield)
     }
 
     pyf              = PyObject_NEW(PyJFieldObject, &PyJField_Type);
-    pyf->rfield      = (*env)->NewGlobalRef(env, rfield);
+    pyf->rfield      = pyembed_new_ref(env, rfield);
+    pyf->fieldType   = NULL;
     pyf->pyFieldName = NULL;
     pyf->fieldTypeId = -1;
     pyf->isStatic    = -1;
     pyf->init        = 0;
+    pyf->isConstant  = -1;
+    pyf->constant    = NULL;
 
     // ------------------------------ get field name
 
@@ -88,6 +90,36 @@ EXIT_ERROR:
 }
 
 
+PyJFieldObject* PyJField_NewFromMetadata(JNIEnv *env,
+        JepFieldMetadata *metadata)
+{
+    PyJFieldObject *pyf;
+
+    if (PyType_Ready(&PyJField_Type) < 0) {
+        return NULL;
+    }
+
+    pyf              = PyObject_NEW(PyJFieldObject, &PyJField_Type);
+    pyf->rfield      = NULL;
+    pyf->fieldId     = metadata->fieldId;
+    pyf->fieldType   = pyembed_new_ref(env, metadata->fieldType);
+    pyf->fieldTypeId = metadata->fieldTypeId;
+    pyf->isStatic    = metadata->isStatic;
+    pyf->init        = 1;
+    pyf->isConstant  = metadata->isStatic ? -1 : 0;
+    pyf->constant    = NULL;
+    pyf->pyFieldName = PyString_FromString(metadata->name);
+    if (!pyf->pyFieldName || !pyf->fieldType) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_RuntimeError, "Field type has been unloaded.");
+        }
+        pyjfield_dealloc(pyf);
+        return NULL;
+    }
+    return pyf;
+}
+
+
 static int pyjfield_init(JNIEnv *env, PyJFieldObject *self)
 {
     jint             modifier    = -1;
@@ -133,7 +165,7 @@ static int pyjfield_init(JNIEnv *env, PyJFieldObject *self)
     } else {
         self->isStatic = 0;
     }
-    self->fieldType = (*env)->NewGlobalRef(env, self->fieldType);
+    self->fieldType = pyembed_new_ref(env, self->fieldType);
 
     (*env)->PopLocalFrame(env, NULL);
     self->init = 1;
@@ -150,6 +182,65 @@ EXIT_ERROR:
 }
 
 
+/*
+ * Decides whether the value of a static field never changes so pyjfield_get
+ * can convert it once and return the same python object for every read. Only
+ * static final fields of a primitive type, String or an enum type qualify,
+ * other objects referenced from a final field can still be mutated. Fields
+ * made from the metadata have no reflect/Field, so one is looked up with the
+ * class the field was accessed through. Returns 0 on error.
+ */
+static int pyjfield_init_constant(JNIEnv *env, PyJFieldObject *self,
+                                  jclass clazz)
+{
+    jobject  rfield   = self->rfield;
+    jint     modifier = -1;
+    jboolean isFinal  = JNI_FALSE;
+
+    self->isConstant = 0;
+    if (!self->isStatic) {
+        return 1;
+    }
+    if (self->fieldTypeId == JCLASS_ID || self->fieldTypeId == JARRAY_ID) {
+        return 1;
+    }
+
+    if (!rfield) {
+        rfield = (*env)->ToReflectedField(env, clazz, self->fieldId, JNI_TRUE);
+        if (process_java_exception(env) || !rfield) {
+            return 0;
+        }
+    }
+
+    modifier = java_lang_reflect_Member_getModifiers(env, rfield);
+    if (rfield != self->rfield) {
+        (*env)->DeleteLocalRef(env, rfield);
+    }
+    if (process_java_exception(env)) {
+        return 0;
+    }
+
+    isFinal = java_lang_reflect_Modifier_isFinal(env, modifier);
+    if (process_java_exception(env)) {
+        return 0;
+    }
+    if (!isFinal) {
+        return 1;
+    }
+
+    if (self->fieldTypeId == JOBJECT_ID) {
+        jboolean isEnum = java_lang_Class_isEnum(env, self->fieldType);
+        if (process_java_exception(env)) {
+            return 0;
+        }
+        self->isConstant = isEnum ? 1 : 0;
+    } else {
+        self->isConstant = 1;
+    }
+    return 1;
+}
+
+
 int PyJField_Check(PyObject *obj)
 {
     if (PyObject_TypeCheck(obj, &PyJField_Type)) {
@@ -184,6 +275,16 @@ PyObject* pyjfield_get(PyJFieldObject *self, PyJObject* pyjobject)
         return NULL;
     }
 
+    if (self->constant) {
+        Py_INCREF(self->constant);
+        return self->constant;
+    }
+    if (self->isConstant < 0) {
+        if (!pyjfield_init_constant(env, self, pyjobject->clazz)) {
+            return NULL;
+        }
+    }
+
     switch (self->fieldTypeId) {
 
     case JSTRING_ID: {
@@ -434,6 +535,15 @@ PyObject* pyjfield_get(PyJFieldObject *self, PyJObject* pyjobject)
         Py_RETURN_NONE;
     }
 
+    /*
+     * null is never cached, a static final object field only reads as null
+     * while its class is still being initialized.
+     */
+    if (self->isConstant > 0) {
+        Py_INCREF(result);
+        self->constant = result;
+    }
+
     return result;
 }
 
@@ -458,6 +568,9 @@ int pyjfield_set(PyJFieldObject *self, PyJObject* pyjobject, PyObject *value)
         return -1;
     }
 
+    // JNI ignores final so the cached value would be stale after a set
+    Py_CLEAR(self->constant);
+
     switch (self->fieldTypeId) {
     case JSTRING_ID:
     case JCLASS_ID:
@@ -26,6 +26,7 @@
 */
 
 #include "jep_platform.h"
+#include "jep_metadata.h"
 #include "pyjobject.h"
 
 #ifndef _Included_pyjfield
@@ -44,10 +45,16 @@ typedef struct {
     int               isStatic;            /* -1 if not known,
                                               otherwise 1 or 0 */
     int               init;                /* 1 if init performed */
+    int               isConstant;          /* -1 if not known, 1 if the value
+                                              can be cached, otherwise 0 */
+    PyObject         *constant;            /* cached value of a static final
+                                              field, NULL until first read */
 } PyJFieldObject;
 
 
 PyJFieldObject* PyJField_New(JNIEnv*, jobject);
+/* Create a new, initialized PyJField from the process wide metadata */
+PyJFieldObject* PyJField_NewFromMetadata(JNIEnv*, JepFieldMetadata*);
 int PyJField_Check(PyObject*);
 
 PyObject* pyjfield_get(PyJFieldObject*, PyJObject*);
@@ -100,7 +100,8 @@ PyTypeObject PyJIterator_Type = {
     0,                                        /* tp_getattro */
     0,                                        /* tp_setattro */
     0,                                        /* tp_as_buffer */
-    Py_TPFLAGS_DEFAULT,                       /* tp_flags */
+    Py_TPFLAGS_DEFAULT |
+    Py_TPFLAGS_BASETYPE,                      /* tp_flags */
     "jiterator",                              /* tp_doc */
     0,                                        /* tp_traverse */
     0,                                        /* tp_clear */
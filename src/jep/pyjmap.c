@@ -283,7 +283,8 @@ PyTypeObject PyJMap_Type = {
     0,                                        /* tp_getattro */
     0,                                        /* tp_setattro */
     0,                                        /* tp_as_buffer */
-    Py_TPFLAGS_DEFAULT,                       /* tp_flags */
+    Py_TPFLAGS_DEFAULT |
+    Py_TPFLAGS_BASETYPE,                      /* tp_flags */
     "jmap",                                   /* tp_doc */
     0,                                        /* tp_traverse */
     0,                                        /* tp_clear */
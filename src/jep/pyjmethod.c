@@ -33,6 +33,15 @@
  */
 #include "structmember.h"
 
+#ifndef WIN32
+    #include <time.h>
+#endif
+
+#if JEP_VECTORCALL
+static PyObject* pyjmethod_vectorcall(PyObject*, PyObject *const*, size_t,
+                                      PyObject*);
+#endif
+
 
 // called internally to make new PyJMethodObject instances.
 // throws python exception and returns NULL on error.
@@ -54,12 +63,84 @@ PyJMethodObject* PyJMethod_New(JNIEnv *env, jobject rmethod)
     (*env)->DeleteLocalRef(env, jname);
 
     pym                = PyObject_NEW(PyJMethodObject, &PyJMethod_Type);
-    pym->rmethod       = (*env)->NewGlobalRef(env, rmethod);
+    pym->rmethod       = pyembed_new_ref(env, rmethod);
     pym->parameters    = NULL;
     pym->lenParameters = -1;
     pym->pyMethodName  = pyname;
     pym->isStatic      = -1;
     pym->returnTypeId  = -1;
+    pym->gilPolicy     = PYJMETHOD_GIL_UNKNOWN;
+    pym->gilSamples    = 0;
+    pym->gilInterval   = 0;
+#if JEP_VECTORCALL
+    pym->vectorcall    = pyjmethod_vectorcall;
+#endif
+
+    return pym;
+}
+
+PyJMethodObject* PyJMethod_NewFromMetadata(JNIEnv *env,
+        JepMethodMetadata *metadata, PyObject *name)
+{
+    PyJMethodParameter *parameters = NULL;
+    PyJMethodObject    *pym        = NULL;
+    int                 pos;
+
+    if (PyType_Ready(&PyJMethod_Type) < 0) {
+        return NULL;
+    }
+
+    if (metadata->lenParameters > 0) {
+        parameters = PyMem_Malloc(sizeof(PyJMethodParameter)
+                                  * metadata->lenParameters);
+        if (!parameters) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+    }
+    for (pos = 0; pos < metadata->lenParameters; pos++) {
+        /* promote the weak reference held by the metadata */
+        parameters[pos].type   = pyembed_new_ref(env,
+                             metadata->parameters[pos].type);
+        parameters[pos].typeId = metadata->parameters[pos].typeId;
+        parameters[pos].assignable = NULL;
+        if (!parameters[pos].type) {
+            while (--pos >= 0) {
+                pyembed_release_ref(parameters[pos].type);
+            }
+            PyMem_Free(parameters);
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Parameter type has been unloaded.");
+            return NULL;
+        }
+    }
+
+    pym                   = PyObject_NEW(PyJMethodObject, &PyJMethod_Type);
+    pym->methodId         = metadata->methodId;
+    pym->rmethod          = NULL;
+    pym->returnTypeId     = metadata->returnTypeId;
+    Py_INCREF(name);
+    pym->pyMethodName     = name;
+    pym->parameters       = parameters;
+    pym->lenParameters    = metadata->lenParameters;
+    pym->isStatic         = metadata->isStatic;
+    pym->objectParameters = 0;
+    pym->gilPolicy        = PYJMETHOD_GIL_UNKNOWN;
+    pym->gilSamples       = 0;
+    pym->gilInterval      = 0;
+    for (pos = 0; pos < metadata->lenParameters; pos++) {
+        switch (parameters[pos].typeId) {
+        case JOBJECT_ID:
+        case JSTRING_ID:
+        case JARRAY_ID:
+        case JCLASS_ID:
+            pym->objectParameters = 1;
+            break;
+        }
+    }
+#if JEP_VECTORCALL
+    pym->vectorcall       = pyjmethod_vectorcall;
+#endif
 
     return pym;
 }
@@ -89,15 +170,6 @@ static int pyjmethod_init(JNIEnv *env, PyJMethodObject *self)
         goto EXIT_ERROR;
     }
 
-    paramArray = java_lang_reflect_Method_getParameterTypes(env, self->rmethod);
-    if (process_java_exception(env) || !paramArray) {
-        goto EXIT_ERROR;
-    }
-
-    self->parameters    = (*env)->NewGlobalRef(env, paramArray);
-    self->lenParameters = (*env)->GetArrayLength(env, paramArray);
-
-
     modifier = java_lang_reflect_Member_getModifiers(env, self->rmethod);
     if (process_java_exception(env)) {
         goto EXIT_ERROR;
@@ -114,6 +186,19 @@ static int pyjmethod_init(JNIEnv *env, PyJMethodObject *self)
         self->isStatic = 0;
     }
 
+    /*
+     * The parameters are resolved last because a method is considered
+     * initialized once lenParameters is set.
+     */
+    paramArray = java_lang_reflect_Method_getParameterTypes(env, self->rmethod);
+    if (process_java_exception(env) || !paramArray) {
+        goto EXIT_ERROR;
+    }
+
+    if (!PyJMethod_InitParameters(self, env, paramArray)) {
+        goto EXIT_ERROR;
+    }
+
     (*env)->PopLocalFrame(env, NULL);
     return 1;
 
@@ -127,19 +212,73 @@ EXIT_ERROR:
 }
 
 
-static void pyjmethod_dealloc(PyJMethodObject *self)
+int PyJMethod_InitParameters(PyJMethodObject *self, JNIEnv *env,
+                             jobjectArray paramArray)
 {
-#if USE_DEALLOC
-    JNIEnv *env  = pyembed_get_env();
-    if (env) {
-        if (self->parameters) {
-            (*env)->DeleteGlobalRef(env, self->parameters);
+    PyJMethodParameter *parameters = NULL;
+    int                 len        = 0;
+    int                 pos        = 0;
+
+    len = (*env)->GetArrayLength(env, paramArray);
+    if (len > 0) {
+        parameters = PyMem_Malloc(sizeof(PyJMethodParameter) * len);
+        if (!parameters) {
+            PyErr_NoMemory();
+            return 0;
         }
-        if (self->rmethod) {
-            (*env)->DeleteGlobalRef(env, self->rmethod);
+    }
+
+    for (pos = 0; pos < len; pos++) {
+        jclass paramType = (jclass) (*env)->GetObjectArrayElement(env,
+                           paramArray, pos);
+        if (process_java_exception(env) || !paramType) {
+            goto EXIT_ERROR;
         }
+
+        parameters[pos].typeId = get_jtype(env, paramType);
+        if (process_java_exception(env)) {
+            (*env)->DeleteLocalRef(env, paramType);
+            goto EXIT_ERROR;
+        }
+        parameters[pos].type = pyembed_new_ref(env, paramType);
+        parameters[pos].assignable = NULL;
+        (*env)->DeleteLocalRef(env, paramType);
     }
 
+    self->objectParameters = 0;
+    for (pos = 0; pos < len; pos++) {
+        switch (parameters[pos].typeId) {
+        case JOBJECT_ID:
+        case JSTRING_ID:
+        case JARRAY_ID:
+        case JCLASS_ID:
+            self->objectParameters = 1;
+            break;
+        }
+    }
+    self->parameters    = parameters;
+    self->lenParameters = len;
+    return 1;
+
+EXIT_ERROR:
+    while (--pos >= 0) {
+        pyembed_release_ref(parameters[pos].type);
+    }
+    PyMem_Free(parameters);
+    return 0;
+}
+
+
+static void pyjmethod_dealloc(PyJMethodObject *self)
+{
+#if USE_DEALLOC
+    int pos;
+    for (pos = 0; pos < self->lenParameters; pos++) {
+        pyembed_release_ref(self->parameters[pos].type);
+    }
+    pyembed_release_ref(self->rmethod);
+
+    PyMem_Free(self->parameters);
     Py_CLEAR(self->pyMethodName);
 
     PyObject_Del(self);
@@ -154,7 +293,7 @@ int PyJMethod_Check(PyObject *obj)
 
 int PyJMethod_GetParameterCount(PyJMethodObject *method, JNIEnv *env)
 {
-    if (!method->parameters && !pyjmethod_init(env, method)) {
+    if (method->lenParameters < 0 && !pyjmethod_init(env, method)) {
         return -1;
     }
     return method->lenParameters;
@@ -162,31 +301,20 @@ int PyJMethod_GetParameterCount(PyJMethodObject *method, JNIEnv *env)
 
 
 int PyJMethod_CheckArguments(PyJMethodObject* method, JNIEnv *env,
-                             PyObject* args)
+                             PyObject *const *args, Py_ssize_t nargs)
 {
     int matchTotal = 1;
     int parampos;
 
-    if (PyJMethod_GetParameterCount(method, env) != (PyTuple_Size(args) - 1)) {
+    if (PyJMethod_GetParameterCount(method, env) != (nargs - 1)) {
         return 0;
     }
 
     for (parampos = 0; parampos < method->lenParameters; parampos += 1) {
-        PyObject* param       = PyTuple_GetItem(args, parampos + 1);
-        int       paramTypeId;
-        int       match;
-        jclass    paramType   = (jclass) (*env)->GetObjectArrayElement(env,
-                                method->parameters, parampos);
-
-        if (process_java_exception(env) || !paramType) {
-            match = 0;
-            break;
-        }
-
-        paramTypeId = get_jtype(env, paramType);
-
-        match = pyarg_matches_jtype(env, param, paramType, paramTypeId);
-        (*env)->DeleteLocalRef(env, paramType);
+        PyObject* param = args[parampos + 1];
+        int       match = pyarg_matches_jtype(env, param,
+                                              method->parameters[parampos].type,
+                                              method->parameters[parampos].typeId);
         if (PyErr_Occurred()) {
             match = 0;
             break;
@@ -201,6 +329,211 @@ int PyJMethod_CheckArguments(PyJMethodObject* method, JNIEnv *env,
     return matchTotal;
 }
 
+/* A monotonic clock in nanoseconds for timing java calls. */
+static jlong pyjmethod_nanos(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (jlong) (count.QuadPart * 1e9 / frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (jlong) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+
+/*
+ * Check if the adaptive policy may learn to keep the GIL for a method. A call
+ * that enters python while the GIL is kept would deadlock. Python objects only
+ * reach java as arguments or as proxies, so methods that take objects or
+ * arrays, methods of proxies and methods that a subclass could override are
+ * suspect. Static methods are left out too, they are often utilities that
+ * block like Thread.sleep() or reach other interpreters, and can be named in
+ * keepGILMethods instead. Returns 1 if the method may call python or block,
+ * 0 if not, or -1 with a python exception set.
+ */
+static int pyjmethod_may_call_python(JNIEnv *env, PyJMethodObject *self,
+                                     PyJObject *instance)
+{
+    int      pos;
+    jint     modifiers;
+    jboolean isFinal = JNI_FALSE;
+
+    for (pos = 0; pos < self->lenParameters; pos++) {
+        switch (self->parameters[pos].typeId) {
+        case JOBJECT_ID:
+        case JARRAY_ID:
+            return 1;
+        }
+    }
+    if (self->isStatic) {
+        return 1;
+    }
+    if ((*env)->IsAssignableFrom(env, instance->clazz, JPROXY_TYPE)) {
+        return 1;
+    }
+    modifiers = java_lang_Class_getModifiers(env, instance->clazz);
+    if (!(*env)->ExceptionCheck(env)) {
+        isFinal = java_lang_reflect_Modifier_isFinal(env, modifiers);
+    }
+    if (process_java_exception(env)) {
+        return -1;
+    }
+    return !isFinal;
+}
+
+
+/*
+ * Choose whether the calls to a method release the GIL, see
+ * PYJMETHOD_GIL_RELEASE. Methods in the keepGILMethods set of the interpreter
+ * are found by the name of the class that declares them and the method name.
+ * Returns 0 on success or -1 with a python exception set.
+ */
+static int pyjmethod_init_gil_policy(JNIEnv *env, PyJMethodObject *self,
+                                     PyJObject *instance)
+{
+    JepThread *jepThread = pyembed_get_interpreter_jepthread();
+    int        keep      = 0;
+
+    if (!jepThread) {
+        return -1;
+    }
+    if (jepThread->keepGILMethods) {
+        jobject   rmethod   = self->rmethod;
+        jclass    declaring = NULL;
+        jstring   jname     = NULL;
+        PyObject *className = NULL;
+        PyObject *key       = NULL;
+
+        if ((*env)->PushLocalFrame(env, JLOCAL_REFS) != 0) {
+            process_java_exception(env);
+            return -1;
+        }
+        if (!rmethod) {
+            rmethod = (*env)->ToReflectedMethod(env, instance->clazz,
+                                                self->methodId,
+                                                (jboolean) self->isStatic);
+        }
+        if (rmethod) {
+            declaring = java_lang_reflect_Member_getDeclaringClass(env, rmethod);
+        }
+        if (declaring) {
+            jname = java_lang_Class_getName(env, declaring);
+        }
+        if (!process_java_exception(env) && jname) {
+            className = jstring_To_PyObject(env, jname);
+        }
+        (*env)->PopLocalFrame(env, NULL);
+        if (!className) {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_RuntimeError,
+                                "Unable to find the class of a method.");
+            }
+            return -1;
+        }
+
+        key = PyString_FromFormat("%s.%s", PyString_AsString(className),
+                                  PyString_AsString(self->pyMethodName));
+        Py_DECREF(className);
+        if (!key) {
+            return -1;
+        }
+        keep = PySet_Contains(jepThread->keepGILMethods, key);
+        Py_DECREF(key);
+        if (keep < 0) {
+            return -1;
+        }
+    }
+
+    if (keep) {
+        self->gilPolicy = PYJMETHOD_GIL_KEEP;
+    } else if (jepThread->adaptiveGIL) {
+        int mayCallPython = pyjmethod_may_call_python(env, self, instance);
+        if (mayCallPython < 0) {
+            return -1;
+        }
+        self->gilPolicy = mayCallPython ? PYJMETHOD_GIL_RELEASE
+                          : PYJMETHOD_GIL_ADAPTIVE;
+    } else {
+        self->gilPolicy = PYJMETHOD_GIL_RELEASE;
+    }
+    return 0;
+}
+
+
+/*
+ * Check if a call releases the GIL. Returns 0 if the GIL is kept, 1 if it is
+ * released or 2 if it is released and the call is timed, which is every call
+ * while an adaptive method is learning and a call every gilInterval calls
+ * once it has learned to keep the GIL.
+ */
+static int pyjmethod_release_gil(PyJMethodObject *self)
+{
+    switch (self->gilPolicy) {
+    case PYJMETHOD_GIL_KEEP:
+        return 0;
+    case PYJMETHOD_GIL_ADAPTIVE:
+        return 2;
+    case PYJMETHOD_GIL_LEARNED:
+        return --self->gilSamples > 0 ? 0 : 2;
+    }
+    return 1;
+}
+
+
+/*
+ * Record how long a timed call to an adaptive method took. One slow call is
+ * enough to always release the GIL for the method. Each fast call of a
+ * learned method doubles the calls until the next sample.
+ */
+static void pyjmethod_sample_gil(PyJMethodObject *self, jlong nanos)
+{
+    if (nanos > PYJMETHOD_GIL_KEEP_NANOS) {
+        self->gilPolicy = PYJMETHOD_GIL_RELEASE;
+    } else if (self->gilPolicy == PYJMETHOD_GIL_LEARNED) {
+        if (self->gilInterval < PYJMETHOD_GIL_RESAMPLE_MAX) {
+            self->gilInterval *= 2;
+        }
+        self->gilSamples = self->gilInterval;
+    } else if (++self->gilSamples >= PYJMETHOD_GIL_SAMPLES) {
+        self->gilPolicy   = PYJMETHOD_GIL_LEARNED;
+        self->gilInterval = PYJMETHOD_GIL_RESAMPLE;
+        self->gilSamples  = self->gilInterval;
+    }
+}
+
+
+/*
+ * Release the GIL around the java call in pyjmethod_call_internal() unless the
+ * method keeps it. The calls of adaptive methods are timed without the GIL
+ * and recorded after it is reacquired.
+ */
+#define PYJMETHOD_UNBLOCK_THREADS\
+    release = pyjmethod_release_gil(self);\
+    if (release) {\
+        timed = release == 2;\
+        Py_UNBLOCK_THREADS;\
+        if (timed) {\
+            start = pyjmethod_nanos();\
+        }\
+    }
+
+#define PYJMETHOD_BLOCK_THREADS\
+    if (_save) {\
+        if (timed) {\
+            start = pyjmethod_nanos() - start;\
+        }\
+        Py_BLOCK_THREADS;\
+        _save = NULL;\
+        if (timed) {\
+            pyjmethod_sample_gil(self, start);\
+        }\
+    }
+
+
 // pyjmethod_call. where the magic happens.
 //
 // okay, some of the magic -- we already the methodId, so we don't have
@@ -208,9 +541,9 @@ int PyJMethod_CheckArguments(PyJMethodObject* method, JNIEnv *env,
 // check them against the java args, and call the java function.
 //
 // easy. :-)
-static PyObject* pyjmethod_call(PyJMethodObject *self,
-                                PyObject *args,
-                                PyObject *keywords)
+static PyObject* pyjmethod_call_internal(PyJMethodObject *self,
+        PyObject *const *args,
+        Py_ssize_t nargs)
 {
     JNIEnv        *env         = NULL;
     PyObject      *firstArg    = NULL;
@@ -218,25 +551,26 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
     PyObject      *result      = NULL;
     int            pos         = 0;
     jvalue        *jargs       = NULL;
+    jvalue         stackArgs[PYJMETHOD_STACK_ARGS];
     int            foundArray  = 0;   /* if params includes pyjarray instance */
+    int            localFrame  = 0;   /* if a local frame was pushed */
     PyThreadState *_save       = NULL;
-
-    if (keywords != NULL) {
-        PyErr_Format(PyExc_RuntimeError, "Keywords are not supported.");
-        return NULL;
-    }
+    int            timed       = 0;   /* if the java call is timed */
+    int            release     = 0;   /* see pyjmethod_release_gil() */
+    jlong          start       = 0;
 
     env = pyembed_get_env();
 
-    if (PyJMethod_GetParameterCount(self, env) != (PyTuple_Size(args) - 1)) {
-        PyErr_Format(PyExc_RuntimeError,
-                     "Invalid number of arguments: %i, expected %i.",
-                     (int) PyTuple_GET_SIZE(args),
-                     self->lenParameters + 1);
+    if (PyJMethod_GetParameterCount(self, env) != (nargs - 1)) {
+        if (!PyErr_Occurred()) {
+            PyErr_Format(PyExc_RuntimeError,
+                         "Invalid number of arguments: %i, expected %i.",
+                         (int) nargs, self->lenParameters + 1);
+        }
         return NULL;
     }
 
-    firstArg = PyTuple_GetItem(args, 0);
+    firstArg = args[0];
     if (!PyJObject_Check(firstArg)) {
         PyErr_SetString(PyExc_RuntimeError,
                         "First argument to a java method must be a java object.");
@@ -253,36 +587,49 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
         return NULL;
     }
 
-    jargs = (jvalue *) PyMem_Malloc(sizeof(jvalue) * self->lenParameters);
-
-    // ------------------------------ build jargs off python values
-
-    if ((*env)->PushLocalFrame(env, JLOCAL_REFS + self->lenParameters) != 0) {
-        process_java_exception(env);
+    if (self->gilPolicy == PYJMETHOD_GIL_UNKNOWN
+            && pyjmethod_init_gil_policy(env, self, instance) != 0) {
         return NULL;
     }
-    for (pos = 0; pos < self->lenParameters; pos++) {
-        PyObject *param = NULL;
-        int paramTypeId = -1;
-        jclass paramType = (jclass) (*env)->GetObjectArrayElement(env,
-                           self->parameters, pos);
 
-        param = PyTuple_GetItem(args, pos + 1);               /* borrowed */
-        if (PyErr_Occurred()) {
+    if (self->lenParameters <= PYJMETHOD_STACK_ARGS) {
+        jargs = stackArgs;
+    } else {
+        jargs = (jvalue *) pyembed_scratch_alloc(sizeof(jvalue) *
+                self->lenParameters);
+        if (!jargs) {
+            return NULL;
+        }
+    }
+
+    // ------------------------------ build jargs off python values
+
+    /*
+     * Converting primitive arguments does not create any local references,
+     * the return value is deleted below and process_java_exception() releases
+     * the references it makes, so the frame is only needed when objects are
+     * passed to java.
+     */
+    if (self->objectParameters) {
+        if ((*env)->PushLocalFrame(env, JLOCAL_REFS + self->lenParameters) != 0) {
+            process_java_exception(env);
             goto EXIT_ERROR;
         }
+        localFrame = 1;
+    }
+    for (pos = 0; pos < self->lenParameters; pos++) {
+        PyObject *param = args[pos + 1];                      /* borrowed */
+        int paramTypeId = self->parameters[pos].typeId;
 
-        paramTypeId = get_jtype(env, paramType);
         if (paramTypeId == JARRAY_ID) {
             foundArray = 1;
         }
 
-        jargs[pos] = convert_pyarg_jvalue(env, param, paramType, paramTypeId, pos);
+        jargs[pos] = convert_pyarg_jvalue(env, param,
+                                          &self->parameters[pos], pos);
         if (PyErr_Occurred()) {
             goto EXIT_ERROR;
         }
-
-        (*env)->DeleteLocalRef(env, paramType);
     }
 
 
@@ -292,7 +639,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JSTRING_ID: {
         jstring jstr;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             jstr = (jstring) (*env)->CallStaticObjectMethodA(
@@ -316,7 +663,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                            jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env) && jstr != NULL) {
             result = jstring_To_PyObject(env, jstr);
             (*env)->DeleteLocalRef(env, jstr);
@@ -327,7 +674,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JARRAY_ID: {
         jobjectArray obj;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             obj = (jobjectArray) (*env)->CallStaticObjectMethodA(
@@ -350,9 +697,10 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                           jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env) && obj != NULL) {
             result = pyjarray_new(env, obj);
+            (*env)->DeleteLocalRef(env, obj);
         }
 
         break;
@@ -360,7 +708,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JCLASS_ID: {
         jobject obj;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             obj = (*env)->CallStaticObjectMethodA(
@@ -381,9 +729,10 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                                 jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env) && obj != NULL) {
             result = PyJObject_NewClass(env, obj);
+            (*env)->DeleteLocalRef(env, obj);
         }
 
         break;
@@ -391,7 +740,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JOBJECT_ID: {
         jobject obj;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             obj = (*env)->CallStaticObjectMethodA(
@@ -412,9 +761,10 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                                 jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env) && obj != NULL) {
             result = convert_jobject_pyobject(env, obj);
+            (*env)->DeleteLocalRef(env, obj);
         }
 
         break;
@@ -422,7 +772,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JINT_ID: {
         jint ret;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             ret = (*env)->CallStaticIntMethodA(
@@ -443,7 +793,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                              jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env)) {
             result = Py_BuildValue("i", ret);
         }
@@ -453,7 +803,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JBYTE_ID: {
         jbyte ret;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             ret = (*env)->CallStaticByteMethodA(
@@ -474,7 +824,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                               jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env)) {
             result = Py_BuildValue("i", ret);
         }
@@ -484,7 +834,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JCHAR_ID: {
         jchar ret;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             ret = (*env)->CallStaticCharMethodA(
@@ -505,7 +855,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                               jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env)) {
             result = jchar_To_PyObject(ret);
         }
@@ -514,7 +864,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JSHORT_ID: {
         jshort ret;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             ret = (*env)->CallStaticShortMethodA(
@@ -535,7 +885,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                                jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env)) {
             result = Py_BuildValue("i", (int) ret);
         }
@@ -545,7 +895,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JDOUBLE_ID: {
         jdouble ret;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             ret = (*env)->CallStaticDoubleMethodA(
@@ -566,7 +916,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                                 jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env)) {
             result = PyFloat_FromDouble(ret);
         }
@@ -576,7 +926,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JFLOAT_ID: {
         jfloat ret;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             ret = (*env)->CallStaticFloatMethodA(
@@ -597,7 +947,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                                jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env)) {
             result = PyFloat_FromDouble((double) ret);
         }
@@ -607,7 +957,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JLONG_ID: {
         jlong ret;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             ret = (*env)->CallStaticLongMethodA(
@@ -628,7 +978,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                               jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env)) {
             result = PyLong_FromLongLong(ret);
         }
@@ -638,7 +988,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
 
     case JBOOLEAN_ID: {
         jboolean ret;
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         if (self->isStatic)
             ret = (*env)->CallStaticBooleanMethodA(
@@ -659,7 +1009,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                                  jargs);
         }
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         if (!process_java_exception(env)) {
             result = PyBool_FromLong(ret);
         }
@@ -668,7 +1018,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
     }
 
     default:
-        Py_UNBLOCK_THREADS;
+        PYJMETHOD_UNBLOCK_THREADS;
 
         // i hereby anoint thee a void method
         if (self->isStatic)
@@ -682,13 +1032,17 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
                                     self->methodId,
                                     jargs);
 
-        Py_BLOCK_THREADS;
+        PYJMETHOD_BLOCK_THREADS;
         process_java_exception(env);
         break;
     }
 
-    PyMem_Free(jargs);
-    (*env)->PopLocalFrame(env, NULL);
+    if (jargs != stackArgs) {
+        pyembed_scratch_free(jargs);
+    }
+    if (localFrame) {
+        (*env)->PopLocalFrame(env, NULL);
+    }
 
     if (PyErr_Occurred()) {
         return NULL;
@@ -697,7 +1051,7 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
     // re pin array objects if needed
     if (foundArray) {
         for (pos = 0; pos < self->lenParameters; pos++) {
-            PyObject *param = PyTuple_GetItem(args, pos + 1);     /* borrowed */
+            PyObject *param = args[pos + 1];                      /* borrowed */
             if (param && pyjarray_check(param)) {
                 pyjarray_pin((PyJArrayObject *) param);
             }
@@ -711,11 +1065,71 @@ static PyObject* pyjmethod_call(PyJMethodObject *self,
     return result;
 
 EXIT_ERROR:
-    PyMem_Free(jargs);
-    (*env)->PopLocalFrame(env, NULL);
+    if (jargs != stackArgs) {
+        pyembed_scratch_free(jargs);
+    }
+    if (localFrame) {
+        (*env)->PopLocalFrame(env, NULL);
+    }
     return NULL;
 }
 
+
+PyObject* PyJMethod_Call(PyJMethodObject *self, PyObject *const *args,
+                         Py_ssize_t nargs)
+{
+    if (PyJConstructor_Check((PyObject*) self)) {
+        return PyJConstructor_Call(self, args, nargs);
+    }
+    return pyjmethod_call_internal(self, args, nargs);
+}
+
+
+static PyObject* pyjmethod_call(PyJMethodObject *self,
+                                PyObject *args,
+                                PyObject *keywords)
+{
+    if (keywords != NULL) {
+        PyErr_Format(PyExc_RuntimeError, "Keywords are not supported.");
+        return NULL;
+    }
+    return pyjmethod_call_internal(self, PySequence_Fast_ITEMS(args),
+                                   PyTuple_GET_SIZE(args));
+}
+
+
+#if JEP_VECTORCALL
+static PyObject* pyjmethod_vectorcall(PyObject *self, PyObject *const *args,
+                                      size_t nargsf, PyObject *kwnames)
+{
+    if (kwnames != NULL && PyTuple_GET_SIZE(kwnames) > 0) {
+        PyErr_Format(PyExc_RuntimeError, "Keywords are not supported.");
+        return NULL;
+    }
+    return pyjmethod_call_internal((PyJMethodObject*) self, args,
+                                   PyVectorcall_NARGS(nargsf));
+}
+#endif
+
+
+/*
+ * Binds the method to obj the same way a python function is bound when it
+ * is found on a type, so java methods can be used as method descriptors.
+ */
+static PyObject* pyjmethod_descr_get(PyObject *self, PyObject *obj,
+                                     PyObject *type)
+{
+    if (obj == NULL || obj == Py_None) {
+        Py_INCREF(self);
+        return self;
+    }
+#if PY_MAJOR_VERSION >= 3
+    return PyMethod_New(self, obj);
+#else
+    return PyMethod_New(self, obj, type);
+#endif
+}
+
 static PyMemberDef pyjmethod_members[] = {
     {
         "__name__", T_OBJECT_EX, offsetof(PyJMethodObject, pyMethodName), READONLY,
@@ -731,7 +1145,11 @@ PyTypeObject PyJMethod_Type = {
     sizeof(PyJMethodObject),
     0,
     (destructor) pyjmethod_dealloc,           /* tp_dealloc */
+#if JEP_VECTORCALL
+    offsetof(PyJMethodObject, vectorcall),    /* tp_vectorcall_offset */
+#else
     0,                                        /* tp_print */
+#endif
     0,                                        /* tp_getattr */
     0,                                        /* tp_setattr */
     0,                                        /* tp_compare */
@@ -745,7 +1163,7 @@ PyTypeObject PyJMethod_Type = {
     0,                                        /* tp_getattro */
     0,                                        /* tp_setattro */
     0,                                        /* tp_as_buffer */
-    Py_TPFLAGS_DEFAULT,                       /* tp_flags */
+    Py_TPFLAGS_DEFAULT | JEP_TPFLAGS_METHOD,  /* tp_flags */
     "jmethod",                                /* tp_doc */
     0,                                        /* tp_traverse */
     0,                                        /* tp_clear */
@@ -758,7 +1176,7 @@ PyTypeObject PyJMethod_Type = {
     0,                                        /* tp_getset */
     0,                                        /* tp_base */
     0,                                        /* tp_dict */
-    0,                                        /* tp_descr_get */
+    pyjmethod_descr_get,                      /* tp_descr_get */
     0,                                        /* tp_descr_set */
     0,                                        /* tp_dictoffset */
     0,                                        /* tp_init */
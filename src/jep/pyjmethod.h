@@ -26,6 +26,7 @@
 */
 
 #include "jep_platform.h"
+#include "jep_metadata.h"
 #include "pyjobject.h"
 
 #ifndef _Included_pyjmethod
@@ -34,6 +35,62 @@
 
 extern PyTypeObject PyJMethod_Type;
 
+/*
+ * Calls to methods with at most this many parameters convert the arguments
+ * into a buffer on the stack, methods with more parameters use
+ * pyembed_scratch_alloc().
+ */
+#define PYJMETHOD_STACK_ARGS 8
+
+/*
+ * The precomputed type of a single parameter of a java method. Resolving these
+ * once when the method is initialized means calls do not need to reflect on
+ * the parameter types.
+ */
+typedef struct {
+    jclass            type;                /* global ref to parameter class */
+    int               typeId;              /* type id of parameter */
+    PyJClassInfoObject *assignable;        /* borrowed, the class of the last
+                                              PyJObject that was converted
+                                              for this parameter */
+} PyJMethodParameter;
+
+/*
+ * Convert a python argument to the type of a parameter. The last parameter is
+ * the position of the argument for error messages. Returns uninitialized on
+ * error and raises a python exception.
+ */
+jvalue convert_pyarg_jvalue(JNIEnv*, PyObject*, PyJMethodParameter*, int);
+
+/*
+ * Whether calls to a java method release the GIL. By default the GIL is
+ * released for every call so other python threads can run while java works,
+ * but for trivial methods releasing and reacquiring the GIL costs more than
+ * the call. Methods named in JepConfig.addKeepGILMethods(String...) keep the
+ * GIL. When the interpreter uses the adaptive policy, see
+ * JepConfig.setAdaptiveGIL(boolean), the first PYJMETHOD_GIL_SAMPLES calls of
+ * every method are timed and the method keeps the GIL if none of them took
+ * longer than PYJMETHOD_GIL_KEEP_NANOS. A method that learned to keep the GIL
+ * still releases it and is timed again every so often, starting after
+ * PYJMETHOD_GIL_RESAMPLE calls and doubling up to PYJMETHOD_GIL_RESAMPLE_MAX
+ * calls while the method stays fast. Any slow call releases the GIL for the
+ * method from then on. Only instance methods of final classes that take
+ * primitives, strings or classes use the adaptive policy, static methods,
+ * methods of proxies and methods that take objects or arrays or could be
+ * overridden always release the GIL unless they are named. The policy is
+ * chosen on the first call of each method. Constructors always release the
+ * GIL.
+ */
+#define PYJMETHOD_GIL_UNKNOWN        -1
+#define PYJMETHOD_GIL_RELEASE         0
+#define PYJMETHOD_GIL_KEEP            1
+#define PYJMETHOD_GIL_ADAPTIVE        2
+#define PYJMETHOD_GIL_LEARNED         3
+#define PYJMETHOD_GIL_SAMPLES        16
+#define PYJMETHOD_GIL_KEEP_NANOS   1000
+#define PYJMETHOD_GIL_RESAMPLE       64
+#define PYJMETHOD_GIL_RESAMPLE_MAX 4096
+
 /*
  * A callable python object which wraps a java method and is dynamically added
  * to a PyJObject using setattr. Most of the fields in this object are lazy
@@ -46,14 +103,41 @@ typedef struct {
     jobject           rmethod;             /* reflect/Method object */
     int               returnTypeId;        /* type id of return */
     PyObject         *pyMethodName;        /* python name... :-) */
-    jobjectArray      parameters;          /* array of jclass parameter types */
-    int               lenParameters;       /* length of parameters above */
+    PyJMethodParameter *parameters;        /* array of parameter types */
+    int               lenParameters;       /* length of parameters, -1 if not
+                                              initialized */
+    int               objectParameters;    /* if any parameter is an object,
+                                              primitives need no local frame */
     int               isStatic;            /* if method is static */
+    int               gilPolicy;           /* PYJMETHOD_GIL_*, whether calls
+                                              release the GIL */
+    int               gilSamples;          /* number of calls timed by the
+                                              adaptive policy, or calls left
+                                              until the next sample once
+                                              learned */
+    int               gilInterval;         /* calls between the samples of a
+                                              learned method */
+#if JEP_VECTORCALL
+    vectorcallfunc    vectorcall;          /* PEP 590 entry point */
+#endif
 } PyJMethodObject;
 
 /* Create a new PyJMethod from a java.lang.reflect.Method*/
 PyJMethodObject* PyJMethod_New(JNIEnv*, jobject);
 
+/*
+ * Create a new, fully initialized PyJMethod from the process wide metadata of
+ * a method without any reflection. The name is the python name of the method.
+ */
+PyJMethodObject* PyJMethod_NewFromMetadata(JNIEnv*, JepMethodMetadata*,
+        PyObject*);
+
+/*
+ * Fill in the parameters, lenParameters and objectParameters of a method from an array of
+ * java.lang.Class objects. Returns 1 if successful, 0 if failed.
+ */
+int PyJMethod_InitParameters(PyJMethodObject*, JNIEnv*, jobjectArray);
+
 /* Check if the arg is a PyJMethodObject */
 int PyJMethod_Check(PyObject *obj);
 
@@ -64,7 +148,16 @@ int PyJMethod_Check(PyObject *obj);
 int PyJMethod_GetParameterCount(PyJMethodObject*, JNIEnv*);
 
 /*
- * Check if a method is compatible with the types of a tuple of arguments.
+ * Call a PyJMethod or PyJConstructor with an array of nargs arguments, the
+ * first argument must be the instance the method is called on or the class
+ * for constructors and static methods. This is the implementation of both
+ * the tuple and vectorcall entry points and can be used to avoid building a
+ * tuple when the arguments are already in an array.
+ */
+PyObject* PyJMethod_Call(PyJMethodObject*, PyObject *const*, Py_ssize_t);
+
+/*
+ * Check if a method is compatible with the types of an array of arguments.
  * This will return a 0 if the arguments are not valid for this method and a
  * positive integer if the arguments are valid. Larger numbers indicate a better
  * match between the arguments and the expected parameter types. This function
@@ -72,6 +165,7 @@ int PyJMethod_GetParameterCount(PyJMethodObject*, JNIEnv*);
  * does not need to be called before using calling this method, it is only
  * necessary for resolving method overloading.
  */
-int PyJMethod_CheckArguments(PyJMethodObject*, JNIEnv*, PyObject*);
+int PyJMethod_CheckArguments(PyJMethodObject*, JNIEnv*, PyObject *const*,
+                             Py_ssize_t);
 
 #endif // ndef pyjmethod
@@ -27,6 +27,183 @@
 
 #include "Jep.h"
 
+#if JEP_VECTORCALL
+static PyObject* pyjmultimethod_vectorcall(PyObject*, PyObject *const*, size_t,
+        PyObject*);
+#endif
+
+/*
+ * Returns the java class that is used as part of the cache key for an
+ * argument, or NULL if the python type of the argument is enough.
+ */
+static jclass pyjmultimethod_cache_class(PyObject *arg)
+{
+    if (pyjarray_check(arg)) {
+        return ((PyJArrayObject*) arg)->clazz;
+    } else if (PyJObject_Check(arg) && !PyJClass_Check(arg)) {
+        return ((PyJObject*) arg)->clazz;
+    }
+    return NULL;
+}
+
+/*
+ * Strings of length one can match a java char so the length is significant
+ * when choosing a method.
+ */
+static int pyjmultimethod_cache_is_char(PyObject *arg)
+{
+    if (PyString_Check(arg)) {
+        return PyString_GET_SIZE(arg) == 1;
+    }
+#if PY_MAJOR_VERSION < 3
+    if (PyUnicode_Check(arg)) {
+        return PyUnicode_GET_SIZE(arg) == 1;
+    }
+#endif
+    return 0;
+}
+
+/*
+ * Lists and tuples are matched against primitive arrays by their first item,
+ * see pyarg_matches_jtype(), so its type is significant. Returns a borrowed
+ * reference or NULL if the argument is not a list or tuple or is empty.
+ */
+static PyTypeObject* pyjmultimethod_cache_item_type(PyObject *arg)
+{
+    if ((PyList_Check(arg) || PyTuple_Check(arg))
+            && PySequence_Fast_GET_SIZE(arg) > 0) {
+        return Py_TYPE(PySequence_Fast_GET_ITEM(arg, 0));
+    }
+    return NULL;
+}
+
+static void pyjmultimethod_cache_clear_entry(PyJMultiMethodCacheEntry *entry,
+        JNIEnv *env)
+{
+    Py_ssize_t i;
+    for (i = 0; i < entry->argCount; i++) {
+        Py_CLEAR(entry->types[i]);
+        Py_CLEAR(entry->itemTypes[i]);
+        if (entry->classes[i]) {
+            if (env) {
+                (*env)->DeleteGlobalRef(env, entry->classes[i]);
+            }
+            entry->classes[i] = NULL;
+        }
+    }
+    entry->method   = NULL;
+    entry->argCount = 0;
+    entry->charMask = 0;
+}
+
+static void pyjmultimethod_cache_clear(PyJMultiMethodObject *mm, JNIEnv *env)
+{
+    int i;
+    for (i = 0; i < MULTIMETHOD_CACHE_SIZE; i++) {
+        pyjmultimethod_cache_clear_entry(&mm->cache[i], env);
+    }
+}
+
+/*
+ * Search the inline cache for a method that was previously chosen for
+ * arguments of the same types. The first element of args is self and is not
+ * part of the key. Returns a borrowed reference or NULL if there is no match.
+ */
+static PyJMethodObject* pyjmultimethod_cache_get(PyJMultiMethodObject *mm,
+        JNIEnv *env, PyObject *const *args, Py_ssize_t nargs)
+{
+    Py_ssize_t argCount = nargs - 1;
+    int        serial;
+    int        e;
+
+    if (!mm->cache || argCount < 0 || argCount > MULTIMETHOD_CACHE_MAX_ARGS) {
+        return NULL;
+    }
+    serial = JepConverter_GetSerial();
+    for (e = 0; e < MULTIMETHOD_CACHE_SIZE; e++) {
+        PyJMultiMethodCacheEntry *entry = &mm->cache[e];
+        Py_ssize_t                i;
+
+        if (!entry->method || entry->argCount != argCount
+                || entry->converterSerial != serial) {
+            continue;
+        }
+        for (i = 0; i < argCount; i++) {
+            PyObject *arg   = args[i + 1];
+            jclass    clazz = NULL;
+            if (Py_TYPE(arg) != entry->types[i]) {
+                break;
+            }
+            if (((entry->charMask >> i) & 1) != pyjmultimethod_cache_is_char(arg)) {
+                break;
+            }
+            if (pyjmultimethod_cache_item_type(arg) != entry->itemTypes[i]) {
+                break;
+            }
+            clazz = pyjmultimethod_cache_class(arg);
+            if (clazz && !(*env)->IsSameObject(env, clazz, entry->classes[i])) {
+                break;
+            }
+        }
+        if (i == argCount) {
+            return entry->method;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Remember the method that was chosen for the types of args, replacing the
+ * oldest entry if the cache is full.
+ */
+static void pyjmultimethod_cache_put(PyJMultiMethodObject *mm, JNIEnv *env,
+                                     PyObject *const *args, Py_ssize_t nargs,
+                                     PyJMethodObject *method)
+{
+    PyJMultiMethodCacheEntry *entry    = NULL;
+    Py_ssize_t                argCount = nargs - 1;
+    Py_ssize_t                i;
+
+    if (argCount < 0 || argCount > MULTIMETHOD_CACHE_MAX_ARGS) {
+        return;
+    }
+    if (!mm->cache) {
+        mm->cache = PyMem_Malloc(sizeof(PyJMultiMethodCacheEntry) *
+                                 MULTIMETHOD_CACHE_SIZE);
+        if (!mm->cache) {
+            /* The cache is only an optimization, carry on without it. */
+            return;
+        }
+        memset(mm->cache, 0, sizeof(PyJMultiMethodCacheEntry) *
+               MULTIMETHOD_CACHE_SIZE);
+    }
+
+    entry = &mm->cache[mm->cacheNext];
+    mm->cacheNext = (mm->cacheNext + 1) % MULTIMETHOD_CACHE_SIZE;
+    pyjmultimethod_cache_clear_entry(entry, env);
+
+    for (i = 0; i < argCount; i++) {
+        PyObject     *arg      = args[i + 1];
+        jclass        clazz    = pyjmultimethod_cache_class(arg);
+        PyTypeObject *itemType = pyjmultimethod_cache_item_type(arg);
+
+        /* hold a reference so the address cannot be reused by another type */
+        Py_INCREF(Py_TYPE(arg));
+        entry->types[i] = Py_TYPE(arg);
+        Py_XINCREF(itemType);
+        entry->itemTypes[i] = itemType;
+        if (pyjmultimethod_cache_is_char(arg)) {
+            entry->charMask |= 1 << i;
+        }
+        if (clazz) {
+            entry->classes[i] = (*env)->NewGlobalRef(env, clazz);
+        }
+    }
+    entry->argCount        = argCount;
+    entry->method          = method;
+    entry->converterSerial = JepConverter_GetSerial();
+}
+
 
 PyObject* PyJMultiMethod_New(PyObject* method1, PyObject* method2)
 {
@@ -44,7 +221,14 @@ PyObject* PyJMultiMethod_New(PyObject* method1, PyObject* method2)
     if (mm == NULL) {
         return NULL;
     }
-    mm->methodList = PyList_New(2);
+    mm->cache       = NULL;
+    mm->cacheNext   = 0;
+    mm->cacheHits   = 0;
+    mm->cacheMisses = 0;
+#if JEP_VECTORCALL
+    mm->vectorcall  = pyjmultimethod_vectorcall;
+#endif
+    mm->methodList  = PyList_New(2);
     if (mm->methodList == NULL) {
         PyObject_Del(mm);
         return NULL;
@@ -69,6 +253,10 @@ int PyJMultiMethod_Append(PyObject* multimethod, PyObject* method)
         return -1;
     }
     mm = (PyJMultiMethodObject*) multimethod;
+    if (mm->cache) {
+        /* A new method may be a better match for a cached call. */
+        pyjmultimethod_cache_clear(mm, pyembed_get_env());
+    }
     return PyList_Append(mm->methodList, method);
 }
 
@@ -94,9 +282,9 @@ PyObject* PyJMultiMethod_GetName(PyObject* multimethod)
     return methodName;
 }
 
-static PyObject* pyjmultimethod_call(PyObject *multimethod,
-                                     PyObject *args,
-                                     PyObject *keywords)
+static PyObject* pyjmultimethod_call_internal(PyObject *multimethod,
+        PyObject *const *args,
+        Py_ssize_t nargs)
 {
     PyJMultiMethodObject* mm         = NULL;
     PyObject* methodName             = NULL;
@@ -116,11 +304,6 @@ static PyObject* pyjmultimethod_call(PyObject *multimethod,
     Py_ssize_t        argsSize       = 0;
     JNIEnv*           env            = NULL;
 
-    if (keywords != NULL) {
-        PyErr_Format(PyExc_RuntimeError, "Keywords are not supported.");
-        return NULL;
-    }
-
     if (!PyJMultiMethod_Check(multimethod)) {
         PyErr_SetString(PyExc_TypeError,
                         "pyjmultimethod_call_internal received incorrect type");
@@ -130,16 +313,24 @@ static PyObject* pyjmultimethod_call(PyObject *multimethod,
     mm = (PyJMultiMethodObject*) multimethod;
     methodName = PyJMultiMethod_GetName(multimethod);
     methodCount = PyList_Size(mm->methodList);
-    argsSize = PyTuple_Size(args) - 1;
+    argsSize = nargs - 1;
     env = pyembed_get_env();
 
+    cand = pyjmultimethod_cache_get(mm, env, args, nargs);
+    if (cand) {
+        mm->cacheHits += 1;
+        Py_DECREF(methodName);
+        return PyJMethod_Call(cand, args, nargs);
+    }
+    mm->cacheMisses += 1;
+
     for (methodPosition = 0; methodPosition < methodCount; methodPosition += 1) {
         PyJMethodObject* method = (PyJMethodObject*) PyList_GetItem(mm->methodList,
                                   methodPosition);
         if (PyJMethod_GetParameterCount(method, env) == argsSize) {
             if (cand) {
                 if (!candMatch) {
-                    candMatch = PyJMethod_CheckArguments(cand, env, args);
+                    candMatch = PyJMethod_CheckArguments(cand, env, args, nargs);
                 }
                 if (PyErr_Occurred()) {
                     cand = NULL;
@@ -148,7 +339,8 @@ static PyObject* pyjmultimethod_call(PyObject *multimethod,
                     // cand was not compatible, replace it with method.
                     cand = method;
                 } else {
-                    int methodMatch = PyJMethod_CheckArguments(method, env, args);
+                    int methodMatch = PyJMethod_CheckArguments(method, env, args,
+                                                             nargs);
                     if (methodMatch > candMatch) {
                         cand = method;
                         candMatch = methodMatch;
@@ -165,7 +357,8 @@ static PyObject* pyjmultimethod_call(PyObject *multimethod,
     Py_DECREF(methodName);
 
     if (cand) {
-        return PyObject_Call((PyObject*) cand, args, keywords);
+        pyjmultimethod_cache_put(mm, env, args, nargs, cand);
+        return PyJMethod_Call(cand, args, nargs);
     } else {
         if (!PyErr_Occurred()) {
             PyErr_SetString(PyExc_NameError, "No such Method.");
@@ -174,6 +367,50 @@ static PyObject* pyjmultimethod_call(PyObject *multimethod,
     }
 }
 
+static PyObject* pyjmultimethod_call(PyObject *multimethod,
+                                     PyObject *args,
+                                     PyObject *keywords)
+{
+    if (keywords != NULL) {
+        PyErr_Format(PyExc_RuntimeError, "Keywords are not supported.");
+        return NULL;
+    }
+    return pyjmultimethod_call_internal(multimethod,
+                                        PySequence_Fast_ITEMS(args),
+                                        PyTuple_GET_SIZE(args));
+}
+
+#if JEP_VECTORCALL
+static PyObject* pyjmultimethod_vectorcall(PyObject *multimethod,
+        PyObject *const *args, size_t nargsf, PyObject *kwnames)
+{
+    if (kwnames != NULL && PyTuple_GET_SIZE(kwnames) > 0) {
+        PyErr_Format(PyExc_RuntimeError, "Keywords are not supported.");
+        return NULL;
+    }
+    return pyjmultimethod_call_internal(multimethod, args,
+                                        PyVectorcall_NARGS(nargsf));
+}
+#endif
+
+/*
+ * Binds the multimethod to obj the same way a python function is bound when
+ * it is found on a type.
+ */
+static PyObject* pyjmultimethod_descr_get(PyObject *self, PyObject *obj,
+        PyObject *type)
+{
+    if (obj == NULL || obj == Py_None) {
+        Py_INCREF(self);
+        return self;
+    }
+#if PY_MAJOR_VERSION >= 3
+    return PyMethod_New(self, obj);
+#else
+    return PyMethod_New(self, obj, type);
+#endif
+}
+
 /* returns internal list as tuple since its not safe to modify the list*/
 static PyObject* pyjmultimethod_getmethods(PyObject* multimethod)
 {
@@ -187,8 +424,23 @@ static PyObject* pyjmultimethod_getmethods(PyObject* multimethod)
     return PyList_AsTuple(mm->methodList);
 }
 
+static PyObject* pyjmultimethod_get_cache_hits(PyObject* multimethod)
+{
+    return PyLong_FromSsize_t(((PyJMultiMethodObject*) multimethod)->cacheHits);
+}
+
+static PyObject* pyjmultimethod_get_cache_misses(PyObject* multimethod)
+{
+    return PyLong_FromSsize_t(((PyJMultiMethodObject*) multimethod)->cacheMisses);
+}
+
 static void pyjmultimethod_dealloc(PyJMultiMethodObject *self)
 {
+    if (self->cache) {
+        pyjmultimethod_cache_clear(self, pyembed_get_env());
+        PyMem_Free(self->cache);
+        self->cache = NULL;
+    }
     Py_CLEAR(self->methodList);
     PyObject_Del(self);
 }
@@ -196,6 +448,8 @@ static void pyjmultimethod_dealloc(PyJMultiMethodObject *self)
 static PyGetSetDef pyjmultimethod_getsetlist[] = {
     {"__name__", (getter) PyJMultiMethod_GetName, NULL},
     {"__methods__", (getter) pyjmultimethod_getmethods, NULL},
+    {"__cache_hits__", (getter) pyjmultimethod_get_cache_hits, NULL},
+    {"__cache_misses__", (getter) pyjmultimethod_get_cache_misses, NULL},
     {NULL} /* Sentinel */
 };
 
@@ -209,7 +463,11 @@ PyTypeObject PyJMultiMethod_Type = {
     sizeof(PyJMultiMethodObject),
     0,
     (destructor) pyjmultimethod_dealloc,      /* tp_dealloc */
+#if JEP_VECTORCALL
+    offsetof(PyJMultiMethodObject, vectorcall), /* tp_vectorcall_offset */
+#else
     0,                                        /* tp_print */
+#endif
     0,                                        /* tp_getattr */
     0,                                        /* tp_setattr */
     0,                                        /* tp_compare */
@@ -223,7 +481,7 @@ PyTypeObject PyJMultiMethod_Type = {
     0,                                        /* tp_getattro */
     0,                                        /* tp_setattro */
     0,                                        /* tp_as_buffer */
-    Py_TPFLAGS_DEFAULT,                       /* tp_flags */
+    Py_TPFLAGS_DEFAULT | JEP_TPFLAGS_METHOD,  /* tp_flags */
     pyjmultimethod_doc,                       /* tp_doc */
     0,                                        /* tp_traverse */
     0,                                        /* tp_clear */
@@ -236,7 +494,7 @@ PyTypeObject PyJMultiMethod_Type = {
     pyjmultimethod_getsetlist,                /* tp_getset */
     0,                                        /* tp_base */
     0,                                        /* tp_dict */
-    0,                                        /* tp_descr_get */
+    pyjmultimethod_descr_get,                 /* tp_descr_get */
     0,                                        /* tp_descr_set */
     0,                                        /* tp_dictoffset */
     0,                                        /* tp_init */
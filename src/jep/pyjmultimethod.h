@@ -35,9 +35,42 @@
 
 extern PyTypeObject PyJMultiMethod_Type;
 
+/*
+ * The number of argument type combinations remembered by the inline cache of
+ * each PyJMultiMethod and the maximum number of arguments a call can have to
+ * be cached. Calls with more arguments always scan every method.
+ */
+#define MULTIMETHOD_CACHE_SIZE     4
+#define MULTIMETHOD_CACHE_MAX_ARGS 4
+
+/*
+ * An entry in the inline cache of a PyJMultiMethod. The method that is chosen
+ * for a call only depends on the python types of the arguments, whether
+ * string arguments are a single character, the type of the first item of list
+ * and tuple arguments, the java class of PyJObject and PyJArray arguments and
+ * the converters of the interpreter, so those are used as the key.
+ */
+typedef struct {
+    PyJMethodObject *method;      /* the method to call, NULL if unused */
+    Py_ssize_t       argCount;    /* number of args, not including self */
+    int              charMask;    /* bit set for single character strings */
+    int              converterSerial; /* see JepConverter_GetSerial() */
+    PyTypeObject    *types[MULTIMETHOD_CACHE_MAX_ARGS];
+    PyTypeObject    *itemTypes[MULTIMETHOD_CACHE_MAX_ARGS]; /* first item of
+                                      a list or tuple, NULL if empty */
+    jclass           classes[MULTIMETHOD_CACHE_MAX_ARGS];
+} PyJMultiMethodCacheEntry;
+
 typedef struct {
     PyObject_HEAD
-    PyObject* methodList;
+    PyObject                 *methodList;
+    PyJMultiMethodCacheEntry *cache;       /* lazily allocated inline cache */
+    int                       cacheNext;   /* next cache entry to replace */
+    Py_ssize_t                cacheHits;
+    Py_ssize_t                cacheMisses;
+#if JEP_VECTORCALL
+    vectorcallfunc            vectorcall;  /* PEP 590 entry point */
+#endif
 } PyJMultiMethodObject;
 
 /*
@@ -412,9 +412,11 @@ PyTypeObject PyJNumber_Type = {
     0,                                        /* tp_setattro */
     0,                                        /* tp_as_buffer */
 #if PY_MAJOR_VERSION < 3
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_CHECKTYPES,/* tp_flags */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_CHECKTYPES |
+    Py_TPFLAGS_BASETYPE,                      /* tp_flags */
 #else
-    Py_TPFLAGS_DEFAULT,                       /* tp_flags */
+    Py_TPFLAGS_DEFAULT |
+    Py_TPFLAGS_BASETYPE,                      /* tp_flags */
 #endif
     "jnumber",                                /* tp_doc */
     0,                                        /* tp_traverse */
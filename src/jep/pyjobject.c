@@ -117,178 +117,617 @@ static void pyjobject_init_subtypes(void)
     subtypes_initialized = 1;
 }
 
-/* Set the object attributes from the cache */
-static int pyjobject_init(JNIEnv *env, PyJObject *pyjob)
+/*
+ * Add a PyJMethod to a dict of attributes. If the dict already has a
+ * PyJMethod or PyJMultiMethod with the same name they are combined into a
+ * PyJMultiMethod. Returns 0 on success or -1 on error.
+ */
+static int pyjobject_add_method(PyObject *attrs, PyJMethodObject *pymethod)
 {
+    PyObject *cached;
 
-    jstring className     = NULL;
-    PyObject *pyClassName = NULL;
-    JepThread *jepThread  = NULL;
-    PyObject *cachedAttrs = NULL;
-
-    if ((*env)->PushLocalFrame(env, JLOCAL_REFS) != 0) {
-        process_java_exception(env);
+    if (!pymethod->pyMethodName || !PyString_Check(pymethod->pyMethodName)) {
         return 0;
     }
 
-    /*
-     * Attach the attribute java_name to the PyJObject instance to assist
-     * developers with understanding the type at runtime.
-     */
-    className = java_lang_Class_getName(env, pyjob->clazz);
-    if (process_java_exception(env) || !className) {
-        goto EXIT_ERROR;
+    cached = PyDict_GetItem(attrs, pymethod->pyMethodName);
+    if (cached == NULL) {
+        return PyDict_SetItem(attrs, pymethod->pyMethodName,
+                              (PyObject*) pymethod);
+    } else if (PyJMethod_Check(cached)) {
+        int       result;
+        PyObject *multimethod = PyJMultiMethod_New((PyObject*) pymethod, cached);
+        if (!multimethod) {
+            return -1;
+        }
+        result = PyDict_SetItem(attrs, pymethod->pyMethodName, multimethod);
+        Py_DECREF(multimethod);
+        return result;
+    } else if (PyJMultiMethod_Check(cached)) {
+        return PyJMultiMethod_Append(cached, (PyObject*) pymethod);
     }
-    pyClassName = jstring_To_PyObject(env, className);
-    pyjob->javaClassName = pyClassName;
+    return 0;
+}
 
-    /*
-     * Get methods for the PyJObject, optimized for performance.  The code
-     * below is very similar to previous versions except methods are now
-     * cached in memory.
-     *
-     * Previously every time you instantiate a PyJObject, Jep would get the
-     * complete list of methods through reflection, turn them into PyJMethods,
-     * and add them as attributes to the PyJObject.
-     *
-     * Now Jep retains a Python dictionary in memory with a key of the fully
-     * qualified Java classname to a list of PyJMethods and PyJMultiMethods.
-     * Since the Java methods will never change at runtime for a particular
-     * Class, this is safe and drastically speeds up PyJObject instantiation
-     * by reducing reflection calls. We continue to set and reuse the
-     * PyJMethods and PyJMultiMethods attributes on the PyJObject instance,
-     * but if pyjobject_getattro sees a PyJMethod or PyJMultiMethod, it will
-     * put it inside a PyMethod and return that, enabling the reuse of the
-     * PyJMethod or PyJMultiMethod for this particular object instance.
-     *
-     * We have the GIL at this point, so we can safely assume we're
-     * synchronized and multiple threads will not alter the dictionary at the
-     * same time.
-     */
-    jepThread = pyembed_get_jepthread();
-    if (jepThread == NULL) {
-        goto EXIT_ERROR;
+/*
+ * Get the wrapper for a member from a dict of the wrappers of the current
+ * interpreter keyed by the id of the member, creating the dict if necessary.
+ * Returns a new reference, NULL with no exception if the member has no
+ * wrapper yet or NULL with an exception on error.
+ */
+static PyObject* pyjobject_get_shared(PyObject **shared, void *id)
+{
+    PyObject *key, *member;
+
+    if (!*shared) {
+        *shared = PyDict_New();
+        if (!*shared) {
+            return NULL;
+        }
     }
-    if (jepThread->fqnToPyJAttrs == NULL) {
-        jepThread->fqnToPyJAttrs = PyDict_New();
+    key = PyLong_FromVoidPtr(id);
+    if (!key) {
+        return NULL;
     }
+    member = PyDict_GetItem(*shared, key);
+    Py_DECREF(key);
+    Py_XINCREF(member);
+    return member;
+}
 
-    cachedAttrs = PyDict_GetItem(jepThread->fqnToPyJAttrs, pyClassName);
-    if (cachedAttrs == NULL) {
-        int i, len = 0;
-        jobjectArray methodArray = NULL;
-        jobjectArray fieldArray  = NULL;
+/* Add a wrapper to a dict made by pyjobject_get_shared(). */
+static int pyjobject_set_shared(PyObject *shared, void *id, PyObject *member)
+{
+    int       result;
+    PyObject *key = PyLong_FromVoidPtr(id);
+    if (!key) {
+        return -1;
+    }
+    result = PyDict_SetItem(shared, key, member);
+    Py_DECREF(key);
+    return result;
+}
 
-        cachedAttrs = PyDict_New();
+/*
+ * Get the PyJMethod for the metadata of a method. Inherited methods have the
+ * same jmethodID in every class that inherits them, so the PyJMethod is shared
+ * by all those classes and every declared method only has one PyJMethod in
+ * each interpreter. Returns a new reference or NULL on error.
+ */
+static PyJMethodObject* pyjobject_method_from_metadata(JNIEnv *env,
+        JepMethodMetadata *metadata, PyObject *name)
+{
+    JepThread       *jepThread = pyembed_get_interpreter_jepthread();
+    PyJMethodObject *pymethod;
 
-        // - GetMethodID fails when you pass the clazz object, it expects
-        //   a java.lang.Class jobject.
-        // - if you CallObjectMethod with the langClass jclass object,
-        //   it'll return an array of methods, but they're methods of the
-        //   java.lang.reflect.Method class -- not ->object.
-        //
-        // so what i did here was find the methodid using langClass,
-        // but then i call the method using clazz. methodIds for java
-        // classes are shared....
-        methodArray = java_lang_Class_getMethods(env, pyjob->clazz);
-        if (process_java_exception(env) || !methodArray) {
+    if (!jepThread) {
+        return NULL;
+    }
+    pymethod = (PyJMethodObject*) pyjobject_get_shared(
+                   &jepThread->sharedMethods, metadata->methodId);
+    if (pymethod || PyErr_Occurred()) {
+        return pymethod;
+    }
+    pymethod = PyJMethod_NewFromMetadata(env, metadata, name);
+    if (pymethod && pyjobject_set_shared(jepThread->sharedMethods,
+                                         metadata->methodId,
+                                         (PyObject*) pymethod) != 0) {
+        Py_CLEAR(pymethod);
+    }
+    return pymethod;
+}
+
+/*
+ * Get the PyJField for the metadata of a field, shared the same way as the
+ * PyJMethods of inherited methods. Returns a new reference or NULL on error.
+ */
+static PyJFieldObject* pyjobject_field_from_metadata(JNIEnv *env,
+        JepFieldMetadata *metadata)
+{
+    JepThread      *jepThread = pyembed_get_interpreter_jepthread();
+    PyJFieldObject *pyjfield;
+
+    if (!jepThread) {
+        return NULL;
+    }
+    pyjfield = (PyJFieldObject*) pyjobject_get_shared(
+                   &jepThread->sharedFields, metadata->fieldId);
+    if (pyjfield || PyErr_Occurred()) {
+        return pyjfield;
+    }
+    pyjfield = PyJField_NewFromMetadata(env, metadata);
+    if (pyjfield && pyjobject_set_shared(jepThread->sharedFields,
+                                         metadata->fieldId,
+                                         (PyObject*) pyjfield) != 0) {
+        Py_CLEAR(pyjfield);
+    }
+    return pyjfield;
+}
+
+/*
+ * Add a PyJMethod for every overload of a method to a dict of attributes. The
+ * metadata must be the first of the overloads. Returns 0 on success or -1 on
+ * error.
+ */
+static int pyjobject_add_overloads(JNIEnv *env, PyObject *attrs,
+                                   JepMethodMetadata *metadata)
+{
+    PyObject *name;
+    int       i;
+    int       result = 0;
+
+    name = PyString_FromString(metadata->name);
+    if (!name) {
+        return -1;
+    }
+    for (i = 0; i < metadata->overloads && result == 0; i++) {
+        PyJMethodObject *pymethod = pyjobject_method_from_metadata(env,
+                                    &metadata[i], name);
+        if (!pymethod) {
+            result = -1;
+            break;
+        }
+        result = pyjobject_add_method(attrs, pymethod);
+        Py_DECREF(pymethod);
+    }
+    Py_DECREF(name);
+    return result;
+}
+
+/*
+ * Build a dict of PyJMethods, PyJMultiMethods and PyJFields for all of the
+ * public members of a class. The wrappers are built from the process wide
+ * metadata of the class so reflection is only needed the first time any
+ * interpreter uses the class. Returns a new reference or NULL on error.
+ */
+static PyObject* pyjobject_reflect_attrs(JNIEnv *env, PyJClassInfoObject *info)
+{
+    JepClassMetadata *meta;
+    PyObject         *attrs;
+    int               i;
+
+    meta = JepMetadata_GetClass(env, info->clazz, info->hash);
+    if (!meta) {
+        return NULL;
+    }
+
+    attrs = PyDict_New();
+    if (!attrs) {
+        return NULL;
+    }
+
+    for (i = 0; i < meta->lenMethods; i += meta->methods[i].overloads) {
+        if (pyjobject_add_overloads(env, attrs, &meta->methods[i]) != 0) {
             goto EXIT_ERROR;
         }
+    }
 
-        /*
-         * For each method, create a new PyJMethod object and either add it to
-         * the cached methods list or a PyJMultiMethod.
-         */
+    /* fields are added last so they replace methods with the same name */
+    for (i = 0; i < meta->lenFields; i++) {
+        PyJFieldObject *pyjfield = pyjobject_field_from_metadata(env,
+                                   &meta->fields[i]);
+        if (!pyjfield) {
+            goto EXIT_ERROR;
+        }
+        if (PyDict_SetItem(attrs, pyjfield->pyFieldName,
+                           (PyObject*) pyjfield) != 0) {
+            Py_DECREF(pyjfield);
+            goto EXIT_ERROR;
+        }
+        Py_DECREF(pyjfield);
+    }
+
+    return attrs;
+
+EXIT_ERROR:
+    Py_DECREF(attrs);
+    return NULL;
+}
+
+/*
+ * Add the member of a class with a name to a dict of attributes using the
+ * process wide metadata of the class. Nothing is added if the class has no
+ * public member with the name. Returns 0 on success or -1 on error.
+ */
+static int pyjobject_add_metadata_attr(JNIEnv *env, PyObject *attrs,
+                                       JepClassMetadata *meta,
+                                       const char *name)
+{
+    JepFieldMetadata  *field;
+    JepMethodMetadata *method;
+
+    /* Fields replace methods with the same name in the complete dict. */
+    field = JepMetadata_FindField(meta, name);
+    if (field) {
+        int             result;
+        PyJFieldObject *pyjfield = pyjobject_field_from_metadata(env, field);
+        if (!pyjfield) {
+            return -1;
+        }
+        result = PyDict_SetItem(attrs, pyjfield->pyFieldName,
+                                (PyObject*) pyjfield);
+        Py_DECREF(pyjfield);
+        return result;
+    }
+
+    method = JepMetadata_FindMethod(meta, name);
+    if (method) {
+        return pyjobject_add_overloads(env, attrs, method);
+    }
+    return 0;
+}
+
+/*
+ * Reflect on a single member of a class by name and add it to a dict of
+ * attributes, without reflecting on every member of the class. Nothing is
+ * added if the class has no public member with the name. Returns 0 on success
+ * or -1 on error.
+ */
+static int pyjobject_reflect_attr(JNIEnv *env, PyObject *attrs, jclass clazz,
+                                  const char *name)
+{
+    jstring      jname       = NULL;
+    jobject      rfield      = NULL;
+    jobjectArray methodArray = NULL;
+    int          i, len;
+
+    if ((*env)->PushLocalFrame(env, JLOCAL_REFS) != 0) {
+        process_java_exception(env);
+        return -1;
+    }
+    jname = (*env)->NewStringUTF(env, name);
+    if (process_java_exception(env) || !jname) {
+        goto EXIT_ERROR;
+    }
+
+    /* Fields replace methods with the same name in the complete dict. */
+    rfield = jep_Util_getField(env, clazz, jname);
+    if (process_java_exception(env)) {
+        goto EXIT_ERROR;
+    }
+    if (rfield) {
+        PyJFieldObject *pyjfield = PyJField_New(env, rfield);
+        if (!pyjfield) {
+            goto EXIT_ERROR;
+        }
+        if (PyDict_SetItem(attrs, pyjfield->pyFieldName,
+                           (PyObject*) pyjfield) != 0) {
+            Py_DECREF(pyjfield);
+            goto EXIT_ERROR;
+        }
+        Py_DECREF(pyjfield);
+    } else {
+        methodArray = jep_Util_getMethods(env, clazz, jname);
+        if (process_java_exception(env) || !methodArray) {
+            goto EXIT_ERROR;
+        }
         len = (*env)->GetArrayLength(env, methodArray);
         for (i = 0; i < len; i++) {
             PyJMethodObject *pymethod = NULL;
-            jobject rmethod = NULL;
+            jobject          rmethod  = NULL;
 
             rmethod = (*env)->GetObjectArrayElement(env, methodArray, i);
             pymethod = PyJMethod_New(env, rmethod);
-
+            (*env)->DeleteLocalRef(env, rmethod);
             if (!pymethod) {
-                continue;
+                goto EXIT_ERROR;
             }
-
-            /*
-             * For every method of this name, check to see if a PyJMethod or
-             * PyJMultiMethod is already in the cache with the same name. If
-             * so, turn it into a PyJMultiMethod or add it to the existing
-             * PyJMultiMethod.
-             */
-            if (pymethod->pyMethodName && PyString_Check(pymethod->pyMethodName)) {
-                PyObject* cached = PyDict_GetItem(cachedAttrs, pymethod->pyMethodName);
-                if (cached == NULL) {
-                    if (PyDict_SetItem(cachedAttrs, pymethod->pyMethodName,
-                                       (PyObject*) pymethod) != 0) {
-                        goto EXIT_ERROR;
-                    }
-                } else if (PyJMethod_Check(cached)) {
-                    PyObject* multimethod = PyJMultiMethod_New((PyObject*) pymethod, cached);
-                    PyDict_SetItem(cachedAttrs, pymethod->pyMethodName, multimethod);
-                    Py_DECREF(multimethod);
-                } else if (PyJMultiMethod_Check(cached)) {
-                    PyJMultiMethod_Append(cached, (PyObject*) pymethod);
-                }
+            if (pyjobject_add_method(attrs, pymethod) != 0) {
+                Py_DECREF(pymethod);
+                goto EXIT_ERROR;
             }
-
             Py_DECREF(pymethod);
-            (*env)->DeleteLocalRef(env, rmethod);
-        } // end of looping over available methods
-
-        //  process fields
-        fieldArray = java_lang_Class_getFields(env, pyjob->clazz);
-        if (process_java_exception(env) || !fieldArray) {
-            goto EXIT_ERROR;
         }
+    }
+    (*env)->PopLocalFrame(env, NULL);
+    return 0;
 
-        // for each field, create a pyjfield object and
-        // add to the internal members list.
-        len = (*env)->GetArrayLength(env, fieldArray);
-        for (i = 0; i < len; i++) {
-            jobject          rfield   = NULL;
-            PyJFieldObject *pyjfield = NULL;
+EXIT_ERROR:
+    (*env)->PopLocalFrame(env, NULL);
+    return -1;
+}
 
-            rfield = (*env)->GetObjectArrayElement(env, fieldArray, i);
+/*
+ * Resolve a single member of a class by name and add it to the attr dict of
+ * the class descriptor, for interpreters that resolve members lazily. If
+ * another interpreter already reflected on the class its metadata is used,
+ * otherwise only the requested member is reflected on. A PyJClass has its
+ * own copy of the dict so the member is added to both. Returns 1 if a member
+ * was added, 0 if the class has no public member with the name or -1 on
+ * error.
+ */
+static int pyjobject_resolve_attr(JNIEnv *env, PyJObject *pyjob,
+                                  PyObject *name)
+{
+    PyJClassInfoObject *info   = pyjob->classInfo;
+    PyObject           *member = NULL;
+
+    member = PyDict_GetItem(info->attr, name);
+    if (!member) {
+        JepClassMetadata *meta;
+        const char       *cname;
 
-            pyjfield = PyJField_New(env, rfield);
+        if (info->missing && PySet_Contains(info->missing, name) == 1) {
+            return 0;
+        }
 
-            if (!pyjfield) {
-                continue;
+        cname = PyString_AsString(name);
+        if (!cname) {
+            return -1;
+        }
+        meta = JepMetadata_FindClass(env, info->clazz, info->hash);
+        if (meta) {
+            if (pyjobject_add_metadata_attr(env, info->attr, meta, cname) != 0) {
+                return -1;
             }
+        } else if (pyjobject_reflect_attr(env, info->attr, info->clazz,
+                                          cname) != 0) {
+            return -1;
+        }
 
-            if (pyjfield->pyFieldName && PyString_Check(pyjfield->pyFieldName)) {
-                if (PyDict_SetItem(cachedAttrs, pyjfield->pyFieldName,
-                                   (PyObject*) pyjfield) != 0) {
-                    goto EXIT_ERROR;
+        member = PyDict_GetItem(info->attr, name);
+        if (!member) {
+            if (!info->missing) {
+                info->missing = PySet_New(NULL);
+                if (!info->missing) {
+                    return -1;
                 }
             }
+            if (PySet_Add(info->missing, name) != 0) {
+                return -1;
+            }
+            return 0;
+        }
+    }
 
-            Py_DECREF(pyjfield);
-            (*env)->DeleteLocalRef(env, rfield);
+    if (pyjob->attr != info->attr
+            && PyDict_SetItem(pyjob->attr, name, member) != 0) {
+        return -1;
+    }
+    return 1;
+}
+
+/*
+ * Make sure the attr dict of a class descriptor exists and holds every member
+ * of the class. Members that were already resolved lazily are kept so they do
+ * not change identity. Returns 0 on success or -1 on error.
+ */
+static int pyjobject_complete_class_attr(JNIEnv *env, PyJClassInfoObject *info)
+{
+    PyObject *attrs;
+
+    if (info->attrComplete) {
+        return 0;
+    }
+    attrs = pyjobject_reflect_attrs(env, info);
+    if (!attrs) {
+        return -1;
+    }
+    if (!info->attr) {
+        info->attr = attrs;
+    } else {
+        if (PyDict_Merge(info->attr, attrs, 0) != 0) {
+            Py_DECREF(attrs);
+            return -1;
         }
-        (*env)->DeleteLocalRef(env, fieldArray);
+        Py_DECREF(attrs);
+    }
+    Py_CLEAR(info->missing);
+    info->attrComplete = 1;
+    return 0;
+}
 
-        PyDict_SetItem(jepThread->fqnToPyJAttrs, pyClassName, cachedAttrs);
-        Py_DECREF(cachedAttrs); // fqnToPyJAttrs will hold the reference
-    } // end of setting up cache for this Java Class
+/*
+ * Make sure the attr dict of a PyJObject holds every member of its class.
+ * Returns 0 on success or -1 on error.
+ */
+static int pyjobject_complete_attr(JNIEnv *env, PyJObject *pyjob)
+{
+    PyJClassInfoObject *info = pyjob->classInfo;
 
-    if (pyjob->object) {
-        Py_INCREF(cachedAttrs);
-        pyjob->attr = cachedAttrs;
+    if (pyjobject_complete_class_attr(env, info) != 0) {
+        return -1;
+    }
+    if (pyjob->attr && pyjob->attr != info->attr) {
+        /* A PyJClass may have been copied from an incomplete dict. */
+        return PyDict_Merge(pyjob->attr, info->attr, 0);
+    }
+    return 0;
+}
+
+/*
+ * Called with an AttributeError set when name was not found on a PyJObject.
+ * If the members of the class are resolved lazily and name is a member then
+ * the error is cleared and 1 is returned, otherwise an error is set and 0 is
+ * returned.
+ */
+static int pyjobject_try_resolve(PyJObject *pyjob, PyObject *name)
+{
+    PyObject *type, *value, *traceback;
+    int       result;
+
+    if (!pyjob->classInfo || pyjob->classInfo->attrComplete
+            || !PyString_Check(name)
+            || !PyErr_ExceptionMatches(PyExc_AttributeError)) {
+        return 0;
+    }
+
+    PyErr_Fetch(&type, &value, &traceback);
+    result = pyjobject_resolve_attr(pyembed_get_env(), pyjob, name);
+    if (result == 0) {
+        PyErr_Restore(type, value, traceback);
+    } else {
+        Py_XDECREF(type);
+        Py_XDECREF(value);
+        Py_XDECREF(traceback);
+    }
+    return result == 1;
+}
+
+/*
+ * Get the python type for the objects of a java class when the interpreter
+ * uses class types, building it the first time. Each java class gets a heap
+ * type named after the class whose dict holds the PyJMethods, PyJMultiMethods
+ * and PyJFields of the class, so attribute lookups go through the type
+ * attribute cache of python instead of the attr dict of each object. The
+ * base of the type is the type of the java superclass, plus the PyJObject
+ * subtype of the class when it is not already a base of the superclass type,
+ * so isinstance() and issubclass() follow the java hierarchy. Every type holds
+ * all the members of its class, including inherited ones, because the
+ * overloads of a java method can be declared in different classes. Returns a
+ * borrowed reference, the descriptor owns the type.
+ */
+static PyTypeObject* pyjobject_class_type(JNIEnv *env,
+        PyJClassInfoObject *info)
+{
+    PyJClassInfoObject *superInfo  = NULL;
+    PyTypeObject       *superType  = NULL;
+    PyObject           *bases      = NULL;
+    PyObject           *dict       = NULL;
+    PyObject           *slots      = NULL;
+    PyObject           *module     = NULL;
+    PyObject           *type       = NULL;
+    jclass              superclass = NULL;
+    const char         *javaName;
+    const char         *simpleName;
+
+    if (info->classType) {
+        return info->classType;
+    }
+    if (pyjobject_complete_class_attr(env, info) != 0) {
+        return NULL;
+    }
+
+    superclass = (*env)->GetSuperclass(env, info->clazz);
+    if (superclass) {
+        superInfo = PyJClassInfo_Get(env, superclass);
+        (*env)->DeleteLocalRef(env, superclass);
+        if (!superInfo) {
+            return NULL;
+        }
+        superType = pyjobject_class_type(env, superInfo);
+        if (!superType) {
+            return NULL;
+        }
+    }
+
+    if (!superType) {
+        bases = PyTuple_Pack(1, info->pyjType);
+    } else if (superInfo->pyjType == info->pyjType) {
+        bases = PyTuple_Pack(1, superType);
+    } else {
+        bases = PyTuple_Pack(2, superType, info->pyjType);
+    }
+    if (!bases) {
+        return NULL;
+    }
+
+    javaName   = PyString_AsString(info->javaName);
+    simpleName = strrchr(javaName, '.');
+    if (simpleName) {
+        module = PyString_FromStringAndSize(javaName, simpleName - javaName);
+        simpleName += 1;
+    } else {
+        module = PyString_FromString("");
+        simpleName = javaName;
+    }
+    dict  = PyDict_Copy(info->attr);
+    slots = PyTuple_New(0);
+    if (!module || !dict || !slots
+            || PyDict_SetItemString(dict, "__module__", module) != 0
+            || PyDict_SetItemString(dict, "__slots__", slots) != 0) {
+        goto EXIT;
+    }
+
+    /*
+     * No new slots means the type has the same layout as PyJObject and does
+     * not use the garbage collector for its instances.
+     */
+    type = PyObject_CallFunction((PyObject*) &PyType_Type, "sOO",
+                                 simpleName, bases, dict);
+    info->classType = (PyTypeObject*) type;
+
+EXIT:
+    Py_XDECREF(bases);
+    Py_XDECREF(dict);
+    Py_XDECREF(slots);
+    Py_XDECREF(module);
+    return info->classType;
+}
+
+
+/* Set the object attributes from the class descriptor */
+static int pyjobject_init(JNIEnv *env, PyJObject *pyjob)
+{
+    PyJClassInfoObject *info = pyjob->classInfo;
+
+    /*
+     * Every PyJObject holds a reference to the descriptor of its Java class,
+     * which also provides the attribute java_name to assist developers with
+     * understanding the type at runtime.
+     */
+    if (!info) {
+        info = PyJClassInfo_Get(env, pyjob->clazz);
+        if (!info) {
+            goto EXIT_ERROR;
+        }
+        Py_INCREF(info);
+        pyjob->classInfo = info;
+    }
+
+    /*
+     * Get methods for the PyJObject, optimized for performance.
+     *
+     * Previously every time you instantiate a PyJObject, Jep would get the
+     * complete list of methods through reflection, turn them into PyJMethods,
+     * and add them as attributes to the PyJObject.
+     *
+     * Now the descriptor of each Java class holds a Python dictionary of
+     * PyJMethods, PyJMultiMethods and PyJFields. Since the Java methods will
+     * never change at runtime for a particular Class, this is safe and
+     * drastically speeds up PyJObject instantiation by reducing reflection
+     * calls. We continue to set and reuse the PyJMethods and PyJMultiMethods
+     * attributes on the PyJObject instance, but if pyjobject_getattro sees a
+     * PyJMethod or PyJMultiMethod, it will put it inside a PyMethod and
+     * return that, enabling the reuse of the PyJMethod or PyJMultiMethod for
+     * this particular object instance.
+     *
+     * We have the GIL at this point, so we can safely assume we're
+     * synchronized and multiple threads will not alter the descriptor at the
+     * same time.
+     */
+    if (!info->attr) {
+        JepThread *jepThread = pyembed_get_interpreter_jepthread();
+        if (!jepThread) {
+            goto EXIT_ERROR;
+        }
+        if (jepThread->lazyMembers) {
+            /* filled in by pyjobject_resolve_attr() as members are used */
+            info->attr = PyDict_New();
+        } else {
+            info->attr = pyjobject_reflect_attrs(env, info);
+            info->attrComplete = 1;
+        }
+        if (!info->attr) {
+            goto EXIT_ERROR;
+        }
+    }
+
+    if (pyjob->object && Py_TYPE(pyjob) == info->classType) {
+        /* the members are found in the dict of the type */
+        pyjob->attr = NULL;
+    } else if (pyjob->object) {
+        Py_INCREF(info->attr);
+        pyjob->attr = info->attr;
     } else {
         /* PyJClass may add additional attributes so use a copy */
-        pyjob->attr = PyDict_Copy(cachedAttrs);
+        pyjob->attr = PyDict_Copy(info->attr);
     }
 
-    (*env)->PopLocalFrame(env, NULL);
     return 1;
 
 
 EXIT_ERROR:
-    (*env)->PopLocalFrame(env, NULL);
-
     if (PyErr_Occurred()) { // java exceptions translated by this time
         if (pyjob) {
             pyjobject_dealloc(pyjob);
@@ -299,12 +738,194 @@ EXIT_ERROR:
 }
 
 
+/*
+ * Allocates an uninitialized PyJObject of the given type, reusing one from the
+ * free list of the current JepThread when possible. Every type on the free
+ * list has the same basic size as PyJObject so any entry can be used for any
+ * of them.
+ */
+static PyJObject* pyjobject_alloc(PyTypeObject *type)
+{
+    JepThread *jepThread;
+    PyJObject *pyjob;
+
+    if (type->tp_flags & Py_TPFLAGS_HEAPTYPE) {
+        /* class types are never on the free list, this references the type */
+        return (PyJObject*) type->tp_alloc(type, 0);
+    } else if (type->tp_basicsize == sizeof(PyJObject)) {
+        jepThread = pyembed_find_jepthread();
+        if (jepThread && jepThread->objectFreeList) {
+            pyjob = (PyJObject*) jepThread->objectFreeList;
+            jepThread->objectFreeList = pyjob->attr;
+            jepThread->objectFreeListSize--;
+            return (PyJObject*) PyObject_INIT(pyjob, type);
+        }
+    }
+    return PyObject_NEW(PyJObject, type);
+}
+
+
+/*
+ * Releases the memory of every PyJObject on the free list of a JepThread.
+ */
+void PyJObject_ClearFreeList(JepThread *jepThread)
+{
+    PyObject *next;
+
+    while (jepThread->objectFreeList) {
+        next = ((PyJObject*) jepThread->objectFreeList)->attr;
+        PyObject_Del(jepThread->objectFreeList);
+        jepThread->objectFreeList = next;
+    }
+    jepThread->objectFreeListSize = 0;
+}
+
+
+/* The number of slots an identity table starts with, must be a power of two. */
+#define IDENTITY_INITIAL_SIZE 64
+
+/* Allocate or double the slots of an identity table, returns 0 on failure. */
+static int pyjobject_identity_grow(PyJObjectIdentityTable *table)
+{
+    PyObject **slots = NULL;
+    int        size  = table->size ? table->size * 2 : IDENTITY_INITIAL_SIZE;
+    int        i;
+
+    slots = PyMem_Malloc(sizeof(PyObject*) * size);
+    if (!slots) {
+        return 0;
+    }
+    memset(slots, 0, sizeof(PyObject*) * size);
+
+    for (i = 0; i < table->size; i++) {
+        PyJObject *pyjob = (PyJObject*) table->slots[i];
+        if (pyjob) {
+            int index = pyjob->identityHash & (size - 1);
+            while (slots[index]) {
+                index = (index + 1) & (size - 1);
+            }
+            slots[index] = (PyObject*) pyjob;
+        }
+    }
+
+    PyMem_Free(table->slots);
+    table->slots = slots;
+    table->size  = size;
+    return 1;
+}
+
+
+/*
+ * Find the PyJObject of a java object in an identity table. Returns a borrowed
+ * reference or NULL if the object is not in the table.
+ */
+static PyJObject* pyjobject_identity_find(JNIEnv *env,
+        PyJObjectIdentityTable *table, jobject obj, jint hash)
+{
+    int mask, index;
+
+    if (!table->count) {
+        return NULL;
+    }
+    mask = table->size - 1;
+    for (index = hash & mask; table->slots[index]; index = (index + 1) & mask) {
+        PyJObject *pyjob = (PyJObject*) table->slots[index];
+        if (pyjob->identityHash == hash
+                && (*env)->IsSameObject(env, pyjob->object, obj)) {
+            return pyjob;
+        }
+    }
+    return NULL;
+}
+
+
+/*
+ * Add a PyJObject to an identity table. The table is only an optimization so
+ * if it cannot grow the PyJObject is simply not added. The PyJObject remembers
+ * the table so it can remove itself from any thread.
+ */
+static void pyjobject_identity_add(PyJObjectIdentityTable *table,
+                                   PyJObject *pyjob)
+{
+    int mask, index;
+
+    if ((table->count + 1) * 2 > table->size
+            && !pyjobject_identity_grow(table)) {
+        return;
+    }
+    mask = table->size - 1;
+    for (index = pyjob->identityHash & mask; table->slots[index];
+            index = (index + 1) & mask);
+    table->slots[index] = (PyObject*) pyjob;
+    table->count += 1;
+    pyjob->identity = table;
+}
+
+
+/*
+ * Remove a PyJObject from an identity table if it is in the table. The
+ * entries after it are moved back so that every entry stays reachable from
+ * the slot of its hash without needing markers for removed entries.
+ */
+static void pyjobject_identity_remove(PyJObjectIdentityTable *table,
+                                      PyJObject *pyjob)
+{
+    int mask, index, next;
+
+    if (!table->count) {
+        return;
+    }
+    mask = table->size - 1;
+    for (index = pyjob->identityHash & mask;
+            table->slots[index] != (PyObject*) pyjob;
+            index = (index + 1) & mask) {
+        if (!table->slots[index]) {
+            return;
+        }
+    }
+    table->slots[index] = NULL;
+    table->count -= 1;
+
+    for (next = (index + 1) & mask; table->slots[next];
+            next = (next + 1) & mask) {
+        int home = ((PyJObject*) table->slots[next])->identityHash & mask;
+        /* an entry can fill the hole unless its home is in (index, next] */
+        if (index < next ? (home <= index || home > next)
+                : (home <= index && home > next)) {
+            table->slots[index] = table->slots[next];
+            table->slots[next]  = NULL;
+            index = next;
+        }
+    }
+}
+
+
+void PyJObject_ClearIdentityTable(PyJObjectIdentityTable *table)
+{
+    int index;
+
+    for (index = 0; index < table->size; index++) {
+        if (table->slots[index]) {
+            ((PyJObject*) table->slots[index])->identity = NULL;
+        }
+    }
+    PyMem_Free(table->slots);
+    table->slots = NULL;
+    table->size  = 0;
+    table->count = 0;
+}
+
+
 // called internally to make new PyJObject instances
 PyObject* PyJObject_New(JNIEnv *env, jobject obj)
 {
-    PyJObject    *pyjob;
-    jclass        objClz;
-    int           jtype;
+    PyJObject              *pyjob;
+    PyJClassInfoObject     *info;
+    PyTypeObject           *type;
+    jclass                  objClz;
+    JepThread              *jepThread;
+    PyJObjectIdentityTable *identity = NULL;
+    jint                    hash     = 0;
 
     if (!subtypes_initialized) {
         pyjobject_init_subtypes();
@@ -315,6 +936,11 @@ PyObject* PyJObject_New(JNIEnv *env, jobject obj)
     }
 
     objClz = (*env)->GetObjectClass(env, obj);
+    info   = PyJClassInfo_Get(env, objClz);
+    (*env)->DeleteLocalRef(env, objClz);
+    if (!info) {
+        return NULL;
+    }
 
     /*
      * There exist situations where a Java method signature has a return
@@ -323,49 +949,57 @@ PyObject* PyJObject_New(JNIEnv *env, jobject obj)
      * an object.  Hence this check here to build the optimal Jep type in
      * the interpreter regardless of signature.
      */
-    jtype = get_jtype(env, objClz);
-    if (jtype == JARRAY_ID) {
+    if (info->typeId == JARRAY_ID) {
         return pyjarray_new(env, obj);
-    } else if (jtype == JCLASS_ID) {
+    } else if (info->typeId == JCLASS_ID) {
         return PyJObject_NewClass(env, obj);
-    } else {
-        /*
-         * Check the Java type against our extensions to PyJObject. If we have
-         * an extension to PyJObject that matches, then Python code using this
-         * PyJObject can appear more pythonic: e.g. java.lang.Iterable can
-         * become a PyJIterable and be used as a PyJObject but also as a Python
-         * iterable such as "for i in obj:".
-         */
-        if ((*env)->IsInstanceOf(env, obj, JITERABLE_TYPE)) {
-            if ((*env)->IsInstanceOf(env, obj, JCOLLECTION_TYPE)) {
-                if ((*env)->IsInstanceOf(env, obj, JLIST_TYPE)) {
-                    pyjob = PyJList_New();
-                } else {
-                    pyjob = PyJCollection_New();
-                }
-            } else {
-                pyjob = PyJIterable_New();
-            }
-        } else if ((*env)->IsInstanceOf(env, obj, JMAP_TYPE)) {
-            pyjob = PyJMap_New();
-        } else if ((*env)->IsInstanceOf(env, obj, JITERATOR_TYPE)) {
-            pyjob = PyJIterator_New();
-        } else if ((*env)->IsInstanceOf(env, obj, JAUTOCLOSEABLE_TYPE)) {
-            pyjob = PyJAutoCloseable_New();
-        } else if ((*env)->IsInstanceOf(env, obj, JNUMBER_TYPE)) {
-            pyjob = PyJNumber_New();
-        } else {
-            pyjob = PyObject_NEW(PyJObject, &PyJObject_Type);
-        }
     }
 
+    /* Reuse the live PyJObject of the java object if there is one. */
+    jepThread = pyembed_find_interpreter_jepthread();
+    if (jepThread && jepThread->identity.enabled) {
+        identity = &jepThread->identity;
+        hash = java_lang_System_identityHashCode(env, obj);
+        if (process_java_exception(env)) {
+            return NULL;
+        }
+        pyjob = pyjobject_identity_find(env, identity, obj, hash);
+        if (pyjob) {
+            identity->hits += 1;
+            Py_INCREF(pyjob);
+            return (PyObject *) pyjob;
+        }
+        identity->misses += 1;
+    }
 
-    pyjob->object      = (*env)->NewGlobalRef(env, obj);
-    pyjob->clazz       = (*env)->NewGlobalRef(env, objClz);
+    /*
+     * The descriptor has already checked the Java type against our
+     * extensions to PyJObject, see pyjclassinfo_choose_type().
+     */
+    type = info->pyjType;
+    if (jepThread && jepThread->classTypes) {
+        type = pyjobject_class_type(env, info);
+        if (!type) {
+            return NULL;
+        }
+    }
+    pyjob = pyjobject_alloc(type);
+    if (!pyjob) {
+        return NULL;
+    }
 
-    (*env)->DeleteLocalRef(env, objClz);
+    pyjob->object      = pyembed_new_ref(env, obj);
+    pyjob->clazz       = pyembed_new_ref(env, info->clazz);
+    pyjob->attr        = NULL;
+    Py_INCREF(info);
+    pyjob->classInfo   = info;
+    pyjob->identityHash = hash;
+    pyjob->identity    = NULL;
 
     if (pyjobject_init(env, pyjob)) {
+        if (identity) {
+            pyjobject_identity_add(identity, pyjob);
+        }
         return (PyObject *) pyjob;
     }
     return NULL;
@@ -392,7 +1026,11 @@ PyObject* PyJObject_NewClass(JNIEnv *env, jclass clazz)
     pyjclass           = PyObject_NEW(PyJClassObject, &PyJClass_Type);
     pyjob              = (PyJObject*) pyjclass;
     pyjob->object      = NULL;
-    pyjob->clazz       = (*env)->NewGlobalRef(env, clazz);
+    pyjob->clazz       = pyembed_new_ref(env, clazz);
+    pyjob->attr        = NULL;
+    pyjob->classInfo   = NULL;
+    pyjob->identityHash = 0;
+    pyjob->identity    = NULL;
 
     if (pyjobject_init(env, pyjob)) {
         if (pyjclass_init(env, (PyObject *) pyjob)) {
@@ -406,19 +1044,31 @@ PyObject* PyJObject_NewClass(JNIEnv *env, jclass clazz)
 void pyjobject_dealloc(PyJObject *self)
 {
 #if USE_DEALLOC
-    JNIEnv *env = pyembed_get_env();
-    if (env) {
-        if (self->object) {
-            (*env)->DeleteGlobalRef(env, self->object);
-        }
-        if (self->clazz) {
-            (*env)->DeleteGlobalRef(env, self->clazz);
-        }
+    JepThread *jepThread = pyembed_find_jepthread();
+
+    /* the table of the interpreter, even if the thread has no JepThread */
+    if (self->identity) {
+        pyjobject_identity_remove(self->identity, self);
     }
+    pyembed_release_ref(self->object);
+    pyembed_release_ref(self->clazz);
 
     Py_CLEAR(self->attr);
-    Py_CLEAR(self->javaClassName);
+    Py_CLEAR(self->classInfo);
 
+    /*
+     * Keep the memory for reuse by pyjobject_alloc(). Subtypes that extend
+     * the struct and python subclasses cannot share the free list.
+     */
+    if (Py_TYPE(self)->tp_basicsize == sizeof(PyJObject)
+            && !(Py_TYPE(self)->tp_flags & Py_TPFLAGS_HEAPTYPE)
+            && jepThread && jepThread->objectFreeListSize
+            < jepThread->objectFreeListLimit) {
+        self->attr = jepThread->objectFreeList;
+        jepThread->objectFreeList = (PyObject*) self;
+        jepThread->objectFreeListSize++;
+        return;
+    }
     PyObject_Del(self);
 #endif
 }
@@ -528,7 +1178,7 @@ static PyObject* pyjobject_richcompare(PyJObject *self,
 #endif
 
             if (!(*env)->IsInstanceOf(env, self->object, JCOMPARABLE_TYPE)) {
-                char* jname = PyString_AsString(self->javaClassName);
+                char* jname = PyString_AsString(self->classInfo->javaName);
                 PyErr_Format(PyExc_TypeError, "Invalid comparison operation for Java type %s",
                              jname);
                 return NULL;
@@ -590,8 +1240,15 @@ static PyObject* pyjobject_getattro(PyObject *obj, PyObject *name)
 {
     PyObject *ret = PyObject_GenericGetAttr(obj, name);
     if (ret == NULL) {
-        return NULL;
-    } else if (PyJMethod_Check(ret) || PyJMultiMethod_Check(ret)) {
+        if (!pyjobject_try_resolve((PyJObject*) obj, name)) {
+            return NULL;
+        }
+        ret = PyObject_GenericGetAttr(obj, name);
+        if (ret == NULL) {
+            return NULL;
+        }
+    }
+    if (PyJMethod_Check(ret) || PyJMultiMethod_Check(ret)) {
         /*
          * TODO Should not bind non-static methods to pyjclass objects, but not
          * sure yet how to handle multimethods and static methods.
@@ -617,18 +1274,28 @@ static PyObject* pyjobject_getattro(PyObject *obj, PyObject *name)
 // uses obj->attr dictionary for storage.
 static int pyjobject_setattro(PyJObject *obj, PyObject *name, PyObject *v)
 {
-    PyObject *cur = NULL;
+    PyObject *cur   = NULL;
+    /* objects with a class type share the attr dict of their class */
+    PyObject *attrs = obj->attr ? obj->attr : obj->classInfo->attr;
     if (v == NULL) {
         PyErr_Format(PyExc_TypeError,
                      "Deleting attributes from PyJObjects is not allowed.");
         return -1;
     }
 
-    cur = PyDict_GetItem(obj->attr, name);
+    cur = PyDict_GetItem(attrs, name);
     if (PyErr_Occurred()) {
         return -1;
     }
 
+    if (cur == NULL && obj->classInfo && !obj->classInfo->attrComplete
+            && PyString_Check(name)) {
+        if (pyjobject_resolve_attr(pyembed_get_env(), obj, name) < 0) {
+            return -1;
+        }
+        cur = PyDict_GetItem(attrs, name);
+    }
+
     if (cur == NULL) {
         PyErr_SetString(PyExc_RuntimeError, "No such field.");
         return -1;
@@ -698,10 +1365,37 @@ static PyMethodDef pyjobject_methods[] = {
 };
 
 
-static PyMemberDef pyjobject_members[] = {
-    {"__dict__", T_OBJECT, offsetof(PyJObject, attr), READONLY},
-    {"java_name", T_OBJECT, offsetof(PyJObject, javaClassName), READONLY},
-    {0}
+static PyObject* pyjobject_get_java_name(PyJObject *self, void *closure)
+{
+    Py_INCREF(self->classInfo->javaName);
+    return self->classInfo->javaName;
+}
+
+/*
+ * The attr dict of an object of a class with lazily resolved members only
+ * holds the members that were used, so it is completed before it is exposed
+ * to python, for example by dir().
+ */
+static PyObject* pyjobject_get_dict(PyJObject *self, void *closure)
+{
+    if (self->classInfo && (!self->classInfo->attrComplete || !self->object)) {
+        if (pyjobject_complete_attr(pyembed_get_env(), self) != 0) {
+            return NULL;
+        }
+    }
+    if (!self->attr) {
+        /* the object has a class type, its members are those of its class */
+        Py_INCREF(self->classInfo->attr);
+        return self->classInfo->attr;
+    }
+    Py_INCREF(self->attr);
+    return self->attr;
+}
+
+static PyGetSetDef pyjobject_getset[] = {
+    {"__dict__", (getter) pyjobject_get_dict, NULL},
+    {"java_name", (getter) pyjobject_get_java_name, NULL},
+    {NULL} /* Sentinel */
 };
 
 
@@ -735,8 +1429,8 @@ PyTypeObject PyJObject_Type = {
     0,                                        /* tp_iter */
     0,                                        /* tp_iternext */
     pyjobject_methods,                        /* tp_methods */
-    pyjobject_members,                        /* tp_members */
-    0,                                        /* tp_getset */
+    0,                                        /* tp_members */
+    pyjobject_getset,                         /* tp_getset */
     0,                                        /* tp_base */
     0,                                        /* tp_dict */
     0,                                        /* tp_descr_get */
@@ -26,6 +26,7 @@
 */
 
 #include "jep_platform.h"
+#include "pyjclassinfo.h"
 
 #ifndef _Included_pyjobject
 #define _Included_pyjobject
@@ -41,13 +42,46 @@ typedef struct {
     jobject          object;      /* the jni object */
     jclass           clazz;       /* java class object */
     PyObject        *attr;        /* dict for get/set attr */
-    PyObject        *javaClassName; /* string of the fully-qualified name of
-                                       the object's Java clazz */
+    PyJClassInfoObject *classInfo; /* shared descriptor of the object's Java
+                                      clazz, see pyjclassinfo.h */
+    jint             identityHash; /* System.identityHashCode() of object if
+                                      it is in the identity table */
+    struct PyJObjectIdentityTable *identity; /* identity table the PyJObject
+                                                is in, or NULL */
 } PyJObject;
 
+/*
+ * A table of the live PyJObjects of an interpreter keyed by the identity of
+ * their java object, each JepThread has its own table. When enabled
+ * PyJObject_New() returns the existing PyJObject if a java object is already
+ * wrapped, so the same java object is always the same python object. The
+ * table does not own a reference to the PyJObjects, they remove themselves
+ * when they are deallocated. The table uses open addressing and is never
+ * more than half full.
+ */
+typedef struct PyJObjectIdentityTable {
+    PyObject  **slots;   /* the PyJObjects, NULL for an empty slot */
+    int         size;    /* number of slots, a power of two */
+    int         count;   /* number of PyJObjects in the table */
+    int         enabled; /* whether PyJObject_New() uses the table */
+    Py_ssize_t  hits;    /* number of wrappers found in the table */
+    Py_ssize_t  misses;  /* number of wrappers that had to be created */
+} PyJObjectIdentityTable;
+
 PyObject* PyJObject_New(JNIEnv*, jobject);
 PyObject* PyJObject_NewClass(JNIEnv*, jclass);
 int PyJObject_Check(PyObject*);
+/*
+ * Free the memory of the PyJObjects kept for reuse by a JepThread. This header
+ * is included by pyembed.h before JepThread is declared so use the struct.
+ */
+struct __JepThread;
+void PyJObject_ClearFreeList(struct __JepThread*);
+/*
+ * Free the memory of an identity table, the PyJObjects that are still alive
+ * forget the table.
+ */
+void PyJObject_ClearIdentityTable(PyJObjectIdentityTable*);
 
 void pyjobject_dealloc(PyJObject*);
 
@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2017 JEP AUTHORS.
+ *
+ * This file is licensed under the the zlib/libpng License.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any
+ * damages arising from the use of this software.
+ * 
+ * Permission is granted to anyone to use this software for any
+ * purpose, including commercial applications, and to alter it and
+ * redistribute it freely, subject to the following restrictions:
+ * 
+ *     1. The origin of this software must not be misrepresented; you
+ *     must not claim that you wrote the original software. If you use
+ *     this software in a product, an acknowledgment in the product
+ *     documentation would be appreciated but is not required.
+ * 
+ *     2. Altered source versions must be plainly marked as such, and
+ *     must not be misrepresented as being the original software.
+ * 
+ *     3. This notice may not be removed or altered from any source
+ *     distribution.
+ */
+package jep.python;
+
+import java.util.AbstractList;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.RandomAccess;
+
+import jep.Jep;
+import jep.JepException;
+
+/**
+ * A read only java.util.List backed by a Python list or tuple. Items are
+ * converted from Python each time they are read, so nothing is copied when
+ * the view is made and changes made by Python are visible through the view.
+ * Nested lists, tuples and dicts are also returned as views, the same view as
+ * long as the item is the same Python object.
+ * 
+ * Like the Python object it refers to, a view can only be used on the thread
+ * of the Jep instance that made it and only until that Jep instance is
+ * closed, other uses throw an IllegalStateException. The Python object is
+ * released when the view is closed or garbage collected. See
+ * {@link jep.JepConfig#setCollectionViews(boolean)}.
+ * 
+ * @since 3.8
+ */
+public final class PyListView extends AbstractList<Object>
+        implements RandomAccess {
+
+    final PyObject pyObject;
+
+    /* the views of nested containers by index, made when first read */
+    private Map<Integer, Object> views;
+
+    /**
+     * Made from native code, which has already taken a reference to the
+     * Python object.
+     */
+    private PyListView(Jep jep, long tstate, long obj) throws JepException {
+        this.pyObject = jep.trackView(this, new PyObject(tstate, obj, jep));
+    }
+
+    /*
+     * The pointer to the Python object of a view, or 0 if the object is not a
+     * view.
+     */
+    static long pointerOf(Object view) {
+        if (view instanceof PyListView) {
+            return ((PyListView) view).pyObject.obj;
+        } else if (view instanceof PyMapView) {
+            return ((PyMapView) view).pyObject.obj;
+        }
+        return 0;
+    }
+
+    private void checkValid() {
+        try {
+            pyObject.isValid();
+        } catch (JepException e) {
+            throw new IllegalStateException(e.getMessage(), e);
+        }
+    }
+
+    @Override
+    public int size() {
+        checkValid();
+        try {
+            return size(pyObject.tstate, pyObject.obj);
+        } catch (JepException e) {
+            throw new RuntimeException(e);
+        }
+    }
+
+    private static native int size(long tstate, long obj) throws JepException;
+
+    @Override
+    public Object get(int index) {
+        checkValid();
+        Object cached = views == null ? null : views.get(index);
+        Object item;
+        try {
+            item = get(pyObject.tstate, pyObject.obj, index, cached,
+                    pointerOf(cached));
+        } catch (JepException e) {
+            throw new RuntimeException(e);
+        }
+        if (item != cached && pointerOf(item) != 0) {
+            if (views == null) {
+                views = new HashMap<>();
+            }
+            views.put(index, item);
+        }
+        return item;
+    }
+
+    /*
+     * The cached view is returned if the item is still the Python object at
+     * cachedObj.
+     */
+    private static native Object get(long tstate, long obj, int index,
+            Object cached, long cachedObj) throws JepException;
+
+    /**
+     * Releases the Python object before the Jep instance is closed. The view
+     * cannot be used afterwards.
+     */
+    public void close() {
+        if (pyObject.obj != 0) {
+            checkValid();
+            pyObject.jep.untrackView(pyObject);
+            pyObject.close();
+        }
+        views = null;
+    }
+}
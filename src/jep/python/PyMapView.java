@@ -0,0 +1,226 @@
+/**
+ * Copyright (c) 2017 JEP AUTHORS.
+ *
+ * This file is licensed under the the zlib/libpng License.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any
+ * damages arising from the use of this software.
+ * 
+ * Permission is granted to anyone to use this software for any
+ * purpose, including commercial applications, and to alter it and
+ * redistribute it freely, subject to the following restrictions:
+ * 
+ *     1. The origin of this software must not be misrepresented; you
+ *     must not claim that you wrote the original software. If you use
+ *     this software in a product, an acknowledgment in the product
+ *     documentation would be appreciated but is not required.
+ * 
+ *     2. Altered source versions must be plainly marked as such, and
+ *     must not be misrepresented as being the original software.
+ * 
+ *     3. This notice may not be removed or altered from any source
+ *     distribution.
+ */
+package jep.python;
+
+import java.util.AbstractMap;
+import java.util.AbstractSet;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.Map;
+import java.util.NoSuchElementException;
+import java.util.Set;
+
+import jep.Jep;
+import jep.JepException;
+
+/**
+ * A read only java.util.Map backed by a Python dict. Looking up a key only
+ * converts that key and its value, so nothing is copied when the view is made
+ * and changes made by Python are visible through the view. Iterating converts
+ * the entries that are in the dict when the iteration starts. Nested lists,
+ * tuples and dicts are also returned as views, the same view as long as the
+ * value is the same Python object.
+ * 
+ * Like the Python object it refers to, a view can only be used on the thread
+ * of the Jep instance that made it and only until that Jep instance is
+ * closed, other uses throw an IllegalStateException. The Python object is
+ * released when the view is closed or garbage collected. See
+ * {@link jep.JepConfig#setCollectionViews(boolean)}.
+ * 
+ * @since 3.8
+ */
+public final class PyMapView extends AbstractMap<Object, Object> {
+
+    final PyObject pyObject;
+
+    /* the views of nested containers by key, made when first read */
+    private Map<Object, Object> views;
+
+    /*
+     * The views of the last items(), at the same positions, and the pointers
+     * to their Python objects. Null if there were none.
+     */
+    private Object[] itemViews;
+
+    private long[] itemObjs;
+
+    /**
+     * Made from native code, which has already taken a reference to the
+     * Python object.
+     */
+    private PyMapView(Jep jep, long tstate, long obj) throws JepException {
+        this.pyObject = jep.trackView(this, new PyObject(tstate, obj, jep));
+    }
+
+    private void checkValid() {
+        try {
+            pyObject.isValid();
+        } catch (JepException e) {
+            throw new IllegalStateException(e.getMessage(), e);
+        }
+    }
+
+    @Override
+    public int size() {
+        checkValid();
+        try {
+            return size(pyObject.tstate, pyObject.obj);
+        } catch (JepException e) {
+            throw new RuntimeException(e);
+        }
+    }
+
+    private static native int size(long tstate, long obj) throws JepException;
+
+    @Override
+    public Object get(Object key) {
+        checkValid();
+        Object cached = views == null ? null : views.get(key);
+        Object value;
+        try {
+            value = get(pyObject.tstate, pyObject.obj, key, false, cached,
+                    PyListView.pointerOf(cached));
+        } catch (JepException e) {
+            throw new RuntimeException(e);
+        }
+        if (value != cached && PyListView.pointerOf(value) != 0) {
+            if (views == null) {
+                views = new HashMap<>();
+            }
+            views.put(key, value);
+        }
+        return value;
+    }
+
+    @Override
+    public boolean containsKey(Object key) {
+        checkValid();
+        try {
+            return get(pyObject.tstate, pyObject.obj, key, true, null,
+                    0) != null;
+        } catch (JepException e) {
+            throw new RuntimeException(e);
+        }
+    }
+
+    /*
+     * Looks up a key, if contains is true the result is Boolean.TRUE if the
+     * key is in the dict, otherwise it is the converted value. The result is
+     * null if the key is not in the dict. The cached view is returned if the
+     * value is still the Python object at cachedObj.
+     */
+    private static native Object get(long tstate, long obj, Object key,
+            boolean contains, Object cached, long cachedObj)
+            throws JepException;
+
+    @Override
+    public Set<Map.Entry<Object, Object>> entrySet() {
+        return new AbstractSet<Map.Entry<Object, Object>>() {
+
+            @Override
+            public int size() {
+                return PyMapView.this.size();
+            }
+
+            @Override
+            public Iterator<Map.Entry<Object, Object>> iterator() {
+                checkValid();
+                final Object[] items;
+                try {
+                    items = items(pyObject.tstate, pyObject.obj, itemViews,
+                            itemObjs);
+                } catch (JepException e) {
+                    throw new RuntimeException(e);
+                }
+                cacheItemViews(items);
+                return new Iterator<Map.Entry<Object, Object>>() {
+
+                    private int index = 0;
+
+                    @Override
+                    public boolean hasNext() {
+                        return index < items.length;
+                    }
+
+                    @Override
+                    public Map.Entry<Object, Object> next() {
+                        if (index >= items.length) {
+                            throw new NoSuchElementException();
+                        }
+                        Map.Entry<Object, Object> entry = new SimpleImmutableEntry<>(
+                                items[index], items[index + 1]);
+                        index += 2;
+                        return entry;
+                    }
+
+                    @Override
+                    public void remove() {
+                        throw new UnsupportedOperationException();
+                    }
+                };
+            }
+        };
+    }
+
+    /* Remember the views in the result of items() for the next call */
+    private void cacheItemViews(Object[] items) {
+        itemViews = null;
+        itemObjs = null;
+        for (int i = 0; i < items.length; i++) {
+            long itemObj = PyListView.pointerOf(items[i]);
+            if (itemObj != 0) {
+                if (itemViews == null) {
+                    itemViews = new Object[items.length];
+                    itemObjs = new long[items.length];
+                }
+                itemViews[i] = items[i];
+                itemObjs[i] = itemObj;
+            }
+        }
+    }
+
+    /*
+     * Converts every key and value of the dict, they alternate in the
+     * returned array. A view in cached is reused if the key or value at the
+     * same position is still the Python object in cachedObjs.
+     */
+    private static native Object[] items(long tstate, long obj,
+            Object[] cached, long[] cachedObjs) throws JepException;
+
+    /**
+     * Releases the Python object before the Jep instance is closed. The view
+     * cannot be used afterwards.
+     */
+    public void close() {
+        if (pyObject.obj != 0) {
+            checkValid();
+            pyObject.jep.untrackView(pyObject);
+            pyObject.close();
+        }
+        views = null;
+        itemViews = null;
+        itemObjs = null;
+    }
+}
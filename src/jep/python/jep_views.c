@@ -0,0 +1,226 @@
+/*
+   jep - Java Embedded Python
+
+   Copyright (c) 2017 JEP_AUTHORS.
+
+   This file is licensed under the the zlib/libpng License.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+   must not claim that you wrote the original software. If you use
+   this software in a product, an acknowledgment in the product
+   documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+   must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+/*
+ * Natives of jep.python.PyListView and jep.python.PyMapView. The java side
+ * checks that the view is used on the thread of an open Jep before calling
+ * these, so the JepThread is valid and only the GIL has to be acquired.
+ */
+
+#include "Jep.h"
+
+
+/*
+ * Converts an item of a view, containers are returned as views too. The
+ * cached view is the view the java side made for the same position before
+ * and the pointer is its python object, it is reused if the item is still
+ * that object. Maps python IndexError to IndexOutOfBoundsException, any other
+ * error is thrown as a JepException. Hold the GIL before calling.
+ */
+static jobject jep_view_item(JNIEnv *env, PyObject *item, jobject cached,
+                             jlong cachedPtr)
+{
+    jobject result = NULL;
+
+    if (item && cached && item == (PyObject *) (intptr_t) cachedPtr) {
+        result = (*env)->NewLocalRef(env, cached);
+    } else if (item) {
+        result = PyObject_As_jview(env, item);
+    }
+    if (PyErr_Occurred()) {
+        if (PyErr_ExceptionMatches(PyExc_IndexError)) {
+            PyErr_Clear();
+            (*env)->ThrowNew(env, INDEX_EXC_TYPE, "list index out of range");
+        } else {
+            process_py_exception(env);
+        }
+    }
+    return result;
+}
+
+
+static jint jep_view_size(JNIEnv *env, jlong tstate, jlong ptr)
+{
+    JepThread  *jepThread = (JepThread *) tstate;
+    Py_ssize_t  size;
+
+    PyEval_AcquireThread(jepThread->tstate);
+    size = PyObject_Size((PyObject *) ptr);
+    process_py_exception(env);
+    PyEval_ReleaseThread(jepThread->tstate);
+    return (jint) size;
+}
+
+
+/*
+ * Class:     jep_python_PyListView
+ * Method:    size
+ * Signature: (JJ)I
+ */
+JNIEXPORT jint JNICALL Java_jep_python_PyListView_size
+(JNIEnv *env, jclass clazz, jlong tstate, jlong ptr)
+{
+    return jep_view_size(env, tstate, ptr);
+}
+
+
+/*
+ * Class:     jep_python_PyListView
+ * Method:    get
+ * Signature: (JJILjava/lang/Object;J)Ljava/lang/Object;
+ */
+JNIEXPORT jobject JNICALL Java_jep_python_PyListView_get
+(JNIEnv *env, jclass clazz, jlong tstate, jlong ptr, jint index,
+ jobject cached, jlong cachedPtr)
+{
+    JepThread *jepThread = (JepThread *) tstate;
+    PyObject  *item      = NULL;
+    jobject    result;
+
+    PyEval_AcquireThread(jepThread->tstate);
+    if (index < 0) {
+        /* python would count from the end */
+        PyErr_SetString(PyExc_IndexError, "list index out of range");
+    } else {
+        item = PySequence_GetItem((PyObject *) ptr, index);
+    }
+    result = jep_view_item(env, item, cached, cachedPtr);
+    Py_XDECREF(item);
+    PyEval_ReleaseThread(jepThread->tstate);
+    return result;
+}
+
+
+/*
+ * Class:     jep_python_PyMapView
+ * Method:    size
+ * Signature: (JJ)I
+ */
+JNIEXPORT jint JNICALL Java_jep_python_PyMapView_size
+(JNIEnv *env, jclass clazz, jlong tstate, jlong ptr)
+{
+    return jep_view_size(env, tstate, ptr);
+}
+
+
+/*
+ * Class:     jep_python_PyMapView
+ * Method:    get
+ * Signature: (JJLjava/lang/Object;ZLjava/lang/Object;J)Ljava/lang/Object;
+ */
+JNIEXPORT jobject JNICALL Java_jep_python_PyMapView_get
+(JNIEnv *env, jclass clazz, jlong tstate, jlong ptr, jobject jkey,
+ jboolean contains, jobject cached, jlong cachedPtr)
+{
+    JepThread *jepThread = (JepThread *) tstate;
+    PyObject  *key;
+    PyObject  *value     = NULL;
+    jobject    result    = NULL;
+
+    PyEval_AcquireThread(jepThread->tstate);
+    key = convert_jobject_pyobject(env, jkey);
+    if (key) {
+        /* borrowed, unhashable keys are simply not found */
+        value = PyDict_GetItem((PyObject *) ptr, key);
+        Py_DECREF(key);
+    }
+    if (!value) {
+        process_py_exception(env);
+    } else if (contains) {
+        result = JBox_Boolean(env, JNI_TRUE);
+    } else {
+        result = jep_view_item(env, value, cached, cachedPtr);
+    }
+    PyEval_ReleaseThread(jepThread->tstate);
+    return result;
+}
+
+
+/*
+ * Converts a key or value for items(), reusing the view at the same position
+ * of the previous items() if it is still a view of the same python object.
+ */
+static jobject jep_view_entry(JNIEnv *env, PyObject *pyobject, jsize i,
+                              jobjectArray cached, jlongArray cachedPtrs)
+{
+    jobject result;
+    jlong   cachedPtr = 0;
+
+    if (cached && i < (*env)->GetArrayLength(env, cachedPtrs)) {
+        (*env)->GetLongArrayRegion(env, cachedPtrs, i, 1, &cachedPtr);
+    }
+    if (cachedPtr && pyobject == (PyObject *) (intptr_t) cachedPtr) {
+        result = (*env)->GetObjectArrayElement(env, cached, i);
+        if (result) {
+            return result;
+        }
+    }
+    return PyObject_As_jview(env, pyobject);
+}
+
+
+/*
+ * Class:     jep_python_PyMapView
+ * Method:    items
+ * Signature: (JJ[Ljava/lang/Object;[J)[Ljava/lang/Object;
+ */
+JNIEXPORT jobjectArray JNICALL Java_jep_python_PyMapView_items
+(JNIEnv *env, jclass clazz, jlong tstate, jlong ptr, jobjectArray cached,
+ jlongArray cachedPtrs)
+{
+    JepThread    *jepThread = (JepThread *) tstate;
+    PyObject     *dict      = (PyObject *) ptr;
+    PyObject     *key, *value;
+    Py_ssize_t    pos       = 0;
+    jsize         i         = 0;
+    jsize         length;
+    jobjectArray  result;
+
+    PyEval_AcquireThread(jepThread->tstate);
+    length = (jsize) (PyDict_Size(dict) * 2);
+    result = (*env)->NewObjectArray(env, length, JOBJECT_TYPE, NULL);
+    while (result && i < length && PyDict_Next(dict, &pos, &key, &value)) {
+        jobject jkey   = jep_view_entry(env, key, i, cached, cachedPtrs);
+        jobject jvalue = NULL;
+        if (!PyErr_Occurred()) {
+            jvalue = jep_view_entry(env, value, i + 1, cached, cachedPtrs);
+        }
+        if (PyErr_Occurred()) {
+            (*env)->DeleteLocalRef(env, jkey);
+            (*env)->DeleteLocalRef(env, result);
+            result = NULL;
+            process_py_exception(env);
+            break;
+        }
+        (*env)->SetObjectArrayElement(env, result, i++, jkey);
+        (*env)->SetObjectArrayElement(env, result, i++, jvalue);
+        (*env)->DeleteLocalRef(env, jkey);
+        (*env)->DeleteLocalRef(env, jvalue);
+    }
+    PyEval_ReleaseThread(jepThread->tstate);
+    return result;
+}
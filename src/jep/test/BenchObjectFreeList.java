@@ -0,0 +1,59 @@
+package jep.test;
+
+import java.util.ArrayList;
+import java.util.List;
+
+import jep.Jep;
+import jep.JepConfig;
+import jep.JepException;
+
+/**
+ * Compares the time to wrap many short lived Java objects in Python with and
+ * without reusing freed wrappers, see JepConfig.setObjectFreeListSize(int).
+ * This is not part of the unit tests, run it with the jep jar and the test
+ * classes on the classpath.
+ *
+ * Created: October 2026
+ */
+public class BenchObjectFreeList {
+
+    private static final int SIZE = 100000;
+
+    private static final int REPEAT = 20;
+
+    private static double bench(List<Object> objects, int freeListSize)
+            throws JepException {
+        JepConfig config = new JepConfig().addIncludePaths(".")
+                .setObjectFreeListSize(freeListSize);
+        try (Jep jep = new Jep(config)) {
+            jep.set("objects", objects);
+            jep.eval("import time");
+            jep.eval("def run():\n" + "    best = None\n"
+                    + "    for i in range(" + REPEAT + "):\n"
+                    + "        start = time.time()\n"
+                    + "        for o in objects:\n"
+                    + "            o.hashCode\n"
+                    + "        elapsed = time.time() - start\n"
+                    + "        if best is None or elapsed < best:\n"
+                    + "            best = elapsed\n" + "    return best\n");
+            jep.eval("best = run()");
+            return ((Number) jep.getValue("best")).doubleValue();
+        }
+    }
+
+    public static void main(String[] args) throws JepException {
+        List<Object> objects = new ArrayList<>(SIZE);
+        for (int i = 0; i < SIZE; i += 1) {
+            objects.add(new Object());
+        }
+        double without = bench(objects, 0);
+        double with = bench(objects, 256);
+        System.out.printf("free list disabled %8.1f ns per object%n",
+                without / SIZE * 1e9);
+        System.out.printf("free list enabled  %8.1f ns per object%n",
+                with / SIZE * 1e9);
+        System.out.printf("speedup            %8.2fx%n", without / with);
+        System.exit(0);
+    }
+
+}
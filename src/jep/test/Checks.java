@@ -0,0 +1,48 @@
+package jep.test;
+
+import jep.Jep;
+import jep.JepException;
+
+/**
+ * Checks shared by the tests with a main() that set up their own Jep
+ * instance. A failed check throws an exception so the process exits with an
+ * error.
+ * 
+ * Created: October 2026
+ */
+public final class Checks {
+
+    private Checks() {
+    }
+
+    /**
+     * Checks that a Python expression evaluates to True.
+     * 
+     * @param jep
+     *            the Jep instance to evaluate the expression in
+     * @param expression
+     *            a Python expression
+     * @throws JepException
+     *             if the expression cannot be evaluated
+     */
+    public static void check(Jep jep, String expression) throws JepException {
+        if (!Boolean.TRUE.equals(jep.getValue(expression))) {
+            throw new IllegalStateException(expression + " is not True");
+        }
+    }
+
+    /**
+     * Checks that a condition is true.
+     * 
+     * @param condition
+     *            the condition
+     * @param message
+     *            the message of the exception thrown if it is false
+     */
+    public static void check(boolean condition, String message) {
+        if (!condition) {
+            throw new IllegalStateException(message);
+        }
+    }
+
+}
@@ -0,0 +1,55 @@
+package jep.test;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.LinkedList;
+import java.util.List;
+import java.util.Map;
+
+import jep.Jep;
+import jep.JepConfig;
+import jep.JepException;
+import jep.test.types.TestFieldTypes;
+
+/**
+ * Tests that Java objects are instances of a Python type per Java class that
+ * follows the Java superclass chain when class types are enabled.
+ * 
+ * Created: October 2026
+ */
+public class TestClassTypes {
+
+    public static void main(String[] args) throws JepException {
+        List<Object> list = new ArrayList<>();
+        list.add("a");
+        list.add(1);
+        Map<String, Object> map = new HashMap<>();
+        map.put("a", 1);
+
+        JepConfig config = new JepConfig().addIncludePaths(".")
+                .setClassTypes(true);
+        try (Jep jep = new Jep(config)) {
+            jep.set("l", list);
+            jep.set("m", map);
+            jep.set("k", new LinkedList<Object>());
+            jep.set("f", new TestFieldTypes());
+            Checks.check(jep, "type(l).__name__ == 'ArrayList'");
+            Checks.check(jep, "type(l).__module__ == 'java.util'");
+            Checks.check(jep, "type(l).__mro__[1].__name__ == 'AbstractList'");
+            Checks.check(jep, "'size' in type(l).__dict__");
+            Checks.check(jep, "type(l) is type(l.clone())");
+            Checks.check(jep, "l.size() == 2 and len(l) == 2");
+            Checks.check(jep, "list(l) == ['a', 1]");
+            Checks.check(jep, "l.java_name == 'java.util.ArrayList'");
+            Checks.check(jep, "'size' in dir(l)");
+            Checks.check(jep, "type(m).__name__ == 'HashMap'");
+            Checks.check(jep, "m['a'] == 1 and m.get('a') == 1");
+            Checks.check(jep, "isinstance(k, type(l).__mro__[1])");
+            Checks.check(jep, "not isinstance(k, type(l))");
+            jep.eval("f.primitiveInt = 7");
+            Checks.check(jep, "f.primitiveInt == 7");
+        }
+        System.exit(0);
+    }
+
+}
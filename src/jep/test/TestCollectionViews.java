@@ -0,0 +1,117 @@
+package jep.test;
+
+import java.util.List;
+import java.util.Map;
+
+import jep.Jep;
+import jep.JepConfig;
+import jep.JepException;
+import jep.python.PyListView;
+import jep.python.PyMapView;
+
+/**
+ * Tests that Python containers are given to Java as views when collection
+ * views are enabled, that the views see changes made by Python, that nested
+ * views are reused, that the Python objects of closed or collected views are
+ * released and that they cannot be used after the Jep instance is closed.
+ * 
+ * Created: October 2026
+ */
+public class TestCollectionViews {
+
+    public static void main(String[] args) throws JepException {
+        List<?> list;
+        JepConfig config = new JepConfig().addIncludePaths(".")
+                .setCollectionViews(true);
+        try (Jep jep = new Jep(config)) {
+            jep.eval("l = [1, 'two', (3.0, None), {'k': [4]}]");
+            list = (List<?>) jep.getValue("l");
+            Checks.check(list instanceof PyListView, "list is not a view");
+            Checks.check(list.size() == 4, "wrong size " + list.size());
+            Checks.check(Long.valueOf(1).equals(list.get(0)), "wrong item 0");
+            Checks.check("two".equals(list.get(1)), "wrong item 1");
+            List<?> tuple = (List<?>) list.get(2);
+            Checks.check(tuple instanceof PyListView, "tuple is not a view");
+            Checks.check(tuple.get(1) == null, "wrong tuple item");
+            Map<?, ?> dict = (Map<?, ?>) list.get(3);
+            Checks.check(dict instanceof PyMapView, "dict is not a view");
+            Checks.check(dict.containsKey("k"), "missing key");
+            Checks.check(!dict.containsKey("x"), "unexpected key");
+            Checks.check(((List<?>) dict.get("k")).size() == 1,
+                    "wrong nested list");
+            Checks.check(dict.entrySet().iterator().next().getKey().equals("k"),
+                    "wrong entry");
+
+            jep.eval("l.append(5)");
+            Checks.check(list.size() == 5, "view does not see changes");
+            boolean outOfBounds = false;
+            try {
+                list.get(5);
+            } catch (IndexOutOfBoundsException e) {
+                outOfBounds = true;
+            }
+            Checks.check(outOfBounds, "no IndexOutOfBoundsException");
+
+            /* nested views are made once per python object */
+            Checks.check(list.get(2) == tuple, "tuple view was not reused");
+            Checks.check(dict.get("k") == dict.get("k"),
+                    "list view was not reused");
+            Checks.check(dict.entrySet().iterator().next().getValue() == dict
+                    .entrySet().iterator().next().getValue(),
+                    "entry view was not reused");
+            jep.eval("l[2] = (6,)");
+            Checks.check(list.get(2) != tuple,
+                    "view of a replaced item was reused");
+            Checks.check(((List<?>) list.get(2)).size() == 1,
+                    "wrong replaced item");
+
+            /* closed and collected views release their python object */
+            jep.eval("import sys");
+            jep.eval("inner = [7]");
+            jep.eval("base = sys.getrefcount(inner)");
+            PyListView inner = (PyListView) jep.getValue("inner");
+            Checks.check(Boolean.TRUE.equals(jep.getValue(
+                    "sys.getrefcount(inner) == base + 1")), "view not counted");
+            inner.close();
+            Checks.check(Boolean.TRUE.equals(jep.getValue(
+                    "sys.getrefcount(inner) == base")), "closed view leaked");
+            jep.getValue("inner");
+            boolean released = false;
+            for (int i = 0; i < 100 && !released; i++) {
+                System.gc();
+                try {
+                    Thread.sleep(10);
+                } catch (InterruptedException e) {
+                    break;
+                }
+                released = Boolean.TRUE.equals(jep.getValue(
+                        "sys.getrefcount(inner) == base"));
+            }
+            Checks.check(released, "collected view leaked");
+
+            /* an explicit ArrayList parameter still gets a copy */
+            jep.eval("from java.util import ArrayList");
+            Checks.check(Boolean.TRUE.equals(jep.getValue(
+                    "ArrayList([1, 2]).getClass().getName() == 'java.util.ArrayList'")),
+                    "ArrayList was not copied");
+        }
+        boolean closed = false;
+        try {
+            list.size();
+        } catch (IllegalStateException e) {
+            closed = true;
+        }
+        Checks.check(closed, "view is usable after close");
+
+        try (Jep jep = new Jep(new JepConfig().addIncludePaths("."))) {
+            Checks.check(!(jep.getValue("[1]") instanceof PyListView),
+                    "view without the option");
+        }
+        System.exit(0);
+    }
+
+    public static int sizeOf(PyListView view) {
+        return view.size();
+    }
+
+}
@@ -0,0 +1,79 @@
+package jep.test;
+
+import java.util.ArrayList;
+import java.util.List;
+
+import jep.Jep;
+import jep.JepConfig;
+import jep.JepException;
+
+/**
+ * Tests that Java methods called with the adaptive GIL policy and methods
+ * that are configured to keep the GIL still work, including after the
+ * adaptive policy has decided to keep the GIL for a method, that a slow call
+ * makes such a method release the GIL again and that methods which call back
+ * into Python are never made to keep it.
+ * 
+ * Created: October 2026
+ */
+public final class TestGILPolicy {
+
+    public static void main(String[] args) throws JepException {
+        List<Object> list = new ArrayList<>();
+        list.add("a");
+
+        JepConfig config = new JepConfig().addIncludePaths(".")
+                .setAdaptiveGIL(true)
+                .addKeepGILMethods("java.util.ArrayList.size");
+        try (Jep jep = new Jep(config)) {
+            jep.set("l", list);
+            Checks.check(jep, "all(l.size() == 1 for i in range(100))");
+            Checks.check(jep, "all(l.get(0) == 'a' for i in range(100))");
+            Checks.check(jep, "all(l.isEmpty() is False for i in range(100))");
+            jep.eval("from java.lang import Thread");
+            jep.eval("Thread.sleep(10)");
+            jep.eval("l.add('b')");
+            Checks.check(jep, "l.size() == 2");
+
+            // a final class with primitive parameters can keep the GIL
+            jep.eval("from java.lang import StringBuilder");
+            jep.eval("sb = StringBuilder('ab')");
+            Checks.check(jep, "all(sb.length() == 2 for i in range(100))");
+            Checks.check(jep, "all(sb.charAt(1) == 'b' for i in range(100))");
+
+            // methods that call back into python never keep it
+            jep.eval("calls = []");
+            jep.eval("r = jep.jproxy(type('R', (object,), "
+                    + "{'run': lambda self: calls.append(1)})(), "
+                    + "['java.lang.Runnable'])");
+            Checks.check(jep, "all(r.run() is None for i in range(100))");
+            Checks.check(jep, "len(calls) == 100");
+            jep.eval("c = jep.jproxy(type('C', (object,), "
+                    + "{'accept': lambda self, x: calls.append(x)})(), "
+                    + "['java.util.function.Consumer'])");
+            Checks.check(jep, "all(l.forEach(c) is None for i in range(100))");
+            Checks.check(jep, "len(calls) == 300");
+
+            // a method that becomes slow releases the GIL again
+            jep.eval("from jep.test import TestGILPolicy");
+            jep.eval("w = TestGILPolicy()");
+            Checks.check(jep, "all(w.pause(0) is None for i in range(20))");
+            Checks.check(jep, "all(w.pause(2) is None for i in range(100))");
+            jep.eval("import threading, time");
+            jep.eval("ticks = []");
+            jep.eval("t = threading.Thread(target=lambda: "
+                    + "[ticks.append(time.sleep(0.001)) for i in range(20)])");
+            jep.eval("t.start()");
+            Checks.check(jep, "w.pause(200) is None and len(ticks) >= 5");
+            jep.eval("t.join()");
+        }
+        System.exit(0);
+    }
+
+    public void pause(long millis) throws InterruptedException {
+        if (millis > 0) {
+            Thread.sleep(millis);
+        }
+    }
+
+}
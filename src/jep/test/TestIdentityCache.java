@@ -0,0 +1,59 @@
+package jep.test;
+
+import java.util.ArrayList;
+import java.util.List;
+
+import jep.Jep;
+import jep.JepConfig;
+import jep.JepException;
+
+/**
+ * Tests that a Java object which crosses into Python while its wrapper is
+ * still alive reuses the wrapper when the identity cache is enabled, and that
+ * wrappers are removed from the cache when they are freed, also on threads
+ * started by Python.
+ * 
+ * Created: October 2026
+ */
+public class TestIdentityCache {
+
+    public static void main(String[] args) throws JepException {
+        Object shared = new Object();
+        List<Object> list = new ArrayList<>();
+        list.add(shared);
+        list.add(new Object());
+
+        JepConfig config = new JepConfig().addIncludePaths(".")
+                .setIdentityCache(true);
+        try (Jep jep = new Jep(config)) {
+            jep.set("a", shared);
+            jep.set("b", shared);
+            jep.set("l", list);
+            Checks.check(jep, "a is b");
+            Checks.check(jep, "l.get(0) is a");
+            Checks.check(jep, "l.get(1) is l.get(1)");
+            Checks.check(jep, "l.get(1) is not a");
+            Checks.check(jep, "jep.identityCacheStats()['hits'] >= 3");
+            jep.eval("size = jep.identityCacheStats()['size']");
+            jep.eval("del a, b");
+            Checks.check(jep, "jep.identityCacheStats()['size'] == size - 1");
+            Checks.check(jep, "l.get(0).hashCode() == l.get(0).hashCode()");
+
+            // a wrapper freed on a thread started by python leaves the cache
+            jep.eval("import threading");
+            jep.eval("c = l.get(0)");
+            Checks.check(jep, "jep.identityCacheStats()['size'] == size");
+            jep.eval("t = threading.Thread(target=lambda: globals().pop('c'))");
+            jep.eval("t.start()");
+            jep.eval("t.join()");
+            Checks.check(jep, "'c' not in globals()");
+            Checks.check(jep, "jep.identityCacheStats()['size'] == size - 1");
+            jep.eval("d = l.get(0)");
+            Checks.check(jep, "d is l.get(0)");
+            Checks.check(jep, "d.equals(l.get(0))");
+            Checks.check(jep, "jep.identityCacheStats()['size'] == size");
+        }
+        System.exit(0);
+    }
+
+}
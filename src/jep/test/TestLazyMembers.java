@@ -0,0 +1,42 @@
+package jep.test;
+
+import jep.Jep;
+import jep.JepConfig;
+import jep.JepException;
+
+/**
+ * Tests that methods and fields are resolved correctly when a Jep is
+ * configured to resolve the members of Java classes lazily.
+ * 
+ * Created: October 2026
+ */
+public class TestLazyMembers {
+
+    public static void main(String[] args) throws JepException {
+        JepConfig config = new JepConfig().addIncludePaths(".")
+                .setLazyMembers(true);
+        try (Jep jep = new Jep(config)) {
+            jep.eval("from java.util import ArrayList");
+            jep.eval("from java.lang import Integer");
+            jep.eval("x = ArrayList()");
+            /* add is overloaded so it must become a PyJMultiMethod */
+            jep.eval("x.add('a')");
+            jep.eval("x.add(0, 'b')");
+            Checks.check(jep, "x.size() == 2");
+            Checks.check(jep, "x.get(0) == 'b'");
+            Checks.check(jep,
+                    "type(x.__dict__['add']).__name__ == 'PyJMultiMethod'");
+            Checks.check(jep, "Integer.MAX_VALUE == 2147483647");
+            Checks.check(jep, "Integer.valueOf(7).intValue() == 7");
+            Checks.check(jep, "not hasattr(x, 'notAMember')");
+            Checks.check(jep, "not hasattr(x, 'notAMember')");
+            /* dir() and __dict__ must still show every member */
+            Checks.check(jep, "'isEmpty' in dir(x)");
+            Checks.check(jep, "'trimToSize' in x.__dict__");
+            Checks.check(jep, "'MIN_VALUE' in dir(Integer)");
+            Checks.check(jep, "x.isEmpty() == False");
+        }
+        System.exit(0);
+    }
+
+}
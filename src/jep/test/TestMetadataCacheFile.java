@@ -0,0 +1,75 @@
+package jep.test;
+
+import java.io.File;
+import java.io.IOException;
+import java.io.PrintWriter;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.List;
+
+import jep.Jep;
+import jep.JepConfig;
+import jep.JepException;
+import jep.Util;
+
+/**
+ * Tests that a metadata cache file is used for classes loaded from the same
+ * place as when it was written, is ignored for classes that have changed, and
+ * is written when the Jep is closed.
+ * 
+ * Created: October 2026
+ */
+public class TestMetadataCacheFile {
+
+    public static void main(String[] args) throws JepException, IOException {
+        File file = File.createTempFile("jep", ".metadata");
+        try {
+            /*
+             * Only record size() for ArrayList so it is obvious whether the
+             * file was used. HashMap has the wrong fingerprint so it must be
+             * reflected on.
+             */
+            try (PrintWriter writer = new PrintWriter(file, "UTF-8")) {
+                writer.print("jep metadata 1\n");
+                writer.print("C\tjava.util.ArrayList\t"
+                        + Util.getFingerprint(ArrayList.class) + "\n");
+                writer.print("M\t0\tsize\t()I\n");
+                writer.print("C\tjava.util.HashMap\tstale\n");
+                writer.print("M\t0\tsize\t()I\n");
+            }
+
+            JepConfig config = new JepConfig().addIncludePaths(".")
+                    .setMetadataCacheFile(file.getAbsolutePath());
+            try (Jep jep = new Jep(config)) {
+                jep.eval("from java.util import ArrayList, HashMap");
+                jep.eval("x = ArrayList()");
+                Checks.check(jep, "x.size() == 0");
+                Checks.check(jep, "not hasattr(x, 'isEmpty')");
+                Checks.check(jep, "HashMap().isEmpty()");
+            }
+
+            List<String> lines = Files.readAllLines(file.toPath(),
+                    StandardCharsets.UTF_8);
+            if (!lines.get(0).equals("jep metadata 1")) {
+                throw new IllegalStateException("Invalid header " + lines.get(0));
+            }
+            boolean found = false;
+            for (String line : lines) {
+                if (line.equals("M\t0\tisEmpty\t()Z")) {
+                    found = true;
+                }
+                if (line.contains("stale")) {
+                    throw new IllegalStateException("Stale class was saved");
+                }
+            }
+            if (!found) {
+                throw new IllegalStateException("HashMap.isEmpty was not saved");
+            }
+        } finally {
+            file.delete();
+        }
+        System.exit(0);
+    }
+
+}
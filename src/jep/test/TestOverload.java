@@ -108,6 +108,14 @@ public class TestOverload {
         return "ArrayList";
     }
 
+    public static String Integer_or_String(Integer i){
+        return "Integer";
+    }
+
+    public static String Integer_or_String(String s){
+        return "String";
+    }
+
     public static String ArrayList_or_List(ArrayList a){
         return "ArrayList";
     }
@@ -0,0 +1,43 @@
+package jep.test;
+
+import jep.Jep;
+import jep.JepConfig;
+import jep.JepException;
+
+/**
+ * Tests that Java classes work in interpreters that build their methods and
+ * fields from the metadata created by an earlier interpreter, with both eager
+ * and lazy member resolution.
+ * 
+ * Created: October 2026
+ */
+public class TestSharedMetadata {
+
+    private static void use(JepConfig config) throws JepException {
+        try (Jep jep = new Jep(config)) {
+            jep.eval("from java.util import ArrayList");
+            jep.eval("from java.lang import Integer");
+            jep.eval("x = ArrayList()");
+            jep.eval("x.add('a')");
+            jep.eval("x.add(0, 'b')");
+            Checks.check(jep, "x.size() == 2");
+            Checks.check(jep, "x.get(0) == 'b'");
+            Checks.check(jep,
+                    "type(x.__dict__['add']).__name__ == 'PyJMultiMethod'");
+            Checks.check(jep, "Integer.MAX_VALUE == 2147483647");
+            Checks.check(jep, "Integer.valueOf(7).intValue() == 7");
+            Checks.check(jep, "'trimToSize' in dir(x)");
+        }
+    }
+
+    public static void main(String[] args) throws JepException {
+        JepConfig config = new JepConfig().addIncludePaths(".");
+        JepConfig lazy = new JepConfig().addIncludePaths(".")
+                .setLazyMembers(true);
+        use(config);
+        use(config);
+        use(lazy);
+        System.exit(0);
+    }
+
+}
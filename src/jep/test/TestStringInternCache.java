@@ -0,0 +1,48 @@
+package jep.test;
+
+import java.util.ArrayList;
+import java.util.List;
+
+import jep.Jep;
+import jep.JepConfig;
+import jep.JepException;
+
+/**
+ * Tests that equal short Java strings are converted to the same interned
+ * Python string when the string intern cache is enabled and that long strings
+ * are not cached.
+ * 
+ * Created: October 2026
+ */
+public class TestStringInternCache {
+
+    public static void main(String[] args) throws JepException {
+        StringBuilder longString = new StringBuilder();
+        for (int i = 0; i < 40; i += 1) {
+            longString.append('x');
+        }
+        List<String> list = new ArrayList<>();
+        list.add(new String("key"));
+        list.add(new String("key"));
+        list.add(new String("k\u00e9y\u263A"));
+        list.add(new String("k\u00e9y\u263A"));
+        list.add(longString.toString());
+        list.add(longString.toString());
+
+        JepConfig config = new JepConfig().addIncludePaths(".")
+                .setStringInternCacheSize(64);
+        try (Jep jep = new Jep(config)) {
+            jep.set("l", list);
+            Checks.check(jep, "jep.internCacheStats()['size'] == 64");
+            Checks.check(jep, "l.get(0) is l.get(1)");
+            Checks.check(jep, "l.get(0) == 'key'");
+            Checks.check(jep, "l.get(2) is l.get(3)");
+            Checks.check(jep, "l.get(2) == 'k\\u00e9y\\u263A'");
+            Checks.check(jep, "l.get(4) is not l.get(5)");
+            Checks.check(jep, "l.get(4) == l.get(5)");
+            Checks.check(jep, "jep.internCacheStats()['hits'] >= 2");
+        }
+        System.exit(0);
+    }
+
+}
@@ -0,0 +1,56 @@
+"""
+Compares the cost of calling java methods through the tuple based tp_call
+with the vectorcall entry point that is used on python 3.8 and newer. The
+tuple calls go through __call__, which always packs the arguments into a
+tuple and calls tp_call. This is not part of the unit tests, run it from the
+top level directory with `jep tests/bench_call.py`.
+"""
+import sys
+import timeit
+
+from java.util import ArrayList
+from java.lang import Integer
+
+NUMBER = 200000
+
+
+def report(name, tuple_stmt, vector_stmt, namespace):
+    tuple_time = min(timeit.repeat(tuple_stmt, globals=namespace,
+                                   number=NUMBER, repeat=3))
+    vector_time = min(timeit.repeat(vector_stmt, globals=namespace,
+                                    number=NUMBER, repeat=3))
+    print('%-24s tuple %8.1f ns   vectorcall %8.1f ns   %5.2fx' %
+          (name, tuple_time / NUMBER * 1e9, vector_time / NUMBER * 1e9,
+           tuple_time / vector_time))
+
+
+def main():
+    if sys.version_info < (3, 8):
+        print('vectorcall requires python 3.8 or newer')
+        return
+    lst = ArrayList()
+    lst.add(1)
+    size = lst.__dict__['size']
+    get = lst.__dict__['get']
+    valueOf = Integer.__dict__['valueOf']
+    namespace = {
+        'lst': lst,
+        'Integer': Integer,
+        'ArrayList': ArrayList,
+        'size': size,
+        'get': get,
+        'valueOf': valueOf,
+        'size_call': size.__call__,
+        'get_call': get.__call__,
+        'valueOf_call': valueOf.__call__,
+        'ArrayList_call': ArrayList.__call__,
+    }
+    report('PyJMethod', 'size_call(lst)', 'size(lst)', namespace)
+    report('PyJMethod one arg', 'get_call(lst, 0)', 'get(lst, 0)', namespace)
+    report('PyJMultiMethod', 'valueOf_call(Integer, 7)', 'valueOf(Integer, 7)',
+           namespace)
+    report('PyJClass', 'ArrayList_call()', 'ArrayList()', namespace)
+
+
+if __name__ == '__main__':
+    main()
@@ -131,6 +131,61 @@ class TestArray(unittest.TestCase):
         for array_item, i in enumerate(ar):
             self.assertEqual(array_item, i)
 
+    def test_list_to_primitive_array(self):
+        from java.nio import (ByteBuffer, DoubleBuffer, FloatBuffer,
+                              IntBuffer, LongBuffer, ShortBuffer)
+        floats = [0.5 * i for i in range(100)]
+        self.assertSequenceEqual(DoubleBuffer.wrap(floats).array(), floats)
+        self.assertSequenceEqual(FloatBuffer.wrap(tuple(floats)).array(),
+                                 floats)
+        self.assertSequenceEqual(DoubleBuffer.wrap([1, 2.5]).array(),
+                                 [1.0, 2.5])
+        ints = list(range(-100, 100))
+        self.assertSequenceEqual(LongBuffer.wrap(ints).array(), ints)
+        self.assertSequenceEqual(IntBuffer.wrap(ints).array(), ints)
+        self.assertSequenceEqual(ShortBuffer.wrap(ints).array(), ints)
+        self.assertSequenceEqual(ByteBuffer.wrap(ints).array(), ints)
+        self.assertEqual(len(IntBuffer.wrap([]).array()), 0)
+        # conversion errors of arguments are raised as TypeError
+        with self.assertRaises(TypeError):
+            ByteBuffer.wrap([1, 128])
+        with self.assertRaises(TypeError):
+            IntBuffer.wrap([2 ** 31])
+        with self.assertRaises(TypeError):
+            IntBuffer.wrap([1, 2.5])
+        with self.assertRaises(TypeError):
+            DoubleBuffer.wrap([1.0, 'a'])
+
+    def test_list_to_primitive_array_overloads(self):
+        from java.nio import DoubleBuffer, LongBuffer
+        from java.util import Arrays
+        # the widest array type of the first item is chosen
+        ints = [1, 2, 3]
+        self.assertEqual(Arrays.hashCode(ints),
+                         Arrays.hashCode(LongBuffer.wrap(ints).array()))
+        floats = [0.5, 1.5]
+        self.assertEqual(Arrays.hashCode(floats),
+                         Arrays.hashCode(DoubleBuffer.wrap(floats).array()))
+        with self.assertRaises(TypeError):
+            Arrays.hashCode(['a'])
+
+    def test_list_to_primitive_array_overloads_cached(self):
+        from java.nio import DoubleBuffer, LongBuffer
+        from java.util import Arrays
+        hashCode = Arrays.__dict__['hashCode']
+        ints = Arrays.hashCode(LongBuffer.wrap([1, 2]).array())
+        doubles = Arrays.hashCode(DoubleBuffer.wrap([0.5]).array())
+        # the cache must not reuse the choice for another first item
+        misses = hashCode.__cache_misses__
+        for i in range(2):
+            self.assertEqual(Arrays.hashCode([1, 2]), ints)
+            self.assertEqual(Arrays.hashCode([0.5]), doubles)
+            try:
+                Arrays.hashCode([])
+            except TypeError:
+                pass
+        self.assertEqual(hashCode.__cache_misses__, misses + 3)
+
     def test_jarray_one_arg_throws_exception(self):
         with self.assertRaises(Exception):
             jep.jarray(1)
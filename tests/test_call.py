@@ -109,6 +109,31 @@ class TestTypes(unittest.TestCase):
             .getAsLong()
         self.assertTrue(result == sum(range(2, 1000, 2)))
 
+    def test_repeated_object_args(self):
+        from java.util import Collections, HashMap, LinkedList
+        a = ArrayList()
+        a.add(1)
+        for i in range(3):
+            self.assertEqual(1, Collections.unmodifiableList(a).get(0))
+        # a different class must still be checked after the first call
+        self.assertEqual(0, Collections.unmodifiableList(LinkedList()).size())
+        with self.assertRaises(TypeError):
+            Collections.unmodifiableList(HashMap())
+        self.assertEqual(1, Collections.unmodifiableList(a).get(0))
+
+    def test_boxed_object_returns(self):
+        a = ArrayList()
+        a.add(1)
+        a.add(2.5)
+        a.add(True)
+        a.add('c')
+        for i in range(2):
+            self.assertEqual(1, a.get(0))
+            self.assertIsInstance(a.get(0), int)
+            self.assertEqual(2.5, a.get(1))
+            self.assertIs(True, a.get(2))
+            self.assertEqual('c', a.get(3))
+
     def test_observer(self):
         from java.util.concurrent import Executors
         a = list()
@@ -142,3 +142,98 @@ class TestLists(unittest.TestCase):
         jlist = ArrayList()
         jlist.add("string")
         self.assertEqual(next(iter(jlist)), "string")
+
+    def test_convert_number_list(self):
+        from java.util import Collections
+        ints = list(range(-200, 200))
+        jlist = Collections.unmodifiableList(ints)
+        self.assertSequenceEqual(jlist, ints)
+        floats = [0.5 * i for i in range(50)]
+        self.assertSequenceEqual(Collections.unmodifiableList(floats), floats)
+        mixed = [1, 2.5, True, 'a']
+        self.assertSequenceEqual(Collections.unmodifiableList(mixed), mixed)
+        with self.assertRaises(TypeError):
+            Collections.unmodifiableList([1, 2 ** 80])
+
+    def test_convert_nested(self):
+        from java.util import Collections
+        from java.lang import Object
+        o = Object()
+        rows = [{'id': i, 'name': 'row %d' % i, 'score': i * 0.5,
+                 'tags': ('a', u'\u00e9', u'\u4e2d'), 'ok': i % 2 == 0,
+                 'none': None, 'obj': o, 'nested': [[i], {}]}
+                for i in range(100)]
+        jlist = Collections.unmodifiableList(rows)
+        self.assertEqual(len(jlist), 100)
+        row = jlist[7]
+        self.assertEqual(row.getClass().getName(), 'java.util.HashMap')
+        self.assertEqual(row['id'], 7)
+        self.assertEqual(row['name'], 'row 7')
+        self.assertEqual(row['score'], 3.5)
+        self.assertSequenceEqual(row['tags'], ('a', u'\u00e9', u'\u4e2d'))
+        self.assertFalse(row['ok'])
+        self.assertIsNone(row['none'])
+        self.assertTrue(o.equals(row['obj']))
+        self.assertEqual(row['nested'][0][0], 7)
+        self.assertEqual(row['nested'].getClass().getName(),
+                         'java.util.ArrayList')
+        with self.assertRaises(Exception):
+            row['tags'].add('b')
+        with self.assertRaises(TypeError):
+            Collections.unmodifiableList([{'big': 2 ** 80}])
+
+    def test_to_python(self):
+        from java.util import HashMap, HashSet
+        from java.lang import Object
+        jlist = makeJavaList()
+        jlist.add(None)
+        jlist.add(True)
+        jlist.add(2.5)
+        jlist.add('str')
+        pylist = jep.toPython(jlist)
+        self.assertIs(type(pylist), list)
+        self.assertEqual(pylist, makePythonList() + [None, True, 2.5, 'str'])
+        self.assertIs(pylist[COUNT + 1], True)
+
+        jset = HashSet()
+        jset.add(1)
+        jset.add('a')
+        self.assertEqual(jep.toPython(jset), {1, 'a'})
+
+        o = Object()
+        jmap = HashMap()
+        jmap.put('a', 1)
+        jmap.put(2, o)
+        jmap.put('list', makeJavaList())
+        pydict = jep.toPython(jmap)
+        self.assertIs(type(pydict), dict)
+        self.assertEqual(pydict['a'], 1)
+        self.assertTrue(o.equals(pydict[2]))
+        self.assertEqual(pydict['list'].getClass().getName(),
+                         'java.util.ArrayList')
+        self.assertEqual(jep.toPython(jmap, deep=True)['list'],
+                         makePythonList())
+
+        with self.assertRaises(TypeError):
+            jep.toPython(o)
+        with self.assertRaises(TypeError):
+            jep.toPython([1, 2])
+
+    def test_to_python_strings(self):
+        from java.util import HashMap
+        strings = ['', 'a', 'caf\u00e9', '\u20ac', '\ufeffbom', '\U0001f600']
+        jlist = ArrayList()
+        for s in strings:
+            jlist.add(s)
+        self.assertEqual(jep.toPython(jlist), strings)
+        jmap = HashMap()
+        for i, s in enumerate(strings):
+            jmap.put(s, i)
+        self.assertEqual(jep.toPython(jmap),
+                         dict((s, i) for i, s in enumerate(strings)))
+
+    def test_view_parameter(self):
+        # a view parameter gets a view even when views are not enabled
+        from jep.test import TestCollectionViews
+        self.assertEqual(TestCollectionViews.sizeOf([1, 2, 3]), 3)
+        self.assertEqual(TestCollectionViews.sizeOf((1, 2)), 2)
@@ -1,5 +1,8 @@
 import unittest
+import sys
 from java.lang import Object
+from jep_pipe import jep_pipe
+from jep_pipe import build_java_process_cmd
 
 
 class TestObject(unittest.TestCase):
@@ -20,3 +23,227 @@ class TestObject(unittest.TestCase):
     def test_java_name(self):
         self.assertEquals(Object.java_name, "java.lang.Object")
         self.assertEquals(Object().java_name, "java.lang.Object")
+
+    def test_class_info_shared(self):
+        from java.util import ArrayList, HashMap
+        a = ArrayList()
+        b = ArrayList()
+        self.assertIs(a.java_name, b.java_name)
+        self.assertIs(a.__dict__, b.__dict__)
+        self.assertEquals(type(a).__name__, 'PyJList')
+        self.assertEquals(type(HashMap()).__name__, 'PyJMap')
+        self.assertEquals(type(Object()).__name__, 'PyJObject')
+
+    def test_inherited_members_shared(self):
+        from java.util import ArrayList, HashMap
+        a = ArrayList().__dict__
+        m = HashMap().__dict__
+        o = Object().__dict__
+        self.assertIs(a['getClass'], m['getClass'])
+        self.assertIs(a['getClass'], o['getClass'])
+        # overridden methods are different methods
+        self.assertIsNot(a['hashCode'], o['hashCode'])
+        self.assertIsNot(a['hashCode'], m['hashCode'])
+
+    def test_static_final_constants(self):
+        from java.lang import Integer, String
+        from java.util.concurrent import TimeUnit
+        self.assertEquals(Integer.MAX_VALUE, 2147483647)
+        self.assertIs(Integer.MAX_VALUE, Integer.MAX_VALUE)
+        self.assertIs(TimeUnit.SECONDS, TimeUnit.SECONDS)
+        self.assertEquals(TimeUnit.SECONDS.name(), 'SECONDS')
+        self.assertEquals(String.CASE_INSENSITIVE_ORDER.compare('a', 'A'), 0)
+
+    def test_converters(self):
+        import jep
+        from datetime import datetime, timedelta, tzinfo
+        from decimal import Decimal
+        from uuid import UUID as PyUUID
+        from java.lang import String
+        from java.math import BigDecimal
+        from java.sql import Timestamp
+        from java.util import ArrayList, UUID
+        from java.util.function import Function
+
+        def uuid_to_java(u):
+            msb, lsb = u.int >> 64, u.int & (2 ** 64 - 1)
+            return UUID(msb - (msb >> 63 << 64), lsb - (lsb >> 63 << 64))
+
+        class Point(object):
+            def __str__(self):
+                return 'Point(1, 2)'
+
+        class UTC(tzinfo):
+            def utcoffset(self, dt):
+                return timedelta(0)
+
+        d = Decimal('12345678901234567890.123456789')
+        dt = datetime(2020, 1, 2, 3, 4, 5, 600000)
+        u = PyUUID('12345678-9abc-def0-8123-456789abcdef')
+        try:
+            jep.addConverter(Decimal, BigDecimal)
+            jep.addConverter(datetime, Timestamp)
+            jep.addConverter(PyUUID, UUID, toJava=uuid_to_java,
+                             toPython=lambda j: PyUUID(j.toString()))
+            jep.addConverter(Point, String, toJava=Function.identity())
+            lst = ArrayList()
+            lst.add(d)
+            lst.add(dt)
+            lst.add(u)
+            lst.add(Point())
+            self.assertEqual(lst.toString(), '[' + str(d) +
+                             ', 2020-01-02 03:04:05.6, ' + str(u) +
+                             ', Point(1, 2)]')
+            self.assertEqual(lst.get(0), d)
+            self.assertIs(type(lst.get(0)), Decimal)
+            self.assertEqual(lst.get(1), dt)
+            self.assertEqual(lst.get(2), u)
+            self.assertEqual(lst.get(3), 'Point(1, 2)')
+            with self.assertRaises(TypeError):
+                lst.add(dt.replace(tzinfo=UTC()))
+            self.assertTrue(jep.removeConverter(Decimal, BigDecimal))
+            self.assertFalse(jep.removeConverter(Decimal, BigDecimal))
+            self.assertEqual(lst.get(0).getClass().getName(),
+                             'java.math.BigDecimal')
+        finally:
+            jep.removeConverter(Decimal, BigDecimal)
+            jep.removeConverter(datetime, Timestamp)
+            jep.removeConverter(PyUUID, UUID)
+            jep.removeConverter(Point, String)
+        with self.assertRaises(TypeError):
+            jep.addConverter(Decimal, String)
+        with self.assertRaises(TypeError):
+            jep.addConverter(Decimal, BigDecimal, toJava=1)
+
+    def test_converter_type_cache(self):
+        import gc
+        import jep
+        import weakref
+        from java.lang import String
+        from java.util import ArrayList
+
+        class Point(object):
+            pass
+
+        lst = ArrayList()
+
+        def add_dynamic():
+            cls = type('Dynamic', (object,), {})
+            lst.add(cls())
+            return weakref.ref(cls)
+
+        jep.addConverter(Point, String, toJava=str)
+        try:
+            ref = add_dynamic()
+            for i in range(300):
+                add_dynamic()
+            gc.collect()
+            # the cache of types without a converter does not keep them alive
+            self.assertIsNone(ref())
+        finally:
+            jep.removeConverter(Point, String)
+
+    def test_release_refs(self):
+        import jep
+        jep.flushRefs()
+        released = jep.refStats()['released']
+        objects = [Object() for i in range(100)]
+        del objects
+        self.assertGreaterEqual(jep.refStats()['pending'], 100)
+        jep.flushRefs()
+        stats = jep.refStats()
+        self.assertEquals(stats['pending'], 0)
+        self.assertGreaterEqual(stats['released'], released + 100)
+
+    def test_outstanding_refs(self):
+        import jep
+        # resolve anything the class caches before counting
+        Object()
+        jep.flushRefs()
+        outstanding = jep.refStats()['outstanding']
+        objects = [Object() for i in range(100)]
+        # each object holds a reference to itself and to its class
+        self.assertGreaterEqual(jep.refStats()['outstanding'],
+                                outstanding + 200)
+        del objects
+        # refs waiting in the queue are still alive until they are flushed
+        self.assertGreaterEqual(jep.refStats()['outstanding'],
+                                outstanding + 200)
+        jep.flushRefs()
+        self.assertEquals(jep.refStats()['outstanding'], outstanding)
+
+    def test_python_thread_detached(self):
+        import threading
+        from java.lang import Thread
+        threads = []
+        errors = []
+
+        def run():
+            try:
+                threads.append(Thread.currentThread())
+            except Exception as e:
+                errors.append(e)
+
+        t = threading.Thread(target=run)
+        t.start()
+        t.join()
+        self.assertEquals(errors, [])
+        self.assertEquals(len(threads), 1)
+        self.assertIsNot(threads[0], None)
+        # the java thread ends once python detaches it when it exits
+        threads[0].join(10000)
+        self.assertFalse(threads[0].isAlive())
+
+    def test_identity_cache_disabled(self):
+        import jep
+        from java.util import ArrayList
+        o = Object()
+        l = ArrayList()
+        l.add(o)
+        self.assertIsNot(l.get(0), l.get(0))
+        self.assertEqual(l.get(0), o)
+        self.assertEqual(jep.identityCacheStats()['size'], 0)
+
+    @unittest.skipIf(sys.version_info.major < 3, "the cache is only used with Python 3")
+    def test_string_intern_cache_disabled(self):
+        import jep
+        from java.lang import String
+        from java.util import ArrayList
+        l = ArrayList()
+        l.add(String('key'))
+        l.add(String('key'))
+        self.assertEqual(l.get(0), l.get(1))
+        self.assertEqual(jep.internCacheStats()['size'], 0)
+
+    @unittest.skipIf(sys.platform.startswith("win"), "subprocess complications on Windows")
+    def test_lazy_members(self):
+        jep_pipe(build_java_process_cmd('jep.test.TestLazyMembers'))
+
+    @unittest.skipIf(sys.platform.startswith("win"), "subprocess complications on Windows")
+    def test_shared_metadata(self):
+        jep_pipe(build_java_process_cmd('jep.test.TestSharedMetadata'))
+
+    @unittest.skipIf(sys.platform.startswith("win"), "subprocess complications on Windows")
+    def test_metadata_cache_file(self):
+        jep_pipe(build_java_process_cmd('jep.test.TestMetadataCacheFile'))
+
+    @unittest.skipIf(sys.platform.startswith("win"), "subprocess complications on Windows")
+    def test_identity_cache(self):
+        jep_pipe(build_java_process_cmd('jep.test.TestIdentityCache'))
+
+    @unittest.skipIf(sys.platform.startswith("win"), "subprocess complications on Windows")
+    @unittest.skipIf(sys.version_info.major < 3, "the cache is only used with Python 3")
+    def test_string_intern_cache(self):
+        jep_pipe(build_java_process_cmd('jep.test.TestStringInternCache'))
+
+    @unittest.skipIf(sys.platform.startswith("win"), "subprocess complications on Windows")
+    def test_class_types(self):
+        jep_pipe(build_java_process_cmd('jep.test.TestClassTypes'))
+
+    @unittest.skipIf(sys.platform.startswith("win"), "subprocess complications on Windows")
+    def test_gil_policy(self):
+        jep_pipe(build_java_process_cmd('jep.test.TestGILPolicy'))
+
+    @unittest.skipIf(sys.platform.startswith("win"), "subprocess complications on Windows")
+    def test_collection_views(self):
+        jep_pipe(build_java_process_cmd('jep.test.TestCollectionViews'))
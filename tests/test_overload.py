@@ -79,6 +79,49 @@ class TestTypes(unittest.TestCase):
         # This probably doesn't matter but it is currently deterministic
         self.assertEqual(TestOverload.Object_or_Class(None), 'Object')
 
+    def test_cache(self):
+        from java.util import HashMap
+        any_primitive = TestOverload.__dict__['any_primitive']
+        hits = any_primitive.__cache_hits__
+        misses = any_primitive.__cache_misses__
+        for i in range(3):
+            self.assertEqual(TestOverload.any_primitive(0.0), 'double')
+            self.assertEqual(TestOverload.any_primitive(True), 'boolean')
+        self.assertEqual(any_primitive.__cache_misses__, misses + 2)
+        self.assertEqual(any_primitive.__cache_hits__, hits + 4)
+        # The java class of an argument is part of the key, not just its python type
+        for i in range(3):
+            self.assertEqual(TestOverload.Object_or_ArrayList(ArrayList()), 'ArrayList')
+            self.assertEqual(TestOverload.Object_or_ArrayList(HashMap()), 'Object')
+            self.assertEqual(TestOverload.int_or_Object(1), 'int')
+            self.assertEqual(TestOverload.int_or_Object(None), 'Object')
+
+    def test_cache_converters(self):
+        from java.lang import Integer, String
+
+        class Point(object):
+            pass
+
+        method = TestOverload.__dict__['Integer_or_String']
+        registered = []
+        try:
+            jep.addConverter(Point, Integer, toJava=lambda p: 1)
+            registered.append(Integer)
+            for i in range(2):
+                self.assertEqual(TestOverload.Integer_or_String(Point()),
+                                 'Integer')
+            misses = method.__cache_misses__
+            # the overload is chosen again when the converters change
+            self.assertTrue(jep.removeConverter(Point, Integer))
+            registered.remove(Integer)
+            jep.addConverter(Point, String, toJava=lambda p: 'point')
+            registered.append(String)
+            self.assertEqual(TestOverload.Integer_or_String(Point()), 'String')
+            self.assertEqual(method.__cache_misses__, misses + 1)
+        finally:
+            for jtype in registered:
+                jep.removeConverter(Point, jtype)
+
     def things_that_might_need_fixing(self):
         # 64 bit python 2 stores this in an int but it is too big for a java int
         # The method matching doesn't actually check the size of the int so it
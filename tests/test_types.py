@@ -652,6 +652,18 @@ class TestTypes(unittest.TestCase):
             self.fields.verify()
             self.staticFields.verify()
 
+    @unittest.skipIf(sys.version_info.major < 3, 'Python 3 string layout')
+    def test_string_kinds(self):
+        from java.lang import String
+        # short and long strings of every width, long strings are not copied
+        # onto the stack so both paths are covered
+        for base in ('ascii', '\u00e9t\u00e9', '\u263A\u00e9', '\U0001F604a',
+                     '\ufeffbom', 'null\0char'):
+            for s in (base, base * 100):
+                self.assertEqual(s, self.methods.objectString(s))
+                self.assertEqual(len(s.encode('utf-16-le', 'surrogatepass')) // 2,
+                                 String(s).length())
+
     def test_string_coercion(self):
         for s in (False, True, 0, 1, 0.1, [], {}):
             with self.assertRaises(TypeError):